@@ -0,0 +1,366 @@
+#include "ast_binary_format.hpp"
+#include "semantic_types.hpp"
+#include "duckdb/common/exception.hpp"
+#include "duckdb/common/helper.hpp"
+#include <unordered_map>
+
+namespace duckdb {
+
+static constexpr idx_t HEADER_SIZE = 28;
+static constexpr idx_t COLUMN_COUNT = static_cast<idx_t>(ASTBinaryColumn::COLUMN_COUNT);
+
+// Native parameter flag bits
+static constexpr uint8_t PARAM_OPTIONAL = 0x01;
+static constexpr uint8_t PARAM_VARIADIC = 0x02;
+
+idx_t ASTBinaryFormat::ColumnWidth(ASTBinaryColumn column) {
+    switch (column) {
+    case ASTBinaryColumn::PARENT_ID:
+        return sizeof(int64_t);
+    case ASTBinaryColumn::SEMANTIC_TYPE:
+    case ASTBinaryColumn::UNIVERSAL_FLAGS:
+    case ASTBinaryColumn::ARITY_BIN:
+        return sizeof(uint8_t);
+    default:
+        return sizeof(uint32_t);
+    }
+}
+
+//==============================================================================
+// Writer
+//==============================================================================
+
+namespace {
+
+struct StringDictionary {
+    StringDictionary() {
+        // Id 0 is reserved for the empty string so missing values need no flag
+        Add(string());
+    }
+
+    uint32_t Add(const string &value) {
+        auto entry = ids.find(value);
+        if (entry != ids.end()) {
+            return entry->second;
+        }
+        auto id = NumericCast<uint32_t>(strings.size());
+        ids.emplace(value, id);
+        strings.push_back(&ids.find(value)->first);
+        return id;
+    }
+
+    std::unordered_map<string, uint32_t> ids;
+    vector<const string *> strings;
+};
+
+template <class T>
+void Append(string &buffer, T value) {
+    data_t bytes[sizeof(T)];
+    Store<T>(value, bytes);
+    buffer.append(const_char_ptr_cast(bytes), sizeof(T));
+}
+
+bool HasNativeContext(const NativeContext &native) {
+    return !native.signature_type.empty() || !native.parameters.empty() || !native.modifiers.empty() ||
+           !native.qualified_name.empty() || !native.annotations.empty();
+}
+
+} // namespace
+
+string ASTBinaryFormat::Serialize(const ASTResult &result) {
+    const auto &nodes = result.Nodes();
+    const auto node_count = NumericCast<uint32_t>(nodes.size());
+    StringDictionary dictionary;
+
+    auto file_path_id = dictionary.Add(result.source.file_path);
+    auto language_id = dictionary.Add(result.source.language);
+
+    // Columns
+    string columns[COLUMN_COUNT];
+    for (idx_t c = 0; c < COLUMN_COUNT; c++) {
+        columns[c].reserve(node_count * ColumnWidth(static_cast<ASTBinaryColumn>(c)));
+    }
+    auto column = [&](ASTBinaryColumn c) -> string & {
+        return columns[static_cast<idx_t>(c)];
+    };
+    for (const auto &node : nodes) {
+        Append<uint32_t>(column(ASTBinaryColumn::TYPE), dictionary.Add(node.type.raw));
+        Append<uint32_t>(column(ASTBinaryColumn::NAME), dictionary.Add(node.context.name));
+        Append<uint32_t>(column(ASTBinaryColumn::PEEK), dictionary.Add(node.peek));
+        Append<uint32_t>(column(ASTBinaryColumn::START_LINE), node.source.start_line);
+        Append<uint32_t>(column(ASTBinaryColumn::START_COLUMN), node.source.start_column);
+        Append<uint32_t>(column(ASTBinaryColumn::END_LINE), node.source.end_line);
+        Append<uint32_t>(column(ASTBinaryColumn::END_COLUMN), node.source.end_column);
+        Append<int64_t>(column(ASTBinaryColumn::PARENT_ID), node.structure.parent_id);
+        Append<uint32_t>(column(ASTBinaryColumn::DEPTH), node.structure.depth);
+        Append<uint32_t>(column(ASTBinaryColumn::SIBLING_INDEX), node.structure.sibling_index);
+        Append<uint32_t>(column(ASTBinaryColumn::CHILDREN_COUNT), node.structure.children_count);
+        Append<uint32_t>(column(ASTBinaryColumn::DESCENDANT_COUNT), node.structure.descendant_count);
+        Append<uint8_t>(column(ASTBinaryColumn::SEMANTIC_TYPE), node.context.normalized.semantic_type);
+        Append<uint8_t>(column(ASTBinaryColumn::UNIVERSAL_FLAGS), node.context.normalized.universal_flags);
+        Append<uint8_t>(column(ASTBinaryColumn::ARITY_BIN), node.context.normalized.arity_bin);
+        Append<uint32_t>(column(ASTBinaryColumn::START_BYTE), node.source.start_byte);
+        Append<uint32_t>(column(ASTBinaryColumn::END_BYTE), node.source.end_byte);
+    }
+
+    // Native context section (sparse - most nodes have none)
+    vector<uint32_t> native_nodes;
+    vector<uint32_t> native_offsets;
+    string native_data;
+    for (uint32_t i = 0; i < node_count; i++) {
+        const auto &native = nodes[i].context.native;
+        if (!HasNativeContext(native)) {
+            continue;
+        }
+        native_nodes.push_back(i);
+        native_offsets.push_back(NumericCast<uint32_t>(native_data.size()));
+        Append<uint32_t>(native_data, dictionary.Add(native.signature_type));
+        Append<uint32_t>(native_data, dictionary.Add(native.qualified_name));
+        Append<uint32_t>(native_data, dictionary.Add(native.annotations));
+        Append<uint32_t>(native_data, NumericCast<uint32_t>(native.parameters.size()));
+        for (const auto &param : native.parameters) {
+            Append<uint32_t>(native_data, dictionary.Add(param.name));
+            Append<uint32_t>(native_data, dictionary.Add(param.type));
+            Append<uint32_t>(native_data, dictionary.Add(param.default_value));
+            Append<uint32_t>(native_data, dictionary.Add(param.annotations));
+            uint8_t flags = (param.is_optional ? PARAM_OPTIONAL : 0) | (param.is_variadic ? PARAM_VARIADIC : 0);
+            Append<uint8_t>(native_data, flags);
+        }
+        Append<uint32_t>(native_data, NumericCast<uint32_t>(native.modifiers.size()));
+        for (const auto &modifier : native.modifiers) {
+            Append<uint32_t>(native_data, dictionary.Add(modifier));
+        }
+    }
+
+    // The walker hashes every node or none, so the root tells whether hashes were computed
+    const bool has_hashes = !nodes.empty() && nodes[0].structure.subtree_hash != 0;
+
+    // Assemble
+    string buffer;
+    Append<uint32_t>(buffer, MAGIC);
+    Append<uint16_t>(buffer, VERSION);
+    uint16_t flags = has_hashes ? FLAG_HASHES : 0;
+    if (result.status == "truncated") {
+        flags |= FLAG_TRUNCATED;
+    }
+    Append<uint16_t>(buffer, flags);
+    Append<uint32_t>(buffer, node_count);
+    Append<uint32_t>(buffer, NumericCast<uint32_t>(dictionary.strings.size()));
+    Append<uint32_t>(buffer, result.max_depth);
+    Append<uint32_t>(buffer, file_path_id);
+    Append<uint32_t>(buffer, language_id);
+    D_ASSERT(buffer.size() == HEADER_SIZE);
+
+    for (idx_t c = 0; c < COLUMN_COUNT; c++) {
+        buffer += columns[c];
+    }
+
+    uint32_t string_offset = 0;
+    for (auto str : dictionary.strings) {
+        Append<uint32_t>(buffer, string_offset);
+        string_offset += NumericCast<uint32_t>(str->size());
+    }
+    Append<uint32_t>(buffer, string_offset);
+    for (auto str : dictionary.strings) {
+        buffer += *str;
+    }
+
+    if (has_hashes) {
+        for (const auto &node : nodes) {
+            Append<uint64_t>(buffer, node.structure.subtree_hash);
+        }
+        for (const auto &node : nodes) {
+            Append<uint64_t>(buffer, node.structure.shape_hash);
+        }
+    }
+
+    Append<uint32_t>(buffer, NumericCast<uint32_t>(native_nodes.size()));
+    for (auto node_index : native_nodes) {
+        Append<uint32_t>(buffer, node_index);
+    }
+    for (auto offset : native_offsets) {
+        Append<uint32_t>(buffer, offset);
+    }
+    buffer += native_data;
+    return buffer;
+}
+
+ASTResult ASTBinaryFormat::Deserialize(const_data_ptr_t data, idx_t size) {
+    ASTBinaryReader reader(data, size);
+    return reader.ToASTResult();
+}
+
+//==============================================================================
+// Reader
+//==============================================================================
+
+static void CheckBounds(bool condition, const char *what) {
+    if (!condition) {
+        throw InvalidInputException("Invalid AST binary: %s", what);
+    }
+}
+
+ASTBinaryReader::ASTBinaryReader(const_data_ptr_t data_p, idx_t size_p) : data(data_p), size(size_p) {
+    CheckBounds(size >= HEADER_SIZE, "truncated header");
+    CheckBounds(Load<uint32_t>(data) == ASTBinaryFormat::MAGIC, "bad magic");
+    auto version = Load<uint16_t>(data + 4);
+    if (version != ASTBinaryFormat::VERSION) {
+        throw InvalidInputException("Unsupported AST binary version %d (expected %d)", version,
+                                    ASTBinaryFormat::VERSION);
+    }
+    auto flags = Load<uint16_t>(data + 6);
+    node_count = Load<uint32_t>(data + 8);
+    string_count = Load<uint32_t>(data + 12);
+    max_depth = Load<uint32_t>(data + 16);
+    file_path_id = Load<uint32_t>(data + 20);
+    language_id = Load<uint32_t>(data + 24);
+    truncated = flags & ASTBinaryFormat::FLAG_TRUNCATED;
+
+    idx_t offset = HEADER_SIZE;
+    for (idx_t c = 0; c < COLUMN_COUNT; c++) {
+        column_data[c] = data + offset;
+        offset += node_count * ASTBinaryFormat::ColumnWidth(static_cast<ASTBinaryColumn>(c));
+    }
+    CheckBounds(offset <= size, "truncated columns");
+
+    string_offsets = data + offset;
+    offset += (idx_t(string_count) + 1) * sizeof(uint32_t);
+    CheckBounds(string_count > 0 && offset <= size, "truncated dictionary");
+    string_data = data + offset;
+    offset += Load<uint32_t>(string_offsets + string_count * sizeof(uint32_t));
+    CheckBounds(offset + sizeof(uint32_t) <= size, "truncated dictionary");
+
+    if (flags & ASTBinaryFormat::FLAG_HASHES) {
+        subtree_hashes = data + offset;
+        offset += node_count * sizeof(uint64_t);
+        shape_hashes = data + offset;
+        offset += node_count * sizeof(uint64_t);
+        CheckBounds(offset + sizeof(uint32_t) <= size, "truncated hashes");
+    }
+
+    native_count = Load<uint32_t>(data + offset);
+    offset += sizeof(uint32_t);
+    native_nodes = data + offset;
+    offset += idx_t(native_count) * sizeof(uint32_t);
+    native_offsets = data + offset;
+    offset += idx_t(native_count) * sizeof(uint32_t);
+    native_data = data + offset;
+    CheckBounds(offset <= size, "truncated native section");
+    CheckBounds(file_path_id < string_count && language_id < string_count, "bad source string id");
+}
+
+idx_t ASTBinaryReader::SubtreeEnd(idx_t node) const {
+    auto end = node + DescendantCount(node);
+    CheckBounds(end < node_count, "descendant range out of bounds");
+    return end;
+}
+
+string_t ASTBinaryReader::GetStringRef(uint32_t id) const {
+    CheckBounds(id < string_count, "string id out of range");
+    auto start = Load<uint32_t>(string_offsets + id * sizeof(uint32_t));
+    auto end = Load<uint32_t>(string_offsets + (id + 1) * sizeof(uint32_t));
+    CheckBounds(start <= end && string_data + end <= data + size, "string out of range");
+    return string_t(const_char_ptr_cast(string_data + start), end - start);
+}
+
+string ASTBinaryReader::FilePath() const {
+    return GetString(file_path_id);
+}
+
+string ASTBinaryReader::Language() const {
+    return GetString(language_id);
+}
+
+NativeContext ASTBinaryReader::GetNativeContext(idx_t node) const {
+    NativeContext native;
+    // Binary search the ascending node index array
+    idx_t lo = 0;
+    idx_t hi = native_count;
+    while (lo < hi) {
+        idx_t mid = lo + (hi - lo) / 2;
+        if (Load<uint32_t>(native_nodes + mid * sizeof(uint32_t)) < node) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    if (lo == native_count || Load<uint32_t>(native_nodes + lo * sizeof(uint32_t)) != node) {
+        return native;
+    }
+
+    auto ptr = native_data + Load<uint32_t>(native_offsets + lo * sizeof(uint32_t));
+    auto next_u32 = [&]() {
+        CheckBounds(ptr + sizeof(uint32_t) <= data + size, "truncated native entry");
+        auto value = Load<uint32_t>(ptr);
+        ptr += sizeof(uint32_t);
+        return value;
+    };
+    native.signature_type = GetString(next_u32());
+    native.qualified_name = GetString(next_u32());
+    native.annotations = GetString(next_u32());
+    auto param_count = next_u32();
+    for (uint32_t p = 0; p < param_count; p++) {
+        ParameterInfo param;
+        param.name = GetString(next_u32());
+        param.type = GetString(next_u32());
+        param.default_value = GetString(next_u32());
+        param.annotations = GetString(next_u32());
+        CheckBounds(ptr < data + size, "truncated native entry");
+        auto flags = Load<uint8_t>(ptr);
+        ptr += sizeof(uint8_t);
+        param.is_optional = flags & PARAM_OPTIONAL;
+        param.is_variadic = flags & PARAM_VARIADIC;
+        native.parameters.push_back(std::move(param));
+    }
+    auto modifier_count = next_u32();
+    for (uint32_t m = 0; m < modifier_count; m++) {
+        native.modifiers.push_back(GetString(next_u32()));
+    }
+    return native;
+}
+
+ASTNode ASTBinaryReader::GetNode(idx_t i) const {
+    ASTNode node;
+    node.node_id = i;
+    node.type.raw = GetString(TypeId(i));
+    node.context.name = GetString(NameId(i));
+    node.peek = GetString(PeekId(i));
+    node.source.start_line = StartLine(i);
+    node.source.start_column = StartColumn(i);
+    node.source.end_line = EndLine(i);
+    node.source.end_column = EndColumn(i);
+    node.source.start_byte = StartByte(i);
+    node.source.end_byte = EndByte(i);
+    node.structure.parent_id = ParentId(i);
+    node.structure.depth = Depth(i);
+    node.structure.sibling_index = SiblingIndex(i);
+    node.structure.children_count = ChildrenCount(i);
+    node.structure.descendant_count = NumericCast<uint32_t>(SubtreeEnd(i) - i);
+    node.structure.subtree_hash = SubtreeHash(i);
+    node.structure.shape_hash = ShapeHash(i);
+    node.context.normalized.semantic_type = SemanticType(i);
+    node.context.normalized.universal_flags = UniversalFlags(i);
+    node.context.normalized.arity_bin = ArityBin(i);
+    node.context.native = GetNativeContext(i);
+    node.type.normalized = SemanticTypes::GetSemanticTypeName(node.context.normalized.semantic_type);
+    node.UpdateComputedLegacyFields();
+    return node;
+}
+
+ASTResult ASTBinaryReader::ToASTResult() const {
+    ASTResult result;
+    result.source.file_path = FilePath();
+    result.source.language = Language();
+    result.nodes.reserve(node_count);
+    for (idx_t i = 0; i < node_count; i++) {
+        result.nodes.push_back(GetNode(i));
+    }
+    result.node_count = NumericCast<uint32_t>(node_count);
+    result.max_depth = max_depth;
+    if (truncated) {
+        result.status = "truncated";
+    }
+    return result;
+}
+
+} // namespace duckdb
@@ -0,0 +1,375 @@
+#include "ast_blob_functions.hpp"
+#include "ast_binary_format.hpp"
+#include "ast_parsing_task.hpp"
+#include "ast_type.hpp"
+#include "semantic_types.hpp"
+#include "unified_ast_backend.hpp"
+#include "duckdb/common/exception.hpp"
+#include "duckdb/common/vector_operations/binary_executor.hpp"
+#include "duckdb/common/vector_operations/unary_executor.hpp"
+#include "duckdb/function/scalar_function.hpp"
+#include "duckdb/function/table_function.hpp"
+#include "duckdb/main/extension_util.hpp"
+
+namespace duckdb {
+
+//==============================================================================
+// AST BLOB functions
+//==============================================================================
+//
+// An AST value is one parsed file in ASTBinaryFormat. The accessors below read
+// the encoded columns directly: children and descendants are found through the
+// DFS layout (subtree of node i = [i, i + descendant_count(i)]), so nothing is
+// decoded or unnested beyond the nodes that are returned.
+
+// Fields of the node STRUCT returned by the list accessors
+enum ASTNodeField : idx_t {
+    NODE_ID = 0,
+    TYPE,
+    NAME,
+    SEMANTIC_TYPE,
+    START_LINE,
+    START_COLUMN,
+    END_LINE,
+    END_COLUMN,
+    PARENT_ID,
+    DEPTH,
+    DESCENDANT_COUNT,
+    PEEK
+};
+
+static LogicalType GetASTNodeStructType() {
+    child_list_t<LogicalType> fields;
+    fields.push_back(make_pair("node_id", LogicalType::BIGINT));
+    fields.push_back(make_pair("type", LogicalType::VARCHAR));
+    fields.push_back(make_pair("name", LogicalType::VARCHAR));
+    fields.push_back(make_pair("semantic_type", LogicalType::UTINYINT));
+    fields.push_back(make_pair("start_line", LogicalType::UINTEGER));
+    fields.push_back(make_pair("start_column", LogicalType::UINTEGER));
+    fields.push_back(make_pair("end_line", LogicalType::UINTEGER));
+    fields.push_back(make_pair("end_column", LogicalType::UINTEGER));
+    fields.push_back(make_pair("parent_id", LogicalType::BIGINT));
+    fields.push_back(make_pair("depth", LogicalType::UINTEGER));
+    fields.push_back(make_pair("descendant_count", LogicalType::UINTEGER));
+    fields.push_back(make_pair("peek", LogicalType::VARCHAR));
+    return LogicalType::STRUCT(std::move(fields));
+}
+
+static ASTBinaryReader GetReader(const string_t &blob) {
+    return ASTBinaryReader(const_data_ptr_cast(blob.GetData()), blob.GetSize());
+}
+
+// Dictionary string into a VARCHAR field; id 0 (empty string) becomes NULL
+static void WriteDictionaryString(Vector &field, idx_t target, const ASTBinaryReader &reader, uint32_t id) {
+    if (id == 0) {
+        FlatVector::SetNull(field, target, true);
+        return;
+    }
+    FlatVector::GetData<string_t>(field)[target] = StringVector::AddString(field, reader.GetStringRef(id));
+}
+
+// Append the given nodes as the list of result row `row`
+static void AppendNodeList(Vector &result, idx_t row, const ASTBinaryReader &reader, const vector<idx_t> &nodes) {
+    auto offset = ListVector::GetListSize(result);
+    ListVector::Reserve(result, offset + nodes.size());
+
+    auto &fields = StructVector::GetEntries(ListVector::GetEntry(result));
+    auto node_ids = FlatVector::GetData<int64_t>(*fields[NODE_ID]);
+    auto semantic_types = FlatVector::GetData<uint8_t>(*fields[SEMANTIC_TYPE]);
+    auto start_lines = FlatVector::GetData<uint32_t>(*fields[START_LINE]);
+    auto start_columns = FlatVector::GetData<uint32_t>(*fields[START_COLUMN]);
+    auto end_lines = FlatVector::GetData<uint32_t>(*fields[END_LINE]);
+    auto end_columns = FlatVector::GetData<uint32_t>(*fields[END_COLUMN]);
+    auto parent_ids = FlatVector::GetData<int64_t>(*fields[PARENT_ID]);
+    auto depths = FlatVector::GetData<uint32_t>(*fields[DEPTH]);
+    auto descendant_counts = FlatVector::GetData<uint32_t>(*fields[DESCENDANT_COUNT]);
+
+    for (idx_t i = 0; i < nodes.size(); i++) {
+        const auto node = nodes[i];
+        const auto target = offset + i;
+        node_ids[target] = NumericCast<int64_t>(node);
+        WriteDictionaryString(*fields[TYPE], target, reader, reader.TypeId(node));
+        WriteDictionaryString(*fields[NAME], target, reader, reader.NameId(node));
+        semantic_types[target] = reader.SemanticType(node);
+        start_lines[target] = reader.StartLine(node);
+        start_columns[target] = reader.StartColumn(node);
+        end_lines[target] = reader.EndLine(node);
+        end_columns[target] = reader.EndColumn(node);
+        auto parent_id = reader.ParentId(node);
+        if (parent_id < 0) {
+            FlatVector::SetNull(*fields[PARENT_ID], target, true);
+        } else {
+            parent_ids[target] = parent_id;
+        }
+        depths[target] = reader.Depth(node);
+        descendant_counts[target] = reader.DescendantCount(node);
+        WriteDictionaryString(*fields[PEEK], target, reader, reader.PeekId(node));
+    }
+
+    auto list_entries = FlatVector::GetData<list_entry_t>(result);
+    list_entries[row].offset = offset;
+    list_entries[row].length = nodes.size();
+    ListVector::SetListSize(result, offset + nodes.size());
+}
+
+// Shared driver of the list accessors. `collect(reader, row, nodes)` fills the
+// node indexes of one row and returns false when the row is NULL.
+template <class COLLECT>
+static void ExecuteNodeList(DataChunk &args, Vector &result, COLLECT &&collect) {
+    const auto count = args.size();
+    UnifiedVectorFormat ast_format;
+    args.data[0].ToUnifiedFormat(count, ast_format);
+    auto asts = UnifiedVectorFormat::GetData<string_t>(ast_format);
+
+    result.SetVectorType(VectorType::FLAT_VECTOR);
+    auto &result_validity = FlatVector::Validity(result);
+    vector<idx_t> nodes;
+    for (idx_t row = 0; row < count; row++) {
+        auto ast_idx = ast_format.sel->get_index(row);
+        if (!ast_format.validity.RowIsValid(ast_idx)) {
+            result_validity.SetInvalid(row);
+            continue;
+        }
+        auto reader = GetReader(asts[ast_idx]);
+        nodes.clear();
+        if (!collect(reader, row, nodes)) {
+            result_validity.SetInvalid(row);
+            continue;
+        }
+        AppendNodeList(result, row, reader, nodes);
+    }
+    if (args.AllConstant()) {
+        result.SetVectorType(VectorType::CONSTANT_VECTOR);
+    }
+}
+
+// Resolve the node_id argument of a row; false for NULL or out of range ids
+static bool GetNodeArgument(const UnifiedVectorFormat &format, idx_t row, const ASTBinaryReader &reader,
+                            idx_t &node) {
+    auto idx = format.sel->get_index(row);
+    if (!format.validity.RowIsValid(idx)) {
+        return false;
+    }
+    auto node_id = UnifiedVectorFormat::GetData<int64_t>(format)[idx];
+    if (node_id < 0 || NumericCast<idx_t>(node_id) >= reader.NodeCount()) {
+        return false;
+    }
+    node = NumericCast<idx_t>(node_id);
+    return true;
+}
+
+//------------------------------------------------------------------------------
+// Scalar functions
+//------------------------------------------------------------------------------
+
+// parse_ast_blob(code, language) -> AST
+static void ParseASTBlobFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+    BinaryExecutor::Execute<string_t, string_t, string_t>(
+        args.data[0], args.data[1], result, args.size(), [&](string_t code, string_t language) {
+            ASTResult parsed;
+            try {
+                parsed = UnifiedASTBackend::ParseToASTResult(code.GetString(), language.GetString(), "<inline>");
+            } catch (const Exception &e) {
+                throw IOException("Failed to parse code: " + string(e.what()));
+            }
+            return StringVector::AddStringOrBlob(result, ASTBinaryFormat::Serialize(parsed));
+        });
+}
+
+// ast_node_count(ast) -> BIGINT
+static void ASTNodeCountFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+    UnaryExecutor::Execute<string_t, int64_t>(args.data[0], result, args.size(), [&](string_t ast) {
+        return NumericCast<int64_t>(GetReader(ast).NodeCount());
+    });
+}
+
+// ast_children(ast, node_id) -> LIST(node): walk the sibling chain inside the subtree
+static void ASTChildrenFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+    UnifiedVectorFormat node_format;
+    args.data[1].ToUnifiedFormat(args.size(), node_format);
+    ExecuteNodeList(args, result, [&](const ASTBinaryReader &reader, idx_t row, vector<idx_t> &nodes) {
+        idx_t node;
+        if (!GetNodeArgument(node_format, row, reader, node)) {
+            return false;
+        }
+        const auto end = reader.SubtreeEnd(node);
+        for (auto child = node + 1; child <= end; child = reader.SubtreeEnd(child) + 1) {
+            nodes.push_back(child);
+        }
+        return true;
+    });
+}
+
+// ast_descendants(ast, node_id) -> LIST(node): the contiguous range after the node
+static void ASTDescendantsFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+    UnifiedVectorFormat node_format;
+    args.data[1].ToUnifiedFormat(args.size(), node_format);
+    ExecuteNodeList(args, result, [&](const ASTBinaryReader &reader, idx_t row, vector<idx_t> &nodes) {
+        idx_t node;
+        if (!GetNodeArgument(node_format, row, reader, node)) {
+            return false;
+        }
+        const auto end = reader.SubtreeEnd(node);
+        nodes.reserve(end - node);
+        for (auto descendant = node + 1; descendant <= end; descendant++) {
+            nodes.push_back(descendant);
+        }
+        return true;
+    });
+}
+
+// ast_find_type(ast, type) -> LIST(node): resolve the type once in the dictionary,
+// then compare integer ids over the type column
+static void ASTFindTypeFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+    UnifiedVectorFormat type_format;
+    args.data[1].ToUnifiedFormat(args.size(), type_format);
+    auto types = UnifiedVectorFormat::GetData<string_t>(type_format);
+    ExecuteNodeList(args, result, [&](const ASTBinaryReader &reader, idx_t row, vector<idx_t> &nodes) {
+        auto type_idx = type_format.sel->get_index(row);
+        if (!type_format.validity.RowIsValid(type_idx)) {
+            return false;
+        }
+        const auto &type = types[type_idx];
+        for (uint32_t id = 1; id < reader.StringCount(); id++) {
+            if (!(reader.GetStringRef(id) == type)) {
+                continue;
+            }
+            for (idx_t node = 0; node < reader.NodeCount(); node++) {
+                if (reader.TypeId(node) == id) {
+                    nodes.push_back(node);
+                }
+            }
+            break;
+        }
+        return true;
+    });
+}
+
+// ast_functions(ast) -> LIST(node): function definitions by semantic type. Leaves are
+// skipped: keyword tokens such as `def` carry the same semantic type
+static void ASTFunctionsFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+    ExecuteNodeList(args, result, [&](const ASTBinaryReader &reader, idx_t row, vector<idx_t> &nodes) {
+        for (idx_t node = 0; node < reader.NodeCount(); node++) {
+            if (SemanticTypes::GetBaseType(reader.SemanticType(node)) == SemanticTypes::DEFINITION_FUNCTION &&
+                reader.ChildrenCount(node) > 0) {
+                nodes.push_back(node);
+            }
+        }
+        return true;
+    });
+}
+
+// ast_subtree(ast, node_id) -> AST: the node's subtree as a standalone AST, re-numbered from 0
+static void ASTSubtreeFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+    BinaryExecutor::ExecuteWithNulls<string_t, int64_t, string_t>(
+        args.data[0], args.data[1], result, args.size(),
+        [&](string_t ast, int64_t node_id, ValidityMask &mask, idx_t idx) {
+            auto reader = GetReader(ast);
+            if (node_id < 0 || NumericCast<idx_t>(node_id) >= reader.NodeCount()) {
+                mask.SetInvalid(idx);
+                return string_t();
+            }
+            const auto root = NumericCast<idx_t>(node_id);
+            const auto end = reader.SubtreeEnd(root);
+            const auto root_depth = reader.Depth(root);
+
+            ASTResult subtree;
+            subtree.source.file_path = reader.FilePath();
+            subtree.source.language = reader.Language();
+            subtree.nodes.reserve(end - root + 1);
+            for (auto i = root; i <= end; i++) {
+                auto node = reader.GetNode(i);
+                node.node_id = i - root;
+                node.structure.parent_id = i == root ? -1 : node.structure.parent_id - node_id;
+                node.structure.depth -= root_depth;
+                if (i == root) {
+                    node.structure.sibling_index = 0;
+                }
+                subtree.max_depth = MaxValue<uint32_t>(subtree.max_depth, node.structure.depth);
+                subtree.nodes.push_back(std::move(node));
+            }
+            subtree.node_count = NumericCast<uint32_t>(subtree.nodes.size());
+            return StringVector::AddStringOrBlob(result, ASTBinaryFormat::Serialize(subtree));
+        });
+}
+
+//------------------------------------------------------------------------------
+// read_ast_blob(file_patterns, [language], ...) -> one AST per file
+//------------------------------------------------------------------------------
+
+struct ReadASTBlobGlobalState : public GlobalTableFunctionState {
+    ASTFileParseState files;
+};
+
+static unique_ptr<FunctionData> ReadASTBlobBind(ClientContext &context, TableFunctionBindInput &input,
+                                                vector<LogicalType> &return_types, vector<string> &names) {
+    auto result = make_uniq<ASTFileBindData>();
+    result->Bind(context, input, "read_ast_blob");
+
+    names = {"file_path", "language", "node_count", "ast"};
+    return_types = {LogicalType::VARCHAR, LogicalType::VARCHAR, LogicalType::BIGINT, GetASTLogicalType()};
+    return std::move(result);
+}
+
+static unique_ptr<GlobalTableFunctionState> ReadASTBlobInit(ClientContext &context, TableFunctionInitInput &input) {
+    auto result = make_uniq<ReadASTBlobGlobalState>();
+    result->files.Initialize(input.bind_data->Cast<ASTFileBindData>());
+    return std::move(result);
+}
+
+static void ReadASTBlobFunction(ClientContext &context, TableFunctionInput &data_p, DataChunk &output) {
+    auto &bind_data = data_p.bind_data->Cast<ASTFileBindData>();
+    auto &state = data_p.global_state->Cast<ReadASTBlobGlobalState>();
+
+    idx_t count = 0;
+    ASTResult *parsed;
+    while (count < STANDARD_VECTOR_SIZE && (parsed = state.files.Next(context, bind_data)) != nullptr) {
+        output.SetValue(0, count, Value(parsed->source.file_path));
+        output.SetValue(1, count, Value(parsed->source.language));
+        output.SetValue(2, count, Value::BIGINT(NumericCast<int64_t>(parsed->Nodes().size())));
+        FlatVector::GetData<string_t>(output.data[3])[count] =
+            StringVector::AddStringOrBlob(output.data[3], ASTBinaryFormat::Serialize(*parsed));
+        // The encoded copy is all that is needed from here on
+        *parsed = ASTResult();
+        count++;
+    }
+    output.SetCardinality(count);
+}
+
+static TableFunction GetReadASTBlobFunction(const vector<LogicalType> &arguments) {
+    TableFunction read_ast_blob("read_ast_blob", arguments, ReadASTBlobFunction, ReadASTBlobBind, ReadASTBlobInit);
+    read_ast_blob.named_parameters["ignore_errors"] = LogicalType::BOOLEAN;
+    read_ast_blob.named_parameters["peek_size"] = LogicalType::INTEGER;
+    read_ast_blob.named_parameters["peek_mode"] = LogicalType::VARCHAR;
+    read_ast_blob.named_parameters["skip_generated"] = LogicalType::BOOLEAN;
+    read_ast_blob.named_parameters["max_file_size"] = LogicalType::BIGINT;
+    read_ast_blob.named_parameters["max_nodes"] = LogicalType::BIGINT;
+    return read_ast_blob;
+}
+
+void RegisterASTBlobFunctions(DatabaseInstance &instance) {
+    auto ast_type = GetASTLogicalType();
+    auto node_list_type = LogicalType::LIST(GetASTNodeStructType());
+
+    ExtensionUtil::RegisterFunction(instance, ScalarFunction("parse_ast_blob", {LogicalType::VARCHAR, LogicalType::VARCHAR},
+                                                             ast_type, ParseASTBlobFunction));
+    ExtensionUtil::RegisterFunction(instance, ScalarFunction("ast_node_count", {ast_type}, LogicalType::BIGINT,
+                                                             ASTNodeCountFunction));
+    ExtensionUtil::RegisterFunction(instance, ScalarFunction("ast_children", {ast_type, LogicalType::BIGINT},
+                                                             node_list_type, ASTChildrenFunction));
+    ExtensionUtil::RegisterFunction(instance, ScalarFunction("ast_descendants", {ast_type, LogicalType::BIGINT},
+                                                             node_list_type, ASTDescendantsFunction));
+    ExtensionUtil::RegisterFunction(instance, ScalarFunction("ast_find_type", {ast_type, LogicalType::VARCHAR},
+                                                             node_list_type, ASTFindTypeFunction));
+    ExtensionUtil::RegisterFunction(instance, ScalarFunction("ast_functions", {ast_type}, node_list_type,
+                                                             ASTFunctionsFunction));
+    ExtensionUtil::RegisterFunction(instance, ScalarFunction("ast_subtree", {ast_type, LogicalType::BIGINT},
+                                                             ast_type, ASTSubtreeFunction));
+
+    TableFunctionSet read_ast_blob("read_ast_blob");
+    read_ast_blob.AddFunction(GetReadASTBlobFunction({LogicalType::ANY}));
+    read_ast_blob.AddFunction(GetReadASTBlobFunction({LogicalType::ANY, LogicalType::VARCHAR}));
+    ExtensionUtil::RegisterFunction(instance, read_ast_blob);
+}
+
+} // namespace duckdb
@@ -0,0 +1,170 @@
+#include "duckdb.hpp"
+#include "duckdb/catalog/default/default_table_functions.hpp"
+#include "duckdb/function/table_function.hpp"
+#include "duckdb/main/extension_util.hpp"
+#include "duckdb/parser/parsed_data/create_macro_info.hpp"
+#include "ast_clone_functions.hpp"
+#include "ast_parsing_task.hpp"
+#include "unified_ast_backend.hpp"
+
+namespace duckdb {
+
+//==============================================================================
+// ast_subtree_hashes(file_patterns, [language], min_descendants := 0)
+//==============================================================================
+//
+// One row per subtree with at least min_descendants descendants, carrying the
+// Merkle hashes the walker computes in its post-order visit (see
+// ComputeSubtreeHashes). The parent's hashes are included so clone grouping
+// can drop groups that are only part of a larger clone.
+
+struct ASTSubtreeHashesBindData : public ASTFileBindData {
+    uint32_t min_descendants = 0;
+};
+
+struct ASTSubtreeHashesGlobalState : public GlobalTableFunctionState {
+    ASTFileParseState files;
+    ASTResult *current = nullptr;
+    idx_t node_offset = 0;
+};
+
+static unique_ptr<FunctionData> ASTSubtreeHashesBind(ClientContext &context, TableFunctionBindInput &input,
+                                                     vector<LogicalType> &return_types, vector<string> &names) {
+    auto result = make_uniq<ASTSubtreeHashesBindData>();
+    result->Bind(context, input, "ast_subtree_hashes");
+    auto entry = input.named_parameters.find("min_descendants");
+    if (entry != input.named_parameters.end() && !entry->second.IsNull()) {
+        auto min_descendants = entry->second.GetValue<int64_t>();
+        if (min_descendants < 0) {
+            throw BinderException("ast_subtree_hashes: min_descendants must be >= 0");
+        }
+        result->min_descendants = NumericCast<uint32_t>(MinValue<int64_t>(min_descendants, NumericLimits<uint32_t>::Maximum()));
+    }
+    // Only structure and hashes are needed
+    result->peek_mode = "none";
+    result->hashes = true;
+
+    names = {"file_path",        "language",     "node_id",      "parent_id",         "type",
+             "start_line",       "end_line",     "descendant_count", "subtree_hash", "shape_hash",
+             "parent_subtree_hash", "parent_shape_hash"};
+    return_types = {LogicalType::VARCHAR,  LogicalType::VARCHAR,  LogicalType::BIGINT,  LogicalType::BIGINT,
+                    LogicalType::VARCHAR,  LogicalType::UINTEGER, LogicalType::UINTEGER, LogicalType::UINTEGER,
+                    LogicalType::UBIGINT,  LogicalType::UBIGINT,  LogicalType::UBIGINT,  LogicalType::UBIGINT};
+    return std::move(result);
+}
+
+static unique_ptr<GlobalTableFunctionState> ASTSubtreeHashesInit(ClientContext &context,
+                                                                 TableFunctionInitInput &input) {
+    auto result = make_uniq<ASTSubtreeHashesGlobalState>();
+    result->files.Initialize(input.bind_data->Cast<ASTFileBindData>());
+    return std::move(result);
+}
+
+static void ASTSubtreeHashesFunction(ClientContext &context, TableFunctionInput &data_p, DataChunk &output) {
+    auto &bind_data = data_p.bind_data->Cast<ASTSubtreeHashesBindData>();
+    auto &state = data_p.global_state->Cast<ASTSubtreeHashesGlobalState>();
+
+    auto node_id_data = FlatVector::GetData<int64_t>(output.data[2]);
+    auto parent_id_data = FlatVector::GetData<int64_t>(output.data[3]);
+    auto start_line_data = FlatVector::GetData<uint32_t>(output.data[5]);
+    auto end_line_data = FlatVector::GetData<uint32_t>(output.data[6]);
+    auto descendant_data = FlatVector::GetData<uint32_t>(output.data[7]);
+    auto subtree_hash_data = FlatVector::GetData<uint64_t>(output.data[8]);
+    auto shape_hash_data = FlatVector::GetData<uint64_t>(output.data[9]);
+    auto parent_subtree_data = FlatVector::GetData<uint64_t>(output.data[10]);
+    auto parent_shape_data = FlatVector::GetData<uint64_t>(output.data[11]);
+
+    idx_t count = 0;
+    while (count < STANDARD_VECTOR_SIZE) {
+        if (!state.current || state.node_offset >= state.current->Nodes().size()) {
+            state.current = state.files.Next(context, bind_data);
+            state.node_offset = 0;
+            if (!state.current) {
+                break;
+            }
+            continue;
+        }
+        const auto &nodes = state.current->Nodes();
+        auto &node = nodes[state.node_offset++];
+        if (node.structure.descendant_count < bind_data.min_descendants) {
+            continue;
+        }
+        output.SetValue(0, count, Value(state.current->source.file_path));
+        output.SetValue(1, count, Value(state.current->source.language));
+        node_id_data[count] = NumericCast<int64_t>(node.node_id);
+        output.SetValue(4, count, Value(node.type.raw));
+        start_line_data[count] = node.source.start_line;
+        end_line_data[count] = node.source.end_line;
+        descendant_data[count] = node.structure.descendant_count;
+        subtree_hash_data[count] = node.structure.subtree_hash;
+        shape_hash_data[count] = node.structure.shape_hash;
+        if (node.structure.parent_id >= 0) {
+            auto &parent = nodes[node.structure.parent_id];
+            parent_id_data[count] = node.structure.parent_id;
+            parent_subtree_data[count] = parent.structure.subtree_hash;
+            parent_shape_data[count] = parent.structure.shape_hash;
+        } else {
+            FlatVector::SetNull(output.data[3], count, true);
+            FlatVector::SetNull(output.data[10], count, true);
+            FlatVector::SetNull(output.data[11], count, true);
+        }
+        count++;
+    }
+    output.SetCardinality(count);
+}
+
+static TableFunction GetASTSubtreeHashesFunction(const vector<LogicalType> &arguments) {
+    TableFunction ast_subtree_hashes("ast_subtree_hashes", arguments, ASTSubtreeHashesFunction,
+                                     ASTSubtreeHashesBind, ASTSubtreeHashesInit);
+    ast_subtree_hashes.named_parameters["ignore_errors"] = LogicalType::BOOLEAN;
+    ast_subtree_hashes.named_parameters["min_descendants"] = LogicalType::BIGINT;
+    return ast_subtree_hashes;
+}
+
+//==============================================================================
+// ast_clones(file_patterns, min_descendants := 10, renamed := true)
+//==============================================================================
+//
+// Groups identical subtrees across all files with DuckDB's parallel hash
+// aggregate over ast_subtree_hashes. With renamed (the default) subtrees that
+// differ only in identifiers and literals are grouped too. A group is dropped
+// when all of its instances sit in distinct parents that are themselves clones
+// of each other - it is then reported as part of the larger clone.
+
+static const DefaultTableMacro AST_CLONE_MACROS[] = {
+    {DEFAULT_SCHEMA,
+     "ast_clones",
+     {"file_patterns", nullptr},
+     {{"min_descendants", "10"}, {"renamed", "true"}, {nullptr, nullptr}},
+     R"(
+SELECT
+    language,
+    CASE WHEN renamed THEN shape_hash ELSE subtree_hash END AS clone_hash,
+    count(*) AS clone_count,
+    count(DISTINCT subtree_hash) = 1 AS exact,
+    any_value(type) AS type,
+    max(descendant_count) AS descendant_count,
+    list({'file_path': file_path, 'node_id': node_id, 'start_line': start_line, 'end_line': end_line,
+          'subtree_hash': subtree_hash} ORDER BY file_path, node_id) AS instances
+FROM ast_subtree_hashes(file_patterns, min_descendants := min_descendants, ignore_errors := true)
+GROUP BY language, clone_hash
+HAVING count(*) > 1
+   AND NOT (count(DISTINCT (file_path, parent_id)) = count(*)
+            AND count(DISTINCT CASE WHEN renamed THEN parent_shape_hash ELSE parent_subtree_hash END) = 1
+            AND count(parent_id) = count(*))
+)"},
+    {nullptr, nullptr, {nullptr}, {{nullptr, nullptr}}, nullptr}};
+
+void RegisterASTCloneFunctions(DatabaseInstance &instance) {
+    TableFunctionSet ast_subtree_hashes("ast_subtree_hashes");
+    ast_subtree_hashes.AddFunction(GetASTSubtreeHashesFunction({LogicalType::ANY}));
+    ast_subtree_hashes.AddFunction(GetASTSubtreeHashesFunction({LogicalType::ANY, LogicalType::VARCHAR}));
+    ExtensionUtil::RegisterFunction(instance, ast_subtree_hashes);
+
+    for (idx_t i = 0; AST_CLONE_MACROS[i].name != nullptr; i++) {
+        auto info = DefaultTableFunctionGenerator::CreateTableMacroInfo(AST_CLONE_MACROS[i]);
+        ExtensionUtil::RegisterFunction(instance, *info);
+    }
+}
+
+} // namespace duckdb
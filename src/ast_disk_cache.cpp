@@ -0,0 +1,117 @@
+#include "ast_disk_cache.hpp"
+#include "ast_binary_format.hpp"
+#include "duckdb/common/exception.hpp"
+#include "duckdb/common/file_system.hpp"
+#include "duckdb/common/helper.hpp"
+#include "duckdb/common/types/hash.hpp"
+#include "duckdb/common/types/uuid.hpp"
+
+namespace duckdb {
+
+// magic, version, reserved, file_size, last_modified, content_hash, identity length
+static constexpr idx_t CACHE_HEADER_SIZE = 4 + 2 + 2 + 8 + 8 + 8 + 4;
+
+string ASTDiskCache::GetCacheFilePath(FileSystem &fs, const string &cache_dir, const string &identity) {
+    char name[17];
+    snprintf(name, sizeof(name), "%016llx", static_cast<unsigned long long>(Hash(identity.c_str(), identity.size())));
+    return fs.JoinPath(cache_dir, string(name) + ".ast");
+}
+
+bool ASTDiskCache::TryLoad(FileSystem &fs, const string &cache_dir, const string &identity, idx_t file_size,
+                           int64_t last_modified, const std::function<const string &()> &load_content,
+                           ASTResult &result) {
+    auto cache_path = GetCacheFilePath(fs, cache_dir, identity);
+    try {
+        auto handle = fs.OpenFile(cache_path, FileFlags::FILE_FLAGS_READ | FileFlags::FILE_FLAGS_NULL_IF_NOT_EXISTS);
+        if (!handle) {
+            return false;
+        }
+        auto cache_size = NumericCast<idx_t>(fs.GetFileSize(*handle));
+        if (cache_size < CACHE_HEADER_SIZE) {
+            return false;
+        }
+        auto buffer = make_unsafe_uniq_array<data_t>(cache_size);
+        fs.Read(*handle, buffer.get(), NumericCast<int64_t>(cache_size));
+        const_data_ptr_t ptr = buffer.get();
+
+        if (Load<uint32_t>(ptr) != MAGIC || Load<uint16_t>(ptr + 4) != VERSION) {
+            return false;
+        }
+        auto cached_size = Load<uint64_t>(ptr + 8);
+        auto cached_mtime = Load<int64_t>(ptr + 16);
+        auto cached_hash = Load<uint64_t>(ptr + 24);
+        auto identity_length = Load<uint32_t>(ptr + 32);
+        if (CACHE_HEADER_SIZE + identity_length > cache_size) {
+            return false;
+        }
+        // Guard against file name hash collisions
+        if (string(const_char_ptr_cast(ptr + CACHE_HEADER_SIZE), identity_length) != identity) {
+            return false;
+        }
+        if (cached_size != file_size) {
+            return false;
+        }
+
+        auto payload = ptr + CACHE_HEADER_SIZE + identity_length;
+        auto payload_size = cache_size - CACHE_HEADER_SIZE - identity_length;
+        if (cached_mtime != last_modified) {
+            // Touched but possibly unchanged (checkout, rebuild): compare content
+            const auto &content = load_content();
+            auto content_hash = Hash(content.c_str(), content.size());
+            if (content_hash != cached_hash) {
+                return false;
+            }
+            StoreEncoded(fs, cache_dir, identity, file_size, last_modified, content_hash,
+                         string(const_char_ptr_cast(payload), payload_size));
+        }
+        result = ASTBinaryFormat::Deserialize(payload, payload_size);
+        return true;
+    } catch (const Exception &) {
+        // Unreadable or stale-format cache files are treated as misses
+        return false;
+    }
+}
+
+bool ASTDiskCache::Save(FileSystem &fs, const string &cache_dir, const string &identity, idx_t file_size,
+                        int64_t last_modified, hash_t content_hash, const ASTResult &result) {
+    return StoreEncoded(fs, cache_dir, identity, file_size, last_modified, content_hash,
+                        ASTBinaryFormat::Serialize(result));
+}
+
+bool ASTDiskCache::StoreEncoded(FileSystem &fs, const string &cache_dir, const string &identity, idx_t file_size,
+                                int64_t last_modified, hash_t content_hash, const string &encoded) {
+    auto cache_path = GetCacheFilePath(fs, cache_dir, identity);
+    // Write to a unique temporary file and rename, so concurrent readers and
+    // writers (other threads or processes) never observe a partial file
+    auto temp_path = cache_path + "." + UUID::ToString(UUID::GenerateRandomUUID()) + ".tmp";
+    try {
+        string header;
+        header.resize(CACHE_HEADER_SIZE);
+        auto ptr = data_ptr_cast(&header[0]);
+        Store<uint32_t>(uint32_t(MAGIC), ptr);
+        Store<uint16_t>(uint16_t(VERSION), ptr + 4);
+        Store<uint16_t>(0, ptr + 6);
+        Store<uint64_t>(file_size, ptr + 8);
+        Store<int64_t>(last_modified, ptr + 16);
+        Store<uint64_t>(content_hash, ptr + 24);
+        Store<uint32_t>(NumericCast<uint32_t>(identity.size()), ptr + 32);
+        header += identity;
+
+        {
+            auto handle = fs.OpenFile(temp_path, FileFlags::FILE_FLAGS_WRITE | FileFlags::FILE_FLAGS_FILE_CREATE_NEW);
+            handle->Write((void *)header.data(), header.size());
+            handle->Write((void *)encoded.data(), encoded.size());
+            handle->Close();
+        }
+        fs.MoveFile(temp_path, cache_path);
+        return true;
+    } catch (const Exception &) {
+        try {
+            fs.RemoveFile(temp_path);
+        } catch (...) {
+        }
+        return false;
+    }
+}
+
+} // namespace duckdb
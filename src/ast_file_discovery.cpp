@@ -0,0 +1,538 @@
+#include "ast_file_discovery.hpp"
+#include "ast_file_utils.hpp"
+#include "duckdb/common/exception.hpp"
+#include "duckdb/common/file_system.hpp"
+#include "duckdb/common/string_util.hpp"
+#include "duckdb/parallel/task_executor.hpp"
+#include "duckdb/parallel/task_scheduler.hpp"
+#include <algorithm>
+
+namespace duckdb {
+
+//==============================================================================
+// Glob matching
+//==============================================================================
+
+static bool HasGlobCharacters(const string &segment) {
+    return segment.find_first_of("*?[") != string::npos;
+}
+
+// Character class starting at pattern[p] == '['; advances p past the closing ']'
+static bool MatchCharacterClass(const string &pattern, idx_t &p, char c) {
+    idx_t i = p + 1;
+    bool negate = i < pattern.size() && (pattern[i] == '!' || pattern[i] == '^');
+    if (negate) {
+        i++;
+    }
+    bool matched = false;
+    bool first = true;
+    for (; i < pattern.size() && (first || pattern[i] != ']'); i++, first = false) {
+        if (i + 2 < pattern.size() && pattern[i + 1] == '-' && pattern[i + 2] != ']') {
+            matched = matched || (pattern[i] <= c && c <= pattern[i + 2]);
+            i += 2;
+        } else {
+            matched = matched || pattern[i] == c;
+        }
+    }
+    if (i >= pattern.size()) {
+        // Unterminated class: '[' is a literal
+        p++;
+        return c == '[';
+    }
+    p = i + 1;
+    return matched != negate;
+}
+
+// Match one path segment against one glob segment (*, ? and [...] classes)
+static bool MatchName(const string &pattern, const string &name) {
+    idx_t p = 0, n = 0;
+    idx_t star = DConstants::INVALID_INDEX, star_n = 0;
+    while (n < name.size()) {
+        if (p < pattern.size() && pattern[p] == '*') {
+            star = p++;
+            star_n = n;
+            continue;
+        }
+        if (p < pattern.size() && pattern[p] != '*') {
+            idx_t next = p;
+            bool matched;
+            if (pattern[p] == '[') {
+                matched = MatchCharacterClass(pattern, next, name[n]);
+            } else {
+                matched = pattern[p] == '?' || pattern[p] == name[n];
+                next = p + 1;
+            }
+            if (matched) {
+                p = next;
+                n++;
+                continue;
+            }
+        }
+        if (star == DConstants::INVALID_INDEX) {
+            return false;
+        }
+        // Let the last '*' absorb one more character
+        p = star + 1;
+        n = ++star_n;
+    }
+    while (p < pattern.size() && pattern[p] == '*') {
+        p++;
+    }
+    return p == pattern.size();
+}
+
+// Whether the names below a walk's base match its segments. With `prefix`, whether a
+// directory with these names can still contain a match.
+static bool MatchSegments(const vector<string> &segments, idx_t s, const vector<string> &names, idx_t n,
+                          bool prefix) {
+    if (n == names.size()) {
+        if (prefix) {
+            return s < segments.size();
+        }
+        for (; s < segments.size(); s++) {
+            if (segments[s] != "**") {
+                return false;
+            }
+        }
+        return true;
+    }
+    if (s == segments.size()) {
+        return false;
+    }
+    if (segments[s] == "**") {
+        return MatchSegments(segments, s + 1, names, n, prefix) || MatchSegments(segments, s, names, n + 1, prefix);
+    }
+    return MatchName(segments[s], names[n]) && MatchSegments(segments, s + 1, names, n + 1, prefix);
+}
+
+static string JoinChild(const string &directory, const string &name) {
+    if (directory.empty()) {
+        return name;
+    }
+    if (directory.back() == '/') {
+        return directory + name;
+    }
+    return directory + "/" + name;
+}
+
+// Path segments, without empty and "." segments
+static vector<string> SplitPath(const string &path) {
+    vector<string> names;
+    for (auto &name : StringUtil::Split(path, '/')) {
+        if (!name.empty() && name != ".") {
+            names.push_back(std::move(name));
+        }
+    }
+    return names;
+}
+
+//==============================================================================
+// Exclusions and ignore files
+//==============================================================================
+
+struct ASTIgnoreRule {
+    vector<string> segments;
+    bool negate = false;
+    bool directory_only = false;
+    bool anchored = false; // Has a '/': matched against the path below the rules' directory
+};
+
+// The rules of one ignore file (or of the exclude list), chained to the ones
+// of the enclosing directories
+struct ASTIgnoreRules {
+    string directory;
+    vector<ASTIgnoreRule> rules;
+    shared_ptr<const ASTIgnoreRules> parent;
+};
+
+// One line of a .gitignore file; false for blank lines and comments
+static bool ParseIgnoreRule(string line, ASTIgnoreRule &rule) {
+    while (!line.empty() && (line.back() == '\r' || line.back() == ' ' || line.back() == '\t')) {
+        line.pop_back();
+    }
+    if (line.empty() || line[0] == '#') {
+        return false;
+    }
+    if (line[0] == '!') {
+        rule.negate = true;
+        line = line.substr(1);
+    } else if (line[0] == '\\') {
+        line = line.substr(1); // Escaped leading '#' or '!'
+    }
+    if (!line.empty() && line.back() == '/') {
+        rule.directory_only = true;
+        line.pop_back();
+    }
+    rule.anchored = line.find('/') != string::npos;
+    rule.segments = SplitPath(line);
+    return !rule.segments.empty();
+}
+
+static void ParseIgnoreRules(const string &content, vector<ASTIgnoreRule> &rules) {
+    for (auto &line : StringUtil::Split(content, '\n')) {
+        ASTIgnoreRule rule;
+        if (ParseIgnoreRule(line, rule)) {
+            rules.push_back(std::move(rule));
+        }
+    }
+}
+
+// gitignore precedence: the innermost rule set with a matching rule decides,
+// and within a set the last matching rule wins ('!' rules re-include)
+static bool IsIgnoredBy(const ASTIgnoreRules *rules, const string &path, const string &name, bool is_directory) {
+    for (; rules; rules = rules->parent.get()) {
+        vector<string> relative;
+        bool relative_ready = false;
+        for (auto rule = rules->rules.rbegin(); rule != rules->rules.rend(); ++rule) {
+            if (rule->directory_only && !is_directory) {
+                continue;
+            }
+            bool matched;
+            if (rule->anchored) {
+                if (!relative_ready) {
+                    auto &directory = rules->directory;
+                    relative = SplitPath(StringUtil::StartsWith(path, directory) ? path.substr(directory.size()) : path);
+                    relative_ready = true;
+                }
+                matched = MatchSegments(rule->segments, 0, relative, 0, false);
+            } else {
+                matched = MatchName(rule->segments[0], name);
+            }
+            if (matched) {
+                return !rule->negate;
+            }
+        }
+    }
+    return false;
+}
+
+//==============================================================================
+// ASTFileDiscovery
+//==============================================================================
+
+ASTFileDiscovery::ASTFileDiscovery(ClientContext &context_p, vector<string> supported_extensions_p,
+                                   bool ignore_errors_p, ASTDiscoveryOptions options_p)
+    : context(context_p), supported_extensions(std::move(supported_extensions_p)), ignore_errors(ignore_errors_p),
+      options(std::move(options_p)), file_count(0) {
+    if (!options.exclude.empty()) {
+        auto rules = make_shared_ptr<ASTIgnoreRules>();
+        for (auto &pattern : options.exclude) {
+            ASTIgnoreRule rule;
+            if (ParseIgnoreRule(pattern, rule)) {
+                rules->rules.push_back(std::move(rule));
+            }
+        }
+        exclude_rules = std::move(rules);
+    }
+}
+
+ASTFileDiscovery::~ASTFileDiscovery() {
+}
+
+bool ASTFileDiscovery::IsExcluded(const string &path, const string &name, bool is_directory,
+                                  const ASTIgnoreRules *ignore_rules) const {
+    if (exclude_rules && IsIgnoredBy(exclude_rules.get(), path, name, is_directory)) {
+        return true;
+    }
+    if (!options.respect_gitignore) {
+        return false;
+    }
+    return (is_directory && name == ".git") || IsIgnoredBy(ignore_rules, path, name, is_directory);
+}
+
+// .ignore is read after .gitignore, so its rules take precedence (as in ripgrep)
+shared_ptr<const ASTIgnoreRules> ASTFileDiscovery::LoadIgnoreRules(const string &directory, bool has_gitignore,
+                                                                   bool has_ignore,
+                                                                   shared_ptr<const ASTIgnoreRules> parent) {
+    auto rules = make_shared_ptr<ASTIgnoreRules>();
+    rules->directory = directory;
+    rules->parent = parent;
+    auto read_rules = [&](const string &file_name) {
+        try {
+            ParseIgnoreRules(ASTFileUtils::ReadFile(context, JoinChild(directory, file_name)), rules->rules);
+        } catch (const Exception &) {
+            // An unreadable ignore file ignores nothing
+        }
+    };
+    if (has_gitignore) {
+        read_rules(".gitignore");
+    }
+    if (has_ignore) {
+        read_rules(".ignore");
+    }
+    if (rules->rules.empty()) {
+        return parent;
+    }
+    return std::move(rules);
+}
+
+// Remote file systems and home-relative paths keep going through FileSystem::Glob
+static bool IsWalkablePath(const string &path) {
+    return path.find("://") == string::npos && !StringUtil::StartsWith(path, "~");
+}
+
+bool ASTFileDiscovery::NeedsWalk(ClientContext &context, const vector<string> &patterns) {
+    auto &fs = FileSystem::GetFileSystem(context);
+    for (auto &pattern : patterns) {
+        if (IsWalkablePath(pattern) && (fs.HasGlob(pattern) || fs.DirectoryExists(pattern))) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool ASTFileDiscovery::MatchPath(const string &pattern, const string &path) {
+    return MatchSegments(SplitPath(pattern), 0, SplitPath(path), 0, false);
+}
+
+void ASTFileDiscovery::AddPatterns(const vector<string> &patterns) {
+    for (auto &pattern : patterns) {
+        try {
+            AddPattern(pattern);
+        } catch (const Exception &e) {
+            if (!ignore_errors) {
+                throw IOException("Failed to process pattern '" + pattern + "': " + string(e.what()));
+            }
+        }
+    }
+}
+
+void ASTFileDiscovery::AddPattern(const string &pattern) {
+    auto &fs = FileSystem::GetFileSystem(context);
+    auto is_excluded_file = [&](const string &file_path) {
+        auto names = SplitPath(file_path);
+        return !names.empty() && IsExcluded(file_path, names.back(), false, nullptr);
+    };
+    if (!IsWalkablePath(pattern)) {
+        for (auto &file_path : ASTFileUtils::GetFiles(context, Value(pattern), ignore_errors, supported_extensions)) {
+            if (!is_excluded_file(file_path)) {
+                EmitFile(file_path);
+            }
+        }
+        return;
+    }
+    if (!fs.HasGlob(pattern)) {
+        if (fs.FileExists(pattern)) {
+            if (!is_excluded_file(pattern)) {
+                EmitFile(pattern);
+            }
+        } else if (fs.DirectoryExists(pattern)) {
+            // A directory reads its own files, not its subdirectories
+            AddWalk(pattern, {"*"});
+        } else if (!ignore_errors) {
+            throw IOException("File or directory does not exist: " + pattern);
+        }
+        return;
+    }
+    // The walk starts at the longest prefix without glob characters
+    auto segments = StringUtil::Split(pattern, '/');
+    idx_t first_glob = 0;
+    while (first_glob < segments.size() && !HasGlobCharacters(segments[first_glob])) {
+        first_glob++;
+    }
+    string base = StringUtil::StartsWith(pattern, "/") ? "/" : "";
+    for (idx_t i = 0; i < first_glob; i++) {
+        base = JoinChild(base, segments[i]);
+    }
+    if (!base.empty() && !fs.DirectoryExists(base)) {
+        return; // Like a glob without matches
+    }
+    AddWalk(base, vector<string>(segments.begin() + NumericCast<int64_t>(first_glob), segments.end()));
+}
+
+void ASTFileDiscovery::AddWalk(const string &base, vector<string> segments) {
+    string directory = base;
+    while (directory.size() > 1 && directory.back() == '/') {
+        directory.pop_back();
+    }
+    shared_ptr<const ASTIgnoreRules> ignore_rules;
+    if (options.respect_gitignore && !directory.empty() && directory[0] != '/') {
+        // Ignore files between the current directory and the walk's base apply as well
+        auto &fs = FileSystem::GetFileSystem(context);
+        auto names = SplitPath(directory);
+        string ancestor;
+        for (idx_t i = 0; i < names.size(); i++) {
+            auto has_gitignore = fs.FileExists(JoinChild(ancestor, ".gitignore"));
+            auto has_ignore = fs.FileExists(JoinChild(ancestor, ".ignore"));
+            if (has_gitignore || has_ignore) {
+                ignore_rules = LoadIgnoreRules(ancestor, has_gitignore, has_ignore, ignore_rules);
+            }
+            ancestor = JoinChild(ancestor, names[i]);
+        }
+    }
+    std::lock_guard<std::mutex> guard(lock);
+    walks.push_back(Walk {std::move(segments)});
+    pending_directories.push_back(PendingDirectory {directory, walks.size() - 1, {}, std::move(ignore_rules)});
+    work_added.notify_all();
+}
+
+uint64_t ASTFileShard::PathHash(const string &file_path) {
+    // FNV-1a, then the splitmix64 finalizer so that the low bits are well mixed
+    uint64_t hash = 14695981039346656037ULL;
+    for (auto c : file_path) {
+        hash ^= static_cast<uint8_t>(c);
+        hash *= 1099511628211ULL;
+    }
+    hash ^= hash >> 30;
+    hash *= 0xbf58476d1ce4e5b9ULL;
+    hash ^= hash >> 27;
+    hash *= 0x94d049bb133111ebULL;
+    hash ^= hash >> 31;
+    return hash;
+}
+
+void ASTFileDiscovery::EmitFile(const string &file_path) {
+    if (!supported_extensions.empty() && !ASTFileUtils::IsFileExtensionSupported(file_path, supported_extensions)) {
+        return;
+    }
+    std::lock_guard<std::mutex> guard(lock);
+    if (seen_files.insert(file_path).second) {
+        file_count++;
+        if (options.shard.Contains(file_path)) {
+            found_files.push_back(file_path);
+            work_added.notify_all();
+        }
+    }
+}
+
+vector<string> ASTFileDiscovery::AllFiles() {
+    std::lock_guard<std::mutex> guard(lock);
+    vector<string> files(seen_files.begin(), seen_files.end());
+    std::sort(files.begin(), files.end());
+    return files;
+}
+
+bool ASTFileDiscovery::WalkDirectory() {
+    PendingDirectory directory;
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        if (pending_directories.empty()) {
+            return false;
+        }
+        directory = std::move(pending_directories.front());
+        pending_directories.pop_front();
+        active_walkers++;
+    }
+
+    auto &fs = FileSystem::GetFileSystem(context);
+    auto &segments = walks[directory.walk_index].segments;
+    vector<PendingDirectory> subdirectories;
+    vector<string> files;
+    try {
+        vector<pair<string, bool>> entries;
+        bool has_gitignore = false, has_ignore = false;
+        fs.ListFiles(directory.path.empty() ? "." : directory.path, [&](const string &name, bool is_directory) {
+            has_gitignore = has_gitignore || (!is_directory && name == ".gitignore");
+            has_ignore = has_ignore || (!is_directory && name == ".ignore");
+            entries.emplace_back(name, is_directory);
+        });
+        // This directory's own ignore files apply to its entries, before anything is queued
+        auto ignore_rules = directory.ignore_rules;
+        if (options.respect_gitignore && (has_gitignore || has_ignore)) {
+            ignore_rules = LoadIgnoreRules(directory.path, has_gitignore, has_ignore, ignore_rules);
+        }
+
+        auto names = directory.relative;
+        names.emplace_back();
+        for (auto &entry : entries) {
+            auto &name = entry.first;
+            auto is_directory = entry.second;
+            auto path = JoinChild(directory.path, name);
+            if (IsExcluded(path, name, is_directory, ignore_rules.get())) {
+                continue;
+            }
+            names.back() = name;
+            if (is_directory) {
+                if (MatchSegments(segments, 0, names, 0, true)) {
+                    subdirectories.push_back(PendingDirectory {std::move(path), directory.walk_index, names,
+                                                               ignore_rules});
+                }
+            } else if (MatchSegments(segments, 0, names, 0, false)) {
+                files.push_back(std::move(path));
+            }
+        }
+    } catch (...) {
+        std::lock_guard<std::mutex> guard(lock);
+        active_walkers--;
+        work_added.notify_all();
+        if (!ignore_errors) {
+            throw;
+        }
+        return true; // Unreadable directories are skipped with ignore_errors
+    }
+
+    for (auto &file_path : files) {
+        EmitFile(file_path);
+    }
+    std::lock_guard<std::mutex> guard(lock);
+    for (auto &subdirectory : subdirectories) {
+        pending_directories.push_back(std::move(subdirectory));
+    }
+    active_walkers--;
+    work_added.notify_all();
+    return true;
+}
+
+bool ASTFileDiscovery::NextFile(string &file_path) {
+    std::lock_guard<std::mutex> guard(lock);
+    if (found_files.empty()) {
+        return false;
+    }
+    file_path = std::move(found_files.front());
+    found_files.pop_front();
+    return true;
+}
+
+bool ASTFileDiscovery::WalkFinished() {
+    std::lock_guard<std::mutex> guard(lock);
+    return pending_directories.empty() && active_walkers == 0;
+}
+
+void ASTFileDiscovery::WaitForWork(bool wake_on_files) {
+    std::unique_lock<std::mutex> guard(lock);
+    work_added.wait(guard, [&]() {
+        return !pending_directories.empty() || active_walkers == 0 || (wake_on_files && !found_files.empty());
+    });
+}
+
+class ASTDiscoveryTask : public BaseExecutorTask {
+public:
+    ASTDiscoveryTask(TaskExecutor &executor, ASTFileDiscovery &discovery)
+        : BaseExecutorTask(executor), discovery(discovery) {
+    }
+
+    void ExecuteTask() override {
+        while (!discovery.WalkFinished()) {
+            if (!discovery.WalkDirectory()) {
+                discovery.WaitForWork(false);
+            }
+        }
+    }
+
+    string TaskType() const override {
+        return "ASTDiscoveryTask";
+    }
+
+private:
+    ASTFileDiscovery &discovery;
+};
+
+vector<string> ASTFileDiscovery::DiscoverAll() {
+    if (!WalkFinished()) {
+        const auto num_threads = NumericCast<idx_t>(TaskScheduler::GetScheduler(context).NumberOfThreads());
+        TaskExecutor executor(context);
+        for (idx_t i = 0; i < num_threads; i++) {
+            executor.ScheduleTask(make_uniq<ASTDiscoveryTask>(executor, *this));
+        }
+        executor.WorkOnTasks();
+    }
+    vector<string> result;
+    string file_path;
+    while (NextFile(file_path)) {
+        result.push_back(std::move(file_path));
+    }
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+} // namespace duckdb
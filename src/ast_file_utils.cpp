@@ -1,8 +1,11 @@
 #include "ast_file_utils.hpp"
+#include "ast_file_discovery.hpp"
 #include "duckdb/common/exception.hpp"
 #include "duckdb/common/string_util.hpp"
 #include "duckdb/common/file_system.hpp"
+#include "re2/re2.h"
 #include <algorithm>
+#include <cstring>
 #include <unordered_map>
 
 namespace duckdb {
@@ -222,28 +225,140 @@ bool ASTFileUtils::IsFileExtensionSupported(const string &file_path, const vecto
 vector<string> ASTFileUtils::GetFiles(ClientContext &context, const vector<string> &patterns,
                                      bool ignore_errors,
                                      const vector<string> &supported_extensions) {
-    vector<string> all_files;
-    
-    // Process each pattern and collect files
-    for (const auto &pattern : patterns) {
-        try {
-            auto pattern_files = ProcessSinglePath(context, pattern, supported_extensions, ignore_errors);
-            all_files.insert(all_files.end(), pattern_files.begin(), pattern_files.end());
-        } catch (const Exception &e) {
-            if (!ignore_errors) {
-                throw IOException("Failed to process pattern '" + pattern + "': " + string(e.what()));
-            }
-            // With ignore_errors=true, continue processing other patterns
+    // Walks directories on all threads; the result is sorted (following DuckDB conventions)
+    // and deduplicated (files may match multiple patterns)
+    ASTFileDiscovery discovery(context, supported_extensions, ignore_errors);
+    discovery.AddPatterns(patterns);
+    return discovery.DiscoverAll();
+}
+
+string ASTFileUtils::ReadFileContent(FileSystem &fs, FileHandle &handle, idx_t file_size) {
+    string content;
+    content.resize(file_size);
+    fs.Read(handle, (void *)content.data(), file_size);
+    return content;
+}
+
+string ASTFileUtils::ReadFile(ClientContext &context, const string &file_path) {
+    auto &fs = FileSystem::GetFileSystem(context);
+    auto handle = fs.OpenFile(file_path, FileFlags::FILE_FLAGS_READ);
+    return ReadFileContent(fs, *handle, NumericCast<idx_t>(fs.GetFileSize(*handle)));
+}
+
+Value ASTFileUtils::OptionalString(const string &value) {
+    return value.empty() ? Value(LogicalType::VARCHAR) : Value(value);
+}
+
+bool ASTFileScreen::SetOption(const string &name, const Value &value) {
+    if (name == "skip_generated") {
+        skip_generated = BooleanValue::Get(value);
+        return true;
+    }
+    if (name != "max_file_size" && name != "max_nodes") {
+        return false;
+    }
+    auto limit = value.GetValue<int64_t>();
+    if (limit < 0) {
+        throw BinderException(name + " must not be negative");
+    }
+    (name == "max_file_size" ? max_file_size : max_nodes) = NumericCast<idx_t>(limit);
+    return true;
+}
+
+string ASTFileScreen::Check(ClientContext &context, const string &file_path) const {
+    auto &fs = FileSystem::GetFileSystem(context);
+    auto handle = fs.OpenFile(file_path, FileFlags::FILE_FLAGS_READ);
+    auto file_size = NumericCast<idx_t>(fs.GetFileSize(*handle));
+    if (max_file_size > 0 && file_size > max_file_size) {
+        return "too_large";
+    }
+    if (!skip_generated) {
+        return string();
+    }
+    auto sample = ASTFileUtils::ReadFileContent(fs, *handle, MinValue<idx_t>(file_size, SAMPLE_SIZE));
+    return Classify(file_path, sample.data(), sample.size());
+}
+
+string ASTFileScreen::CheckContent(const string &file_path, const string &content) const {
+    if (max_file_size > 0 && content.size() > max_file_size) {
+        return "too_large";
+    }
+    if (!skip_generated) {
+        return string();
+    }
+    return Classify(file_path, content.data(), MinValue<idx_t>(content.size(), SAMPLE_SIZE));
+}
+
+string ASTFileScreen::Classify(const string &file_path, const char *data, idx_t size) {
+    // Lockfiles and minified bundles are recognizable by name alone
+    static const char *const GENERATED_NAMES[] = {"package-lock.json", "npm-shrinkwrap.json", "yarn.lock",
+                                                  "pnpm-lock.yaml",    "Cargo.lock",          "poetry.lock",
+                                                  "composer.lock",     "Gemfile.lock",        "go.sum"};
+    auto slash = file_path.find_last_of("/\\");
+    auto name = slash == string::npos ? file_path : file_path.substr(slash + 1);
+    for (auto generated_name : GENERATED_NAMES) {
+        if (name == generated_name) {
+            return "generated";
         }
     }
-    
-    // Sort for consistent ordering (following DuckDB conventions)
-    std::sort(all_files.begin(), all_files.end());
-    
-    // Remove duplicates (files may match multiple patterns)
-    all_files.erase(std::unique(all_files.begin(), all_files.end()), all_files.end());
-    
-    return all_files;
+    if (name.find(".min.") != string::npos) {
+        return "minified";
+    }
+
+    if (memchr(data, '\0', size)) {
+        return "binary";
+    }
+
+    // Minified code: a few very long lines (a sample cut mid-line only shortens the last one)
+    idx_t lines = 1;
+    const char *end = data + size;
+    auto newline = static_cast<const char *>(memchr(data, '\n', size));
+    while (newline) {
+        lines++;
+        newline = static_cast<const char *>(memchr(newline + 1, '\n', NumericCast<size_t>(end - newline - 1)));
+    }
+    if (size >= MINIFIED_LINE_LENGTH && size / lines >= MINIFIED_LINE_LENGTH) {
+        return "minified";
+    }
+
+    // Generator banners sit in the first lines of a file
+    static const char *const GENERATED_MARKERS[] = {"@generated", "DO NOT EDIT", "Code generated by",
+                                                    "autogenerated", "auto-generated", "Autogenerated",
+                                                    "Auto-generated", "AUTO-GENERATED"};
+    string head(data, MinValue<idx_t>(size, 1024));
+    for (auto marker : GENERATED_MARKERS) {
+        if (head.find(marker) != string::npos) {
+            return "generated";
+        }
+    }
+    return string();
+}
+
+ASTContentFilter ASTContentFilter::Create(const string &pattern, const string &mode) {
+    ASTContentFilter filter;
+    filter.pattern = pattern;
+    if (mode == "regex") {
+        filter.is_regex = true;
+        duckdb_re2::RE2::Options options;
+        options.set_log_errors(false);
+        // Multi-line, so that ^ and $ anchor at each line as a line-by-line grep would
+        filter.regex = make_shared_ptr<duckdb_re2::RE2>("(?m)" + pattern, options);
+        if (!filter.regex->ok()) {
+            throw BinderException("Invalid content_filter regex '" + pattern + "': " + filter.regex->error());
+        }
+    } else if (mode != "literal") {
+        throw BinderException("content_filter_mode must be 'literal' or 'regex', got '" + mode + "'");
+    }
+    return filter;
+}
+
+bool ASTContentFilter::Matches(const string &content) const {
+    if (!is_regex) {
+        // memchr-driven search for the first byte, then a compare: SIMD in every libc we build against
+        return content.find(pattern) != string::npos;
+    }
+    // RE2 runs in linear time without recursion, so the whole buffer is searched in one call
+    return duckdb_re2::RE2::PartialMatch(duckdb_re2::StringPiece(content.data(), content.size()), *regex);
 }
 
 } // namespace duckdb
\ No newline at end of file
@@ -0,0 +1,679 @@
+#include "ast_git_repository.hpp"
+#include "ast_file_utils.hpp"
+#include "duckdb/common/exception.hpp"
+#include "duckdb/common/string_util.hpp"
+#include "miniz.hpp"
+#include <algorithm>
+#include <cstring>
+#include <set>
+
+namespace duckdb {
+
+static constexpr idx_t GIT_ID_SIZE = 20;
+static constexpr idx_t GIT_HEX_ID_SIZE = 2 * GIT_ID_SIZE;
+static constexpr idx_t GIT_MIN_ABBREVIATION = 4;
+// Longer delta chains than git itself writes (its default is 50) mean a corrupt pack
+static constexpr idx_t GIT_MAX_DELTA_DEPTH = 10000;
+static constexpr idx_t GIT_BASE_CACHE_SIZE = 64 * 1024 * 1024;
+
+// Pack entry type codes
+static constexpr uint8_t GIT_PACK_OFS_DELTA = 6;
+static constexpr uint8_t GIT_PACK_REF_DELTA = 7;
+
+static uint32_t LoadBigEndian32(const char *data) {
+    auto bytes = reinterpret_cast<const uint8_t *>(data);
+    return (uint32_t(bytes[0]) << 24) | (uint32_t(bytes[1]) << 16) | (uint32_t(bytes[2]) << 8) | uint32_t(bytes[3]);
+}
+
+static bool IsHexId(const string &text, idx_t min_size, idx_t max_size) {
+    if (text.size() < min_size || text.size() > max_size) {
+        return false;
+    }
+    for (auto c : text) {
+        if (!StringUtil::CharacterIsHex(c)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static string FromHex(const string &hex) {
+    string id(hex.size() / 2, '\0');
+    for (idx_t i = 0; i < id.size(); i++) {
+        id[i] = char((StringUtil::GetHexValue(hex[2 * i]) << 4) | StringUtil::GetHexValue(hex[2 * i + 1]));
+    }
+    return id;
+}
+
+string ASTGitRepository::ToHex(const string &object_id) {
+    static const char *digits = "0123456789abcdef";
+    string hex;
+    hex.reserve(object_id.size() * 2);
+    for (auto c : object_id) {
+        auto byte = static_cast<uint8_t>(c);
+        hex += digits[byte >> 4];
+        hex += digits[byte & 0xf];
+    }
+    return hex;
+}
+
+// Inflate the zlib stream starting at `offset`. `expected_size` is checked
+// when known (pack entries record it); loose objects pass INVALID_INDEX.
+static string GitInflate(FileHandle &handle, idx_t offset, idx_t file_size, idx_t expected_size) {
+    duckdb_miniz::mz_stream stream;
+    memset(&stream, 0, sizeof(stream));
+    if (duckdb_miniz::mz_inflateInit(&stream) != duckdb_miniz::MZ_OK) {
+        throw InternalException("Failed to initialize zlib for git object");
+    }
+    string result(expected_size == DConstants::INVALID_INDEX ? 4096 : MaxValue<idx_t>(expected_size, 1), '\0');
+    char input[16 * 1024];
+    auto input_offset = offset;
+    int status = duckdb_miniz::MZ_OK;
+    try {
+        while (status != duckdb_miniz::MZ_STREAM_END) {
+            if (stream.avail_in == 0) {
+                auto input_size = MinValue<idx_t>(sizeof(input), file_size - MinValue(input_offset, file_size));
+                if (input_size == 0) {
+                    throw IOException("Truncated git object in \"%s\"", handle.GetPath());
+                }
+                handle.Read(input, input_size, input_offset);
+                input_offset += input_size;
+                stream.next_in = reinterpret_cast<const unsigned char *>(input);
+                stream.avail_in = NumericCast<unsigned int>(input_size);
+            }
+            if (stream.total_out == result.size()) {
+                result.resize(result.size() * 2);
+            }
+            stream.next_out = reinterpret_cast<unsigned char *>(&result[stream.total_out]);
+            stream.avail_out = NumericCast<unsigned int>(result.size() - stream.total_out);
+            status = duckdb_miniz::mz_inflate(&stream, duckdb_miniz::MZ_NO_FLUSH);
+            if (status != duckdb_miniz::MZ_OK && status != duckdb_miniz::MZ_STREAM_END &&
+                status != duckdb_miniz::MZ_BUF_ERROR) {
+                throw IOException("Corrupt git object in \"%s\"", handle.GetPath());
+            }
+        }
+    } catch (...) {
+        duckdb_miniz::mz_inflateEnd(&stream);
+        throw;
+    }
+    result.resize(stream.total_out);
+    duckdb_miniz::mz_inflateEnd(&stream);
+    if (expected_size != DConstants::INVALID_INDEX && result.size() != expected_size) {
+        throw IOException("Corrupt git object in \"%s\": size mismatch", handle.GetPath());
+    }
+    return result;
+}
+
+// Rebuild an object from its delta base and a git delta (copy and insert instructions)
+static string ApplyDelta(const string &base, const string &delta) {
+    idx_t pos = 0;
+    auto read_size = [&]() {
+        idx_t size = 0;
+        idx_t shift = 0;
+        uint8_t byte;
+        do {
+            if (pos >= delta.size()) {
+                throw IOException("Corrupt git delta");
+            }
+            byte = static_cast<uint8_t>(delta[pos++]);
+            size |= idx_t(byte & 0x7f) << shift;
+            shift += 7;
+        } while (byte & 0x80);
+        return size;
+    };
+    auto base_size = read_size();
+    auto result_size = read_size();
+    if (base_size != base.size()) {
+        throw IOException("Corrupt git delta: base size mismatch");
+    }
+    string result;
+    result.reserve(result_size);
+    while (pos < delta.size()) {
+        auto op = static_cast<uint8_t>(delta[pos++]);
+        if (op & 0x80) {
+            // Copy from the base: the low four bits select offset bytes, the next three size bytes
+            idx_t copy_offset = 0;
+            idx_t copy_size = 0;
+            for (idx_t i = 0; i < 7; i++) {
+                if (!(op & (1 << i))) {
+                    continue;
+                }
+                if (pos >= delta.size()) {
+                    throw IOException("Corrupt git delta");
+                }
+                auto byte = idx_t(static_cast<uint8_t>(delta[pos++]));
+                if (i < 4) {
+                    copy_offset |= byte << (8 * i);
+                } else {
+                    copy_size |= byte << (8 * (i - 4));
+                }
+            }
+            if (copy_size == 0) {
+                copy_size = 0x10000;
+            }
+            if (copy_offset + copy_size > base.size()) {
+                throw IOException("Corrupt git delta: copy out of range");
+            }
+            result.append(base, copy_offset, copy_size);
+        } else if (op > 0) {
+            // Insert the next `op` bytes
+            if (pos + op > delta.size()) {
+                throw IOException("Corrupt git delta");
+            }
+            result.append(delta, pos, op);
+            pos += op;
+        } else {
+            throw IOException("Corrupt git delta: reserved instruction");
+        }
+    }
+    if (result.size() != result_size) {
+        throw IOException("Corrupt git delta: result size mismatch");
+    }
+    return result;
+}
+
+//==============================================================================
+// Packfiles
+//==============================================================================
+
+// A packfile and its (version 2) index, held in memory for lookups
+class ASTGitPack {
+public:
+    ASTGitPack(FileSystem &fs, const string &index_path, const string &index, idx_t pack_id) : pack_id(pack_id) {
+        // Magic, version, 256 fan-out entries, then ids, CRCs, offsets and large offsets
+        static constexpr idx_t HEADER_SIZE = 8 + 256 * 4;
+        if (index.size() < HEADER_SIZE || memcmp(index.data(), "\377tOc", 4) != 0 ||
+            LoadBigEndian32(index.data() + 4) != 2) {
+            throw IOException("Unsupported git pack index \"%s\" (only version 2 is supported)", index_path);
+        }
+        object_count = LoadBigEndian32(index.data() + 8 + 255 * 4);
+        if (index.size() < HEADER_SIZE + object_count * (GIT_ID_SIZE + 8)) {
+            throw IOException("Truncated git pack index \"%s\"", index_path);
+        }
+        for (idx_t i = 0; i < 256; i++) {
+            fanout[i] = LoadBigEndian32(index.data() + 8 + i * 4);
+        }
+        idx_t pos = HEADER_SIZE;
+        ids = index.substr(pos, object_count * GIT_ID_SIZE);
+        pos += object_count * (GIT_ID_SIZE + 4); // Skip the CRCs
+        offsets = index.substr(pos, object_count * 4);
+        pos += object_count * 4;
+        large_offsets = index.substr(pos);
+
+        path = index_path.substr(0, index_path.size() - 4) + ".pack";
+        handle = fs.OpenFile(path, FileFlags::FILE_FLAGS_READ);
+        file_size = handle->GetFileSize();
+    }
+
+    // First object whose id is not less than `prefix`
+    idx_t LowerBound(const string &prefix) const {
+        // The fan-out table counts the ids up to each first byte
+        idx_t low = 0;
+        idx_t high = object_count;
+        if (!prefix.empty()) {
+            auto first_byte = static_cast<uint8_t>(prefix[0]);
+            low = first_byte == 0 ? 0 : fanout[first_byte - 1];
+            high = fanout[first_byte];
+        }
+        while (low < high) {
+            auto middle = low + (high - low) / 2;
+            if (memcmp(ids.data() + middle * GIT_ID_SIZE, prefix.data(), prefix.size()) < 0) {
+                low = middle + 1;
+            } else {
+                high = middle;
+            }
+        }
+        return low;
+    }
+
+    bool Find(const string &object_id, idx_t &offset) const {
+        auto index = LowerBound(object_id);
+        if (index >= object_count || memcmp(ids.data() + index * GIT_ID_SIZE, object_id.data(), GIT_ID_SIZE) != 0) {
+            return false;
+        }
+        offset = LoadBigEndian32(offsets.data() + index * 4);
+        if (offset & 0x80000000) {
+            // Packs over 2GB keep 8-byte offsets in a separate table
+            auto large_index = (offset & 0x7fffffff) * 8;
+            if (large_index + 8 > large_offsets.size()) {
+                throw IOException("Corrupt git pack index for \"%s\"", path);
+            }
+            offset = (idx_t(LoadBigEndian32(large_offsets.data() + large_index)) << 32) |
+                     LoadBigEndian32(large_offsets.data() + large_index + 4);
+        }
+        return true;
+    }
+
+    string Id(idx_t index) const {
+        return ids.substr(index * GIT_ID_SIZE, GIT_ID_SIZE);
+    }
+
+    const idx_t pack_id;
+    string path;
+    unique_ptr<FileHandle> handle;
+    idx_t file_size = 0;
+    idx_t object_count = 0;
+
+private:
+    uint32_t fanout[256];
+    string ids; // Sorted raw ids
+    string offsets;
+    string large_offsets;
+};
+
+//==============================================================================
+// ASTGitRepository
+//==============================================================================
+
+ASTGitRepository::ASTGitRepository(ClientContext &context, const string &path)
+    : context(context), fs(FileSystem::GetFileSystem(context)) {
+    auto dot_git = fs.JoinPath(path, ".git");
+    if (fs.DirectoryExists(dot_git)) {
+        git_dir = dot_git;
+    } else if (fs.FileExists(dot_git)) {
+        // Linked worktrees and submodules point at their git directory
+        auto link = StringUtil::Replace(ASTFileUtils::ReadFile(context, dot_git), "\r", "");
+        StringUtil::Trim(link);
+        if (!StringUtil::StartsWith(link, "gitdir:")) {
+            throw IOException("Not a git repository: %s (unrecognized .git file)", path);
+        }
+        git_dir = link.substr(7);
+        StringUtil::Trim(git_dir);
+        if (!fs.IsPathAbsolute(git_dir)) {
+            git_dir = fs.JoinPath(path, git_dir);
+        }
+    } else if (fs.FileExists(fs.JoinPath(path, "HEAD")) && fs.DirectoryExists(fs.JoinPath(path, "objects"))) {
+        git_dir = path; // Bare repository
+    } else {
+        throw IOException("Not a git repository: %s", path);
+    }
+
+    common_dir = git_dir;
+    auto common_dir_file = fs.JoinPath(git_dir, "commondir");
+    if (fs.FileExists(common_dir_file)) {
+        auto common = ASTFileUtils::ReadFile(context, common_dir_file);
+        StringUtil::Trim(common);
+        common_dir = fs.IsPathAbsolute(common) ? common : fs.JoinPath(git_dir, common);
+    }
+    LoadPacks();
+}
+
+ASTGitRepository::~ASTGitRepository() {
+}
+
+void ASTGitRepository::LoadPacks() {
+    auto pack_dir = fs.JoinPath(fs.JoinPath(common_dir, "objects"), "pack");
+    if (!fs.DirectoryExists(pack_dir)) {
+        return;
+    }
+    vector<string> index_names;
+    fs.ListFiles(pack_dir, [&](const string &name, bool is_directory) {
+        if (!is_directory && StringUtil::EndsWith(name, ".idx")) {
+            index_names.push_back(name);
+        }
+    });
+    std::sort(index_names.begin(), index_names.end());
+    for (auto &name : index_names) {
+        auto index_path = fs.JoinPath(pack_dir, name);
+        auto index = ASTFileUtils::ReadFile(context, index_path);
+        packs.push_back(make_uniq<ASTGitPack>(fs, index_path, index, packs.size()));
+    }
+}
+
+void ASTGitRepository::ReadObject(const string &object_id, ObjectType &type, string &data) {
+    idx_t offset;
+    for (auto &pack : packs) {
+        if (pack->Find(object_id, offset)) {
+            ReadPackObject(*pack, offset, type, data, 0);
+            return;
+        }
+    }
+    if (!ReadLooseObject(object_id, type, data)) {
+        throw IOException("Git object %s not found in \"%s\"", ToHex(object_id), common_dir);
+    }
+}
+
+bool ASTGitRepository::ReadLooseObject(const string &object_id, ObjectType &type, string &data) {
+    auto hex = ToHex(object_id);
+    auto object_path = fs.JoinPath(fs.JoinPath(fs.JoinPath(common_dir, "objects"), hex.substr(0, 2)), hex.substr(2));
+    if (!fs.FileExists(object_path)) {
+        return false;
+    }
+    auto handle = fs.OpenFile(object_path, FileFlags::FILE_FLAGS_READ);
+    auto raw = GitInflate(*handle, 0, handle->GetFileSize(), DConstants::INVALID_INDEX);
+
+    // "<type> <size>\0<content>"
+    auto space = raw.find(' ');
+    auto nul = raw.find('\0');
+    if (space == string::npos || nul == string::npos || space > nul) {
+        throw IOException("Corrupt loose git object \"%s\"", object_path);
+    }
+    auto type_name = raw.substr(0, space);
+    if (type_name == "commit") {
+        type = ObjectType::COMMIT;
+    } else if (type_name == "tree") {
+        type = ObjectType::TREE;
+    } else if (type_name == "blob") {
+        type = ObjectType::BLOB;
+    } else if (type_name == "tag") {
+        type = ObjectType::TAG;
+    } else {
+        throw IOException("Corrupt loose git object \"%s\"", object_path);
+    }
+    data = raw.substr(nul + 1);
+    return true;
+}
+
+void ASTGitRepository::ReadPackObject(ASTGitPack &pack, idx_t offset, ObjectType &type, string &data, idx_t depth) {
+    if (depth > GIT_MAX_DELTA_DEPTH || offset >= pack.file_size) {
+        throw IOException("Corrupt git pack \"%s\"", pack.path);
+    }
+    // Entry header: type and inflated size, then the delta base for deltas
+    char header[32];
+    auto header_size = MinValue<idx_t>(sizeof(header), pack.file_size - offset);
+    pack.handle->Read(header, header_size, offset);
+    idx_t pos = 0;
+    auto byte = static_cast<uint8_t>(header[pos++]);
+    auto code = uint8_t((byte >> 4) & 7);
+    idx_t size = byte & 0xf;
+    for (idx_t shift = 4; byte & 0x80; shift += 7) {
+        if (pos >= header_size) {
+            throw IOException("Corrupt git pack \"%s\"", pack.path);
+        }
+        byte = static_cast<uint8_t>(header[pos++]);
+        size |= idx_t(byte & 0x7f) << shift;
+    }
+
+    if (code >= uint8_t(ObjectType::COMMIT) && code <= uint8_t(ObjectType::TAG)) {
+        type = ObjectType(code);
+        data = GitInflate(*pack.handle, offset + pos, pack.file_size, size);
+        return;
+    }
+    if (code == GIT_PACK_OFS_DELTA) {
+        // Base offset, relative to this entry, in git's "offset encoding"
+        if (pos >= header_size) {
+            throw IOException("Corrupt git pack \"%s\"", pack.path);
+        }
+        byte = static_cast<uint8_t>(header[pos++]);
+        idx_t distance = byte & 0x7f;
+        while (byte & 0x80) {
+            if (pos >= header_size) {
+                throw IOException("Corrupt git pack \"%s\"", pack.path);
+            }
+            byte = static_cast<uint8_t>(header[pos++]);
+            distance = ((distance + 1) << 7) | (byte & 0x7f);
+        }
+        if (distance == 0 || distance > offset) {
+            throw IOException("Corrupt git pack \"%s\"", pack.path);
+        }
+        auto delta = GitInflate(*pack.handle, offset + pos, pack.file_size, size);
+        auto base = DeltaBase(pack, offset - distance, type, depth + 1);
+        data = ApplyDelta(*base, delta);
+        return;
+    }
+    if (code == GIT_PACK_REF_DELTA) {
+        if (pos + GIT_ID_SIZE > header_size) {
+            throw IOException("Corrupt git pack \"%s\"", pack.path);
+        }
+        auto base_id = string(header + pos, GIT_ID_SIZE);
+        auto delta = GitInflate(*pack.handle, offset + pos + GIT_ID_SIZE, pack.file_size, size);
+        string base;
+        ReadObject(base_id, type, base);
+        data = ApplyDelta(base, delta);
+        return;
+    }
+    throw IOException("Corrupt git pack \"%s\": unknown entry type %d", pack.path, int(code));
+}
+
+shared_ptr<const string> ASTGitRepository::DeltaBase(ASTGitPack &pack, idx_t offset, ObjectType &type, idx_t depth) {
+    // Objects in a delta chain are usually bases of several others
+    auto key = std::to_string(pack.pack_id) + ":" + std::to_string(offset);
+    {
+        std::lock_guard<std::mutex> guard(base_lock);
+        auto entry = base_cache.find(key);
+        if (entry != base_cache.end()) {
+            type = entry->second.first;
+            return entry->second.second;
+        }
+    }
+    string data;
+    ReadPackObject(pack, offset, type, data, depth);
+    auto base = make_shared_ptr<const string>(std::move(data));
+
+    std::lock_guard<std::mutex> guard(base_lock);
+    if (base_cache_size + base->size() > GIT_BASE_CACHE_SIZE) {
+        base_cache.clear();
+        base_cache_size = 0;
+    }
+    if (base_cache.emplace(key, make_pair(type, base)).second) {
+        base_cache_size += base->size();
+    }
+    return base;
+}
+
+string ASTGitRepository::ReadBlob(const string &blob_id) {
+    ObjectType type;
+    string data;
+    ReadObject(blob_id, type, data);
+    if (type != ObjectType::BLOB) {
+        throw IOException("Git object %s is not a blob", ToHex(blob_id));
+    }
+    return data;
+}
+
+//==============================================================================
+// Revisions
+//==============================================================================
+
+// Object id a ref points at (following symbolic refs); empty if there is no such ref
+string ASTGitRepository::ReadRef(const string &name, idx_t depth) {
+    if (depth > 10) {
+        throw IOException("Symbolic ref loop at \"%s\"", name);
+    }
+    // HEAD and other per-worktree refs live in the git directory, shared refs in the common one
+    for (auto &dir : {git_dir, common_dir}) {
+        auto ref_path = fs.JoinPath(dir, name);
+        if (!fs.FileExists(ref_path)) {
+            continue;
+        }
+        auto value = ASTFileUtils::ReadFile(context, ref_path);
+        StringUtil::Trim(value);
+        if (StringUtil::StartsWith(value, "ref:")) {
+            auto target = value.substr(4);
+            StringUtil::Trim(target);
+            return ReadRef(target, depth + 1);
+        }
+        if (!IsHexId(value, GIT_HEX_ID_SIZE, GIT_HEX_ID_SIZE)) {
+            throw IOException("Unsupported git ref \"%s\" (only SHA-1 repositories are supported)", ref_path);
+        }
+        return FromHex(value);
+    }
+
+    if (!packed_refs_loaded) {
+        packed_refs_loaded = true;
+        auto packed_path = fs.JoinPath(common_dir, "packed-refs");
+        if (fs.FileExists(packed_path)) {
+            for (auto &line : StringUtil::Split(ASTFileUtils::ReadFile(context, packed_path), '\n')) {
+                // "<id> <ref>"; '#' starts the header and '^' the peeled id of the tag above
+                if (line.empty() || line[0] == '#' || line[0] == '^' || line.size() <= GIT_HEX_ID_SIZE + 1) {
+                    continue;
+                }
+                auto ref_name = line.substr(GIT_HEX_ID_SIZE + 1);
+                StringUtil::Trim(ref_name);
+                packed_refs[ref_name] = FromHex(line.substr(0, GIT_HEX_ID_SIZE));
+            }
+        }
+    }
+    auto entry = packed_refs.find(name);
+    return entry == packed_refs.end() ? string() : entry->second;
+}
+
+// Object id for a ref name or object id, following git's lookup order
+string ASTGitRepository::ResolveName(const string &name) {
+    if (IsHexId(name, GIT_HEX_ID_SIZE, GIT_HEX_ID_SIZE)) {
+        return FromHex(name);
+    }
+    if (name.find("..") == string::npos) {
+        for (auto &ref : {name, "refs/" + name, "refs/tags/" + name, "refs/heads/" + name, "refs/remotes/" + name,
+                          "refs/remotes/" + name + "/HEAD"}) {
+            auto object_id = ReadRef(ref, 0);
+            if (!object_id.empty()) {
+                return object_id;
+            }
+        }
+    }
+    if (IsHexId(name, GIT_MIN_ABBREVIATION, GIT_HEX_ID_SIZE)) {
+        return FindByPrefix(StringUtil::Lower(name));
+    }
+    return string();
+}
+
+string ASTGitRepository::FindByPrefix(const string &hex_prefix) {
+    std::set<string> candidates;
+    auto loose_dir = fs.JoinPath(fs.JoinPath(common_dir, "objects"), hex_prefix.substr(0, 2));
+    if (fs.DirectoryExists(loose_dir)) {
+        auto rest = hex_prefix.substr(2);
+        fs.ListFiles(loose_dir, [&](const string &name, bool is_directory) {
+            if (!is_directory && name.size() == GIT_HEX_ID_SIZE - 2 && StringUtil::StartsWith(name, rest)) {
+                candidates.insert(FromHex(hex_prefix.substr(0, 2) + name));
+            }
+        });
+    }
+    // Whole bytes of the prefix narrow the search; the odd digit is checked on the hex
+    auto byte_prefix = FromHex(hex_prefix.substr(0, hex_prefix.size() & ~idx_t(1)));
+    for (auto &pack : packs) {
+        for (auto index = pack->LowerBound(byte_prefix); index < pack->object_count; index++) {
+            auto object_id = pack->Id(index);
+            if (!StringUtil::StartsWith(ToHex(object_id), hex_prefix)) {
+                break;
+            }
+            candidates.insert(object_id);
+        }
+    }
+    if (candidates.size() > 1) {
+        throw InvalidInputException("Ambiguous abbreviated git object id \"%s\"", hex_prefix);
+    }
+    return candidates.empty() ? string() : *candidates.begin();
+}
+
+// The commit an object id names, looking through annotated tags
+string ASTGitRepository::Peel(string object_id) {
+    while (true) {
+        ObjectType type;
+        string data;
+        ReadObject(object_id, type, data);
+        if (type == ObjectType::COMMIT) {
+            return object_id;
+        }
+        if (type != ObjectType::TAG || !StringUtil::StartsWith(data, "object ") ||
+            data.size() < 7 + GIT_HEX_ID_SIZE) {
+            throw InvalidInputException("Git object %s is not a commit", ToHex(object_id));
+        }
+        object_id = FromHex(data.substr(7, GIT_HEX_ID_SIZE));
+    }
+}
+
+string ASTGitRepository::Parent(const string &commit_id, idx_t parent_number) {
+    if (parent_number == 0) {
+        return commit_id;
+    }
+    ObjectType type;
+    string data;
+    ReadObject(commit_id, type, data);
+    // Headers up to the first blank line; parents follow the tree
+    idx_t parent_count = 0;
+    for (auto &line : StringUtil::Split(data.substr(0, data.find("\n\n")), '\n')) {
+        if (StringUtil::StartsWith(line, "parent ") && ++parent_count == parent_number) {
+            return FromHex(line.substr(7, GIT_HEX_ID_SIZE));
+        }
+    }
+    throw InvalidInputException("Git commit " + ToHex(commit_id) + " has no parent " + std::to_string(parent_number));
+}
+
+string ASTGitRepository::ResolveRevision(const string &revision) {
+    auto steps = revision.find_first_of("~^");
+    auto object_id = ResolveName(revision.substr(0, steps));
+    if (object_id.empty()) {
+        throw InvalidInputException("Unknown git revision \"%s\"", revision);
+    }
+    auto commit_id = Peel(object_id);
+
+    // "~N" follows first parents N times, "^N" takes the N-th parent
+    for (auto pos = steps; pos < revision.size();) {
+        auto op = revision[pos++];
+        if (op != '~' && op != '^') {
+            throw InvalidInputException("Unsupported git revision syntax \"%s\"", revision);
+        }
+        idx_t number = 1;
+        if (pos < revision.size() && StringUtil::CharacterIsDigit(revision[pos])) {
+            number = 0;
+            while (pos < revision.size() && StringUtil::CharacterIsDigit(revision[pos])) {
+                number = number * 10 + idx_t(revision[pos++] - '0');
+            }
+        }
+        if (op == '~') {
+            for (idx_t i = 0; i < number; i++) {
+                commit_id = Parent(commit_id, 1);
+            }
+        } else {
+            commit_id = Parent(commit_id, number);
+        }
+    }
+    return commit_id;
+}
+
+//==============================================================================
+// Trees
+//==============================================================================
+
+void ASTGitRepository::ListFiles(const string &commit_id, vector<ASTGitTreeEntry> &entries) {
+    ObjectType type;
+    string data;
+    ReadObject(commit_id, type, data);
+    if (type != ObjectType::COMMIT || !StringUtil::StartsWith(data, "tree ") || data.size() < 5 + GIT_HEX_ID_SIZE) {
+        throw InvalidInputException("Git object %s is not a commit", ToHex(commit_id));
+    }
+    auto files = ListTree(FromHex(data.substr(5, GIT_HEX_ID_SIZE)));
+    entries.insert(entries.end(), files->begin(), files->end());
+}
+
+shared_ptr<vector<ASTGitTreeEntry>> ASTGitRepository::ListTree(const string &tree_id) {
+    auto listed = listed_trees.find(tree_id);
+    if (listed != listed_trees.end()) {
+        return listed->second;
+    }
+    ObjectType type;
+    string data;
+    ReadObject(tree_id, type, data);
+    if (type != ObjectType::TREE) {
+        throw IOException("Git object %s is not a tree", ToHex(tree_id));
+    }
+
+    // Entries are "<octal mode> <name>\0<raw id>"
+    auto files = make_shared_ptr<vector<ASTGitTreeEntry>>();
+    idx_t pos = 0;
+    while (pos < data.size()) {
+        auto space = data.find(' ', pos);
+        auto nul = space == string::npos ? string::npos : data.find('\0', space);
+        if (nul == string::npos || nul + 1 + GIT_ID_SIZE > data.size()) {
+            throw IOException("Corrupt git tree %s", ToHex(tree_id));
+        }
+        auto mode = data.substr(pos, space - pos);
+        auto name = data.substr(space + 1, nul - space - 1);
+        auto object_id = data.substr(nul + 1, GIT_ID_SIZE);
+        pos = nul + 1 + GIT_ID_SIZE;
+
+        if (mode == "40000") {
+            for (auto &file : *ListTree(object_id)) {
+                files->push_back(ASTGitTreeEntry {name + "/" + file.path, file.blob_id});
+            }
+        } else if (StringUtil::StartsWith(mode, "100")) {
+            files->push_back(ASTGitTreeEntry {name, object_id});
+        }
+        // 120000 (symlink) and 160000 (submodule) entries have no source to parse
+    }
+    listed_trees[tree_id] = files;
+    return files;
+}
+
+} // namespace duckdb
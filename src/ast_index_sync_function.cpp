@@ -0,0 +1,361 @@
+#include "duckdb.hpp"
+#include "duckdb/common/exception.hpp"
+#include "duckdb/common/file_system.hpp"
+#include "duckdb/common/types/hash.hpp"
+#include "duckdb/main/appender.hpp"
+#include "duckdb/main/client_context.hpp"
+#include "duckdb/main/connection.hpp"
+#include "duckdb/main/extension_util.hpp"
+#include "duckdb/parser/keyword_helper.hpp"
+#include "duckdb/parser/qualified_name.hpp"
+#include "ast_file_utils.hpp"
+#include "unified_ast_backend.hpp"
+#include <algorithm>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace duckdb {
+
+//==============================================================================
+// ast_index_sync(table_name, file_patterns, ...)
+//==============================================================================
+//
+// Keeps <table_name> (read_ast schema) in sync with the files matching the
+// patterns. A side table <table_name>_files records a fingerprint per indexed
+// file (size, mtime, content hash); only added, changed and deleted files are
+// touched, all inside one transaction on a dedicated connection.
+//
+// A table function cannot run queries on the ClientContext that is executing
+// it, so that connection is separate from the caller's and the sync commits on
+// its own. Calls inside an explicit transaction are rejected at bind time rather
+// than committing behind the caller's back; the sync does not see temporary
+// tables of the calling connection either.
+
+struct ASTIndexSyncBindData : public TableFunctionData {
+    string schema_name;
+    string table_name;
+    Value file_patterns;
+    string language = "auto";
+    bool ignore_errors = false;
+    int32_t peek_size = 120;
+    string peek_mode = "auto";
+};
+
+struct ASTIndexSyncChange {
+    string file_path;
+    string action;        // 'added', 'changed' or 'deleted'
+    Value node_count;     // NULL for deleted files
+};
+
+struct ASTIndexSyncGlobalState : public GlobalTableFunctionState {
+    bool synced = false;
+    vector<ASTIndexSyncChange> changes;
+    idx_t offset = 0;
+};
+
+struct FileFingerprint {
+    idx_t file_size = 0;
+    timestamp_t last_modified;
+    hash_t content_hash = 0;
+    string language;
+    int64_t node_count = 0;
+};
+
+static unique_ptr<FunctionData> ASTIndexSyncBind(ClientContext &context, TableFunctionBindInput &input,
+                                                 vector<LogicalType> &return_types, vector<string> &names) {
+    auto result = make_uniq<ASTIndexSyncBindData>();
+
+    if (!context.transaction.IsAutoCommit()) {
+        throw InvalidInputException("ast_index_sync cannot run inside an explicit transaction: it commits its "
+                                    "changes on its own connection, which a ROLLBACK would not undo");
+    }
+    if (input.inputs[0].IsNull()) {
+        throw BinderException("ast_index_sync: table name cannot be NULL");
+    }
+    auto qualified_name = QualifiedName::Parse(input.inputs[0].GetValue<string>());
+    if (!qualified_name.catalog.empty() && qualified_name.catalog != INVALID_CATALOG) {
+        throw BinderException("ast_index_sync: catalog-qualified table names are not supported");
+    }
+    result->schema_name = qualified_name.schema == INVALID_SCHEMA ? string() : qualified_name.schema;
+    result->table_name = qualified_name.name;
+
+    auto &patterns = input.inputs[1];
+    if (patterns.IsNull()) {
+        throw BinderException("ast_index_sync: file patterns cannot be NULL");
+    }
+    if (patterns.type().id() != LogicalTypeId::VARCHAR &&
+        !(patterns.type().id() == LogicalTypeId::LIST &&
+          ListType::GetChildType(patterns.type()).id() == LogicalTypeId::VARCHAR)) {
+        throw BinderException("File patterns must be VARCHAR or LIST(VARCHAR)");
+    }
+    result->file_patterns = patterns;
+
+    for (auto &kv : input.named_parameters) {
+        if (kv.first == "language") {
+            result->language = StringValue::Get(kv.second);
+        } else if (kv.first == "ignore_errors") {
+            result->ignore_errors = BooleanValue::Get(kv.second);
+        } else if (kv.first == "peek_size") {
+            result->peek_size = IntegerValue::Get(kv.second);
+        } else if (kv.first == "peek_mode") {
+            result->peek_mode = StringValue::Get(kv.second);
+        }
+    }
+
+    names = {"file_path", "action", "node_count"};
+    return_types = {LogicalType::VARCHAR, LogicalType::VARCHAR, LogicalType::BIGINT};
+    return std::move(result);
+}
+
+static unique_ptr<GlobalTableFunctionState> ASTIndexSyncInit(ClientContext &context, TableFunctionInitInput &input) {
+    return make_uniq<ASTIndexSyncGlobalState>();
+}
+
+static string QualifiedTableName(const string &schema_name, const string &table_name) {
+    auto result = KeywordHelper::WriteOptionallyQuoted(table_name);
+    if (!schema_name.empty()) {
+        result = KeywordHelper::WriteOptionallyQuoted(schema_name) + "." + result;
+    }
+    return result;
+}
+
+static unique_ptr<MaterializedQueryResult> RunQuery(Connection &con, const string &sql) {
+    auto result = con.Query(sql);
+    if (result->HasError()) {
+        result->ThrowError();
+    }
+    return result;
+}
+
+static Value PathListValue(const vector<string> &paths) {
+    vector<Value> values;
+    values.reserve(paths.size());
+    for (const auto &path : paths) {
+        values.emplace_back(path);
+    }
+    return Value::LIST(LogicalType::VARCHAR, std::move(values));
+}
+
+static void SyncIndex(ClientContext &context, const ASTIndexSyncBindData &bind_data,
+                      vector<ASTIndexSyncChange> &changes) {
+    auto &fs = FileSystem::GetFileSystem(context);
+    const auto nodes_table = QualifiedTableName(bind_data.schema_name, bind_data.table_name);
+    const auto files_table_name = bind_data.table_name + "_files";
+    const auto files_table = QualifiedTableName(bind_data.schema_name, files_table_name);
+
+    // Discover the current file set
+    vector<string> supported_extensions;
+    if (bind_data.language != "auto") {
+        supported_extensions = ASTFileUtils::GetSupportedExtensions(bind_data.language);
+    }
+    auto file_paths = ASTFileUtils::GetFiles(context, bind_data.file_patterns, bind_data.ignore_errors,
+                                             supported_extensions);
+
+    // All reads and writes happen in one transaction on a side connection (see the
+    // top of this file), so a failure leaves both tables exactly as they were
+    Connection con(*context.db);
+    con.BeginTransaction();
+    try {
+        // Create the node table with the read_ast schema, and the fingerprint table
+        auto types = UnifiedASTBackend::GetHierarchicalTableSchema();
+        auto column_names = UnifiedASTBackend::GetHierarchicalTableColumnNames();
+        string columns;
+        for (idx_t i = 0; i < types.size(); i++) {
+            columns += (i > 0 ? ", " : "") + KeywordHelper::WriteOptionallyQuoted(column_names[i]) + " " +
+                       types[i].ToString();
+        }
+        RunQuery(con, "CREATE TABLE IF NOT EXISTS " + nodes_table + " (" + columns + ")");
+        RunQuery(con, "CREATE TABLE IF NOT EXISTS " + files_table +
+                          " (file_path VARCHAR, language VARCHAR, file_size UBIGINT, last_modified TIMESTAMP,"
+                          " content_hash UBIGINT, node_count BIGINT, synced_at TIMESTAMP)");
+
+        // Load the fingerprints of the last sync
+        std::unordered_map<string, FileFingerprint> fingerprints;
+        auto existing = RunQuery(con, "SELECT file_path, file_size, last_modified, content_hash, language, node_count "
+                                      "FROM " + files_table);
+        for (idx_t row = 0; row < existing->RowCount(); row++) {
+            FileFingerprint fingerprint;
+            fingerprint.file_size = existing->GetValue(1, row).GetValue<uint64_t>();
+            fingerprint.last_modified = existing->GetValue(2, row).GetValue<timestamp_t>();
+            fingerprint.content_hash = existing->GetValue(3, row).GetValue<uint64_t>();
+            fingerprint.language = existing->GetValue(4, row).ToString();
+            fingerprint.node_count = existing->GetValue(5, row).GetValue<int64_t>();
+            fingerprints[existing->GetValue(0, row).ToString()] = fingerprint;
+        }
+
+        // Classify the current files against the fingerprints
+        vector<string> added;
+        vector<string> changed;
+        vector<string> touched;  // New mtime, same content: fingerprint refresh only
+        std::unordered_map<string, FileFingerprint> new_fingerprints;
+        std::unordered_set<string> current_files;
+        for (const auto &file_path : file_paths) {
+            current_files.insert(file_path);
+            string language = bind_data.language;
+            if (language == "auto") {
+                language = ASTFileUtils::DetectLanguageFromPath(file_path);
+                if (language == "auto") {
+                    if (!bind_data.ignore_errors) {
+                        throw BinderException("Could not detect language for file: " + file_path);
+                    }
+                    continue;
+                }
+            }
+
+            FileFingerprint fingerprint;
+            fingerprint.language = language;
+            unique_ptr<FileHandle> handle;
+            try {
+                handle = fs.OpenFile(file_path, FileFlags::FILE_FLAGS_READ);
+            } catch (const Exception &) {
+                if (!bind_data.ignore_errors) {
+                    throw;
+                }
+                continue;
+            }
+            fingerprint.file_size = fs.GetFileSize(*handle);
+            fingerprint.last_modified = fs.GetLastModifiedTime(*handle);
+
+            auto previous = fingerprints.find(file_path);
+            if (previous != fingerprints.end() && previous->second.file_size == fingerprint.file_size &&
+                previous->second.last_modified == fingerprint.last_modified &&
+                previous->second.language == fingerprint.language) {
+                continue; // Unchanged
+            }
+
+            auto content = ASTFileUtils::ReadFileContent(fs, *handle, fingerprint.file_size);
+            fingerprint.content_hash = Hash(content.c_str(), content.size());
+            if (previous == fingerprints.end()) {
+                added.push_back(file_path);
+            } else if (previous->second.content_hash == fingerprint.content_hash &&
+                       previous->second.file_size == fingerprint.file_size &&
+                       previous->second.language == fingerprint.language) {
+                fingerprint.node_count = previous->second.node_count;
+                touched.push_back(file_path);
+            } else {
+                changed.push_back(file_path);
+            }
+            new_fingerprints[file_path] = fingerprint;
+        }
+
+        // Indexed files that no longer exist on disk. Files that merely fall outside
+        // this call's patterns are left alone, so several syncs can share one table.
+        vector<string> deleted;
+        for (const auto &entry : fingerprints) {
+            if (current_files.find(entry.first) == current_files.end() && !fs.FileExists(entry.first)) {
+                deleted.push_back(entry.first);
+            }
+        }
+        std::sort(deleted.begin(), deleted.end());
+
+        // Drop the rows and fingerprints of everything that changed
+        vector<string> stale = changed;
+        stale.insert(stale.end(), deleted.begin(), deleted.end());
+        stale.insert(stale.end(), touched.begin(), touched.end());
+        if (!stale.empty()) {
+            auto stale_list = PathListValue(stale).ToSQLString();
+            RunQuery(con, "DELETE FROM " + files_table + " WHERE list_contains(" + stale_list + ", file_path)");
+        }
+        vector<string> reparse = added;
+        reparse.insert(reparse.end(), changed.begin(), changed.end());
+        std::sort(reparse.begin(), reparse.end());
+        vector<string> remove_rows = changed;
+        remove_rows.insert(remove_rows.end(), deleted.begin(), deleted.end());
+        if (!remove_rows.empty()) {
+            auto remove_list = PathListValue(remove_rows).ToSQLString();
+            RunQuery(con, "DELETE FROM " + nodes_table + " WHERE list_contains(" + remove_list +
+                              ", source.file_path)");
+        }
+
+        // Parse added and changed files with read_ast (parallel, cache-aware)
+        std::unordered_map<string, int64_t> node_counts;
+        if (!reparse.empty()) {
+            auto reparse_list = PathListValue(reparse).ToSQLString();
+            auto read_ast_call = "read_ast(" + reparse_list + ", " + Value(bind_data.language).ToSQLString() +
+                                 ", ignore_errors := " + (bind_data.ignore_errors ? "true" : "false") +
+                                 ", peek_size := " + std::to_string(bind_data.peek_size) +
+                                 ", peek_mode := " + Value(bind_data.peek_mode).ToSQLString() + ")";
+            RunQuery(con, "INSERT INTO " + nodes_table + " SELECT * FROM " + read_ast_call);
+            auto counts = RunQuery(con, "SELECT source.file_path, COUNT(*) FROM " + nodes_table +
+                                            " WHERE list_contains(" + reparse_list +
+                                            ", source.file_path) GROUP BY ALL");
+            for (idx_t row = 0; row < counts->RowCount(); row++) {
+                node_counts[counts->GetValue(0, row).ToString()] = counts->GetValue(1, row).GetValue<int64_t>();
+            }
+        }
+
+        // Record the new fingerprints
+        auto synced_at = Timestamp::GetCurrentTimestamp();
+        {
+            Appender appender(con, bind_data.schema_name.empty() ? DEFAULT_SCHEMA : bind_data.schema_name,
+                              files_table_name);
+            vector<string> record = reparse;
+            record.insert(record.end(), touched.begin(), touched.end());
+            for (const auto &file_path : record) {
+                auto &fingerprint = new_fingerprints[file_path];
+                auto count = node_counts.find(file_path);
+                if (count != node_counts.end()) {
+                    fingerprint.node_count = count->second;
+                }
+                appender.BeginRow();
+                appender.Append(file_path.c_str());
+                appender.Append(fingerprint.language.c_str());
+                appender.Append<uint64_t>(fingerprint.file_size);
+                appender.Append<timestamp_t>(fingerprint.last_modified);
+                appender.Append<uint64_t>(fingerprint.content_hash);
+                appender.Append<int64_t>(fingerprint.node_count);
+                appender.Append<timestamp_t>(synced_at);
+                appender.EndRow();
+            }
+            appender.Close();
+        }
+        con.Commit();
+
+        // Report what changed
+        for (const auto &file_path : reparse) {
+            auto count = node_counts.find(file_path);
+            changes.push_back({file_path, fingerprints.count(file_path) ? "changed" : "added",
+                               Value::BIGINT(count == node_counts.end() ? 0 : count->second)});
+        }
+        for (const auto &file_path : deleted) {
+            changes.push_back({file_path, "deleted", Value(LogicalType::BIGINT)});
+        }
+    } catch (...) {
+        if (con.HasActiveTransaction()) {
+            con.Rollback();
+        }
+        throw;
+    }
+}
+
+static void ASTIndexSyncFunction(ClientContext &context, TableFunctionInput &data_p, DataChunk &output) {
+    auto &bind_data = data_p.bind_data->Cast<ASTIndexSyncBindData>();
+    auto &state = data_p.global_state->Cast<ASTIndexSyncGlobalState>();
+
+    if (!state.synced) {
+        SyncIndex(context, bind_data, state.changes);
+        state.synced = true;
+    }
+
+    idx_t count = 0;
+    while (state.offset < state.changes.size() && count < STANDARD_VECTOR_SIZE) {
+        auto &change = state.changes[state.offset++];
+        output.SetValue(0, count, Value(change.file_path));
+        output.SetValue(1, count, Value(change.action));
+        output.SetValue(2, count, change.node_count);
+        count++;
+    }
+    output.SetCardinality(count);
+}
+
+void RegisterASTIndexSyncFunction(DatabaseInstance &instance) {
+    TableFunction function("ast_index_sync", {LogicalType::VARCHAR, LogicalType::ANY}, ASTIndexSyncFunction,
+                           ASTIndexSyncBind, ASTIndexSyncInit);
+    function.named_parameters["language"] = LogicalType::VARCHAR;
+    function.named_parameters["ignore_errors"] = LogicalType::BOOLEAN;
+    function.named_parameters["peek_size"] = LogicalType::INTEGER;
+    function.named_parameters["peek_mode"] = LogicalType::VARCHAR;
+    ExtensionUtil::RegisterFunction(instance, function);
+}
+
+} // namespace duckdb
@@ -0,0 +1,201 @@
+#include "ast_node_at_functions.hpp"
+#include "ast_file_utils.hpp"
+#include "ast_parse_cache.hpp"
+#include "unified_ast_backend.hpp"
+#include "duckdb/common/exception.hpp"
+#include "duckdb/execution/expression_executor_state.hpp"
+#include "duckdb/function/scalar_function.hpp"
+#include "duckdb/main/extension_util.hpp"
+#include <algorithm>
+
+namespace duckdb {
+
+//==============================================================================
+// ast_node_at(file_path, line, column) -> LIST(node)
+// ast_node_at(file_path, start_line, start_column, end_line, end_column)
+//==============================================================================
+//
+// Point lookup for editor and agent integrations: the innermost node that
+// contains the position (or the half-open range), followed by its ancestors
+// up to the root. Lines and columns are 1-based, as in read_ast.
+//
+// The file is parsed through the shared parse cache, so a file already read
+// by read_ast is not parsed again. The lookup then descends from the root: of
+// each node's children (first child i + 1, next sibling c + descendant_count
+// + 1) it enters the one containing the range. The cost is proportional to
+// depth times fan-out, not to the file size. Rows of a chunk are grouped by
+// file, and the last few trees stay in a per-thread cache, so a table of many
+// points is answered with one parse per file.
+
+static constexpr idx_t NODE_AT_CACHE_FILES = 4;
+
+struct ASTNodeAtLocalState : public FunctionLocalState {
+    // Most recently used file last
+    vector<pair<string, shared_ptr<const ASTResult>>> files;
+
+    const ASTResult &GetTree(ClientContext &context, const string &file_path) {
+        for (idx_t i = 0; i < files.size(); i++) {
+            if (files[i].first == file_path) {
+                if (i + 1 != files.size()) {
+                    auto entry = std::move(files[i]);
+                    files.erase(files.begin() + NumericCast<int64_t>(i));
+                    files.push_back(std::move(entry));
+                }
+                return *files.back().second;
+            }
+        }
+        auto language = ASTFileUtils::DetectLanguageFromPath(file_path);
+        if (language == "auto") {
+            throw InvalidInputException("ast_node_at: could not detect language for file: " + file_path);
+        }
+        shared_ptr<const ASTResult> result;
+        try {
+            result = ASTParseCache::ParseFile(context, file_path, language, ExtractionConfig());
+        } catch (const Exception &e) {
+            throw IOException("ast_node_at: error processing file " + file_path + ": " + string(e.what()));
+        }
+        if (files.size() >= NODE_AT_CACHE_FILES) {
+            files.erase(files.begin());
+        }
+        files.emplace_back(file_path, std::move(result));
+        return *files.back().second;
+    }
+};
+
+static unique_ptr<FunctionLocalState> ASTNodeAtInitLocal(ExpressionState &state, const BoundFunctionExpression &expr,
+                                                         FunctionData *bind_data) {
+    return make_uniq<ASTNodeAtLocalState>();
+}
+
+struct ASTSourceRange {
+    int64_t start_line;
+    int64_t start_column;
+    int64_t end_line;   // End position is exclusive
+    int64_t end_column;
+};
+
+static bool PositionLessEqual(int64_t line_a, int64_t column_a, int64_t line_b, int64_t column_b) {
+    return line_a < line_b || (line_a == line_b && column_a <= column_b);
+}
+
+static bool StartsAfter(const ASTNode &node, const ASTSourceRange &range) {
+    return !PositionLessEqual(node.source.start_line, node.source.start_column, range.start_line, range.start_column);
+}
+
+static bool Contains(const ASTNode &node, const ASTSourceRange &range) {
+    return !StartsAfter(node, range) &&
+           PositionLessEqual(range.end_line, range.end_column, node.source.end_line, node.source.end_column);
+}
+
+// Innermost node containing the range first, then its ancestors up to the root
+static void FindNodeAt(const vector<ASTNode> &nodes, const ASTSourceRange &range, vector<idx_t> &chain) {
+    chain.clear();
+    if (nodes.empty() || !Contains(nodes[0], range)) {
+        return;
+    }
+    idx_t current = 0;
+    chain.push_back(current);
+    while (true) {
+        const idx_t last = current + nodes[current].structure.descendant_count;
+        bool descended = false;
+        for (idx_t child = current + 1; child <= last; child += nodes[child].structure.descendant_count + 1) {
+            if (StartsAfter(nodes[child], range)) {
+                break; // Children are in source order
+            }
+            if (Contains(nodes[child], range)) {
+                current = child;
+                chain.push_back(current);
+                descended = true;
+                break;
+            }
+        }
+        if (!descended) {
+            break;
+        }
+    }
+    std::reverse(chain.begin(), chain.end());
+}
+
+static void ASTNodeAtFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+    auto &local_state = ExecuteFunctionState::GetFunctionState(state)->Cast<ASTNodeAtLocalState>();
+    auto &context = state.GetContext();
+    const auto count = args.size();
+    const bool is_range = args.ColumnCount() == 5;
+
+    vector<UnifiedVectorFormat> formats(args.ColumnCount());
+    for (idx_t c = 0; c < args.ColumnCount(); c++) {
+        args.data[c].ToUnifiedFormat(count, formats[c]);
+    }
+    auto paths = UnifiedVectorFormat::GetData<string_t>(formats[0]);
+    auto position = [&](idx_t c, idx_t row) {
+        return UnifiedVectorFormat::GetData<int64_t>(formats[c])[formats[c].sel->get_index(row)];
+    };
+
+    result.SetVectorType(VectorType::FLAT_VECTOR);
+    auto &result_validity = FlatVector::Validity(result);
+
+    // Rows with all arguments present, grouped by file
+    vector<idx_t> rows;
+    rows.reserve(count);
+    for (idx_t row = 0; row < count; row++) {
+        bool valid = true;
+        for (auto &format : formats) {
+            valid = valid && format.validity.RowIsValid(format.sel->get_index(row));
+        }
+        if (valid) {
+            rows.push_back(row);
+        } else {
+            result_validity.SetInvalid(row);
+        }
+    }
+    std::stable_sort(rows.begin(), rows.end(), [&](idx_t a, idx_t b) {
+        return paths[formats[0].sel->get_index(a)] < paths[formats[0].sel->get_index(b)];
+    });
+
+    // List entries are appended in file order, each pointing at its own row
+    const ASTResult *tree = nullptr;
+    string_t current_path;
+    vector<idx_t> chain;
+    for (auto row : rows) {
+        auto path = paths[formats[0].sel->get_index(row)];
+        if (!tree || path != current_path) {
+            tree = &local_state.GetTree(context, path.GetString());
+            current_path = path;
+        }
+        ASTSourceRange range;
+        range.start_line = position(1, row);
+        range.start_column = position(2, row);
+        if (is_range) {
+            range.end_line = position(3, row);
+            range.end_column = position(4, row);
+        } else {
+            // A point covers the character at that position
+            range.end_line = range.start_line;
+            range.end_column = range.start_column + 1;
+        }
+        FindNodeAt(tree->Nodes(), range, chain);
+        UnifiedASTBackend::ProjectToNodeList(*tree, chain, result, row);
+    }
+    if (args.AllConstant()) {
+        result.SetVectorType(VectorType::CONSTANT_VECTOR);
+    }
+}
+
+void RegisterASTNodeAtFunctions(DatabaseInstance &instance) {
+    auto node_list = LogicalType::LIST(UnifiedASTBackend::GetASTNodeStructSchema());
+    ScalarFunctionSet ast_node_at("ast_node_at");
+    ast_node_at.AddFunction(ScalarFunction({LogicalType::VARCHAR, LogicalType::BIGINT, LogicalType::BIGINT},
+                                           node_list, ASTNodeAtFunction, nullptr, nullptr, nullptr,
+                                           ASTNodeAtInitLocal));
+    ast_node_at.AddFunction(ScalarFunction({LogicalType::VARCHAR, LogicalType::BIGINT, LogicalType::BIGINT,
+                                            LogicalType::BIGINT, LogicalType::BIGINT},
+                                           node_list, ASTNodeAtFunction, nullptr, nullptr, nullptr,
+                                           ASTNodeAtInitLocal));
+    for (auto &function : ast_node_at.functions) {
+        // Reads files, so results may change between queries
+        function.stability = FunctionStability::CONSISTENT_WITHIN_QUERY;
+    }
+    ExtensionUtil::RegisterFunction(instance, ast_node_at);
+}
+
+} // namespace duckdb
@@ -0,0 +1,434 @@
+#include "ast_parse_cache.hpp"
+#include "ast_file_utils.hpp"
+#include "ast_disk_cache.hpp"
+#include "duckdb/common/exception.hpp"
+#include "duckdb/common/file_system.hpp"
+#include "duckdb/common/types/hash.hpp"
+#include "duckdb/main/config.hpp"
+#include "duckdb/main/extension_util.hpp"
+#include "duckdb/storage/buffer_manager.hpp"
+#include "duckdb/storage/buffer/buffer_pool.hpp"
+
+namespace duckdb {
+
+//==============================================================================
+// Cache key
+//==============================================================================
+
+string ASTParseCacheKey::ToString() const {
+    // NUL separators cannot appear in paths, languages or fingerprints
+    string result = file_path;
+    result += '\0';
+    result += std::to_string(file_size);
+    result += '\0';
+    result += content_hash ? "h" + std::to_string(content_hash) : "m" + std::to_string(last_modified);
+    result += '\0';
+    result += language;
+    result += '\0';
+    result += config;
+    return result;
+}
+
+string ASTParseCacheKey::Identity() const {
+    string result = file_path;
+    result += '\0';
+    result += language;
+    result += '\0';
+    result += config;
+    return result;
+}
+
+//==============================================================================
+// ASTParseCache
+//==============================================================================
+
+ASTParseCache::ASTParseCache(DatabaseInstance &db, idx_t budget_p)
+    : reservation(MemoryTag::EXTENSION, BufferManager::GetBufferManager(db).GetBufferPool()),
+      max_memory(BufferManager::GetBufferManager(db).GetMaxMemory()), budget(MinValue(budget_p, max_memory)),
+      verify_content(false), bytes_held(0), hits(0), misses(0), insertions(0), evictions(0), disk_hits(0),
+      disk_writes(0) {
+}
+
+ASTParseCache::~ASTParseCache() {
+    // Hand the accounted memory back to the buffer pool
+    std::lock_guard<std::mutex> guard(lock);
+    reservation.Resize(0);
+}
+
+string ASTParseCache::ObjectType() {
+    return "sitting_duck_parse_cache";
+}
+
+string ASTParseCache::GetObjectType() {
+    return ObjectType();
+}
+
+shared_ptr<ASTParseCache> ASTParseCache::Get(ClientContext &context) {
+    auto &cache = ObjectCache::GetObjectCache(context);
+    auto &db = DatabaseInstance::GetDatabase(context);
+    return cache.GetOrCreate<ASTParseCache>(ObjectType(), db, DBConfig::ParseMemoryLimit(DEFAULT_CACHE_SIZE));
+}
+
+bool ASTParseCache::IsEnabled() const {
+    std::lock_guard<std::mutex> guard(lock);
+    return budget > 0;
+}
+
+bool ASTParseCache::VerifyContent() const {
+    std::lock_guard<std::mutex> guard(lock);
+    return verify_content;
+}
+
+string ASTParseCache::CacheDirectory() const {
+    std::lock_guard<std::mutex> guard(lock);
+    return cache_directory;
+}
+
+void ASTParseCache::SetBudget(idx_t new_budget) {
+    std::lock_guard<std::mutex> guard(lock);
+    budget = MinValue(new_budget, max_memory);
+    EvictToBudget();
+}
+
+void ASTParseCache::SetVerifyContent(bool verify) {
+    std::lock_guard<std::mutex> guard(lock);
+    verify_content = verify;
+}
+
+void ASTParseCache::SetCacheDirectory(const string &directory) {
+    std::lock_guard<std::mutex> guard(lock);
+    cache_directory = directory;
+}
+
+shared_ptr<const ASTResult> ASTParseCache::Lookup(const string &key) {
+    std::lock_guard<std::mutex> guard(lock);
+    auto entry = index.find(key);
+    if (entry == index.end()) {
+        misses++;
+        return nullptr;
+    }
+    // Move to the front of the LRU list
+    lru.splice(lru.begin(), lru, entry->second);
+    hits++;
+    return entry->second->result;
+}
+
+void ASTParseCache::Insert(const string &key, shared_ptr<const ASTResult> result) {
+    auto size = EstimateMemoryUsage(*result) + key.size();
+
+    std::lock_guard<std::mutex> guard(lock);
+    if (size > budget) {
+        // Never let a single oversized file flush the whole cache
+        return;
+    }
+    auto existing = index.find(key);
+    if (existing != index.end()) {
+        // Another thread parsed the same file concurrently
+        bytes_held -= existing->second->size;
+        lru.erase(existing->second);
+        index.erase(existing);
+    }
+    lru.push_front(CacheEntry {key, std::move(result), size});
+    index[key] = lru.begin();
+    bytes_held += size;
+    insertions++;
+    EvictToBudget();
+}
+
+void ASTParseCache::EvictToBudget() {
+    while (bytes_held > budget && !lru.empty()) {
+        auto &victim = lru.back();
+        bytes_held -= victim.size;
+        index.erase(victim.key);
+        lru.pop_back();
+        evictions++;
+    }
+    reservation.Resize(bytes_held);
+}
+
+ASTParseCacheStats ASTParseCache::GetStats() {
+    std::lock_guard<std::mutex> guard(lock);
+    ASTParseCacheStats stats;
+    stats.entries = lru.size();
+    stats.bytes_held = bytes_held;
+    stats.budget = budget;
+    stats.hits = hits;
+    stats.misses = misses;
+    stats.insertions = insertions;
+    stats.evictions = evictions;
+    stats.disk_hits = disk_hits.load();
+    stats.disk_writes = disk_writes.load();
+    return stats;
+}
+
+idx_t ASTParseCache::EstimateMemoryUsage(const ASTResult &result) {
+    idx_t total = sizeof(ASTResult) + result.source.file_path.size() + result.source.language.size();
+    for (const auto &node : result.nodes) {
+        total += sizeof(ASTNode);
+        total += node.source.file_path.size() + node.source.language.size();
+        total += node.context.name.size() + node.peek.size();
+        total += node.type.raw.size() + node.type.normalized.size() + node.type.kind.size();
+        total += node.name.raw.size() + node.name.qualified.size();
+
+        const auto &native = node.context.native;
+        total += native.signature_type.size() + native.qualified_name.size() + native.annotations.size();
+        for (const auto &param : native.parameters) {
+            total += sizeof(ParameterInfo) + param.name.size() + param.type.size() + param.default_value.size() +
+                     param.annotations.size();
+        }
+        for (const auto &modifier : native.modifiers) {
+            total += sizeof(string) + modifier.size();
+        }
+    }
+    return total;
+}
+
+shared_ptr<const ASTResult> ASTParseCache::ParseFile(ClientContext &context, const string &file_path,
+                                                     const string &language, const ExtractionConfig &config,
+                                                     const std::function<ASTResult(const string &content)> &parse,
+                                                     const string *content) {
+    auto &fs = FileSystem::GetFileSystem(context);
+    auto handle = fs.OpenFile(file_path, FileFlags::FILE_FLAGS_READ);
+    auto file_size = fs.GetFileSize(*handle);
+
+    auto cache = Get(context);
+    auto use_memory = cache->IsEnabled();
+    auto cache_dir = cache->CacheDirectory();
+    // Line-scoped extractions are partial trees whose node ids are not their positions,
+    // which the disk format relies on; they are also cheap to redo, so never cache them
+    if ((!use_memory && cache_dir.empty()) || !config.line_ranges.empty()) {
+        return make_shared_ptr<ASTResult>(parse(content ? *content
+                                                        : ASTFileUtils::ReadFileContent(fs, *handle, file_size)));
+    }
+
+    ASTParseCacheKey key;
+    key.file_path = file_path;
+    key.file_size = file_size;
+    key.last_modified = fs.GetLastModifiedTime(*handle).value;
+    key.language = language;
+    key.config = config.GetFingerprint();
+
+    // The content is read lazily: hits keyed on mtime never touch the source file
+    string read_content;
+    auto load_content = [&]() -> const string & {
+        if (!content) {
+            read_content = ASTFileUtils::ReadFileContent(fs, *handle, file_size);
+            content = &read_content;
+        }
+        return *content;
+    };
+
+    string key_string;
+    if (use_memory) {
+        // With content verification the file has to be read before we know whether it is a hit,
+        // but a touched-yet-identical file (git checkout, build tools) still hits.
+        if (cache->VerifyContent()) {
+            const auto &data = load_content();
+            key.content_hash = Hash(data.c_str(), data.size());
+        }
+        key_string = key.ToString();
+        auto cached = cache->Lookup(key_string);
+        if (cached) {
+            return cached;
+        }
+    }
+
+    if (!cache_dir.empty()) {
+        ASTResult loaded;
+        if (ASTDiskCache::TryLoad(fs, cache_dir, key.Identity(), file_size, key.last_modified, load_content, loaded)) {
+            cache->disk_hits++;
+            shared_ptr<const ASTResult> result = make_shared_ptr<ASTResult>(std::move(loaded));
+            if (use_memory) {
+                cache->Insert(key_string, result);
+            }
+            return result;
+        }
+    }
+
+    shared_ptr<const ASTResult> result = make_shared_ptr<ASTResult>(parse(load_content()));
+    if (use_memory) {
+        cache->Insert(key_string, result);
+    }
+    if (!cache_dir.empty()) {
+        auto content_hash = Hash(content->c_str(), content->size());
+        if (ASTDiskCache::Save(fs, cache_dir, key.Identity(), file_size, key.last_modified, content_hash, *result)) {
+            cache->disk_writes++;
+        }
+    }
+    return result;
+}
+
+shared_ptr<const ASTResult> ASTParseCache::ParseFile(ClientContext &context, const string &file_path,
+                                                     const string &language, const ExtractionConfig &config) {
+    return ParseFile(context, file_path, language, config, [&](const string &content) {
+        return UnifiedASTBackend::ParseToASTResult(content, language, file_path, config);
+    });
+}
+
+//==============================================================================
+// ASTContentDedup
+//==============================================================================
+
+// FNV-1a, independent of DuckDB's Hash() that keys the table
+static uint64_t ContentCheckHash(const string &content) {
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    for (auto c : content) {
+        hash = (hash ^ uint8_t(c)) * 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+ASTResult ASTContentDedup::ParseFile(const string &file_path, const string &language, const string &content,
+                                     const std::function<shared_ptr<const ASTResult>()> &parse) {
+    auto key = language + ":" + std::to_string(content.size()) + ":" +
+               std::to_string(Hash(content.c_str(), content.size()));
+    auto check_hash = ContentCheckHash(content);
+    shared_ptr<const Entry> original;
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        auto entry = results.find(key);
+        if (entry != results.end()) {
+            original = entry->second.lock();
+        }
+    }
+    if (original && original->check_hash != check_hash) {
+        // Same key, different bytes: parse this file on its own
+        original = nullptr;
+    } else if (!original) {
+        // Parsed outside the lock; when two threads race on the same content the first
+        // insert wins and the other parse is dropped, so all copies still share one result
+        auto parsed = make_shared_ptr<Entry>();
+        parsed->check_hash = check_hash;
+        parsed->result = parse();
+        std::lock_guard<std::mutex> guard(lock);
+        auto &slot = results[key];
+        auto existing = slot.lock();
+        if (existing && existing->check_hash == check_hash) {
+            original = std::move(existing);
+        } else {
+            if (!existing) {
+                slot = parsed;
+            }
+            original = std::move(parsed);
+        }
+        if (results.size() >= prune_size) {
+            for (auto it = results.begin(); it != results.end();) {
+                it = it->second.expired() ? results.erase(it) : std::next(it);
+            }
+            prune_size = MaxValue<idx_t>(1024, results.size() * 2);
+        }
+    }
+    if (!original) {
+        auto result = ASTResult::Share(parse());
+        result.source.file_path = file_path;
+        return result;
+    }
+
+    // Even the first file is returned as a stub, so its nodes are never copied. The
+    // stub owns the entry, which keeps the table's reference alive while it is in use.
+    auto parsed = original->result.get();
+    auto result = ASTResult::Share(shared_ptr<const ASTResult>(std::move(original), parsed));
+    result.source.file_path = file_path;
+    return result;
+}
+
+//==============================================================================
+// Settings
+//==============================================================================
+
+// The cache belongs to the database instance, so its settings cannot be scoped
+// to a session; they are registered with a GLOBAL default scope
+static void CheckGlobalScope(const string &name, SetScope scope) {
+    if (scope == SetScope::SESSION || scope == SetScope::LOCAL) {
+        throw InvalidInputException("%s applies to the whole database and can only be set globally", name);
+    }
+}
+
+static void SetCacheSizeCallback(ClientContext &context, SetScope scope, Value &parameter) {
+    CheckGlobalScope("sitting_duck_cache_size", scope);
+    auto budget = DBConfig::ParseMemoryLimit(parameter.ToString());
+    ASTParseCache::Get(context)->SetBudget(budget);
+}
+
+static void SetCacheDirCallback(ClientContext &context, SetScope scope, Value &parameter) {
+    CheckGlobalScope("sitting_duck_cache_dir", scope);
+    auto directory = parameter.IsNull() ? string() : parameter.ToString();
+    if (!directory.empty()) {
+        auto &fs = FileSystem::GetFileSystem(context);
+        if (!fs.DirectoryExists(directory)) {
+            fs.CreateDirectory(directory);
+        }
+    }
+    ASTParseCache::Get(context)->SetCacheDirectory(directory);
+}
+
+static void SetCacheVerifyCallback(ClientContext &context, SetScope scope, Value &parameter) {
+    CheckGlobalScope("sitting_duck_cache_verify_content", scope);
+    ASTParseCache::Get(context)->SetVerifyContent(BooleanValue::Get(parameter));
+}
+
+//==============================================================================
+// sitting_duck_cache_stats()
+//==============================================================================
+
+struct CacheStatsData : public GlobalTableFunctionState {
+    CacheStatsData() : finished(false) {}
+    bool finished;
+};
+
+static unique_ptr<FunctionData> CacheStatsBind(ClientContext &context, TableFunctionBindInput &input,
+                                               vector<LogicalType> &return_types, vector<string> &names) {
+    names = {"entries",  "bytes_held", "budget",    "hits",      "misses",
+             "hit_rate", "insertions", "evictions", "disk_hits", "disk_writes"};
+    return_types = {LogicalType::BIGINT, LogicalType::BIGINT, LogicalType::BIGINT, LogicalType::BIGINT,
+                    LogicalType::BIGINT, LogicalType::DOUBLE, LogicalType::BIGINT, LogicalType::BIGINT,
+                    LogicalType::BIGINT, LogicalType::BIGINT};
+    return nullptr;
+}
+
+static unique_ptr<GlobalTableFunctionState> CacheStatsInit(ClientContext &context, TableFunctionInitInput &input) {
+    return make_uniq<CacheStatsData>();
+}
+
+static void CacheStatsFunction(ClientContext &context, TableFunctionInput &data_p, DataChunk &output) {
+    auto &data = data_p.global_state->Cast<CacheStatsData>();
+    if (data.finished) {
+        output.SetCardinality(0);
+        return;
+    }
+    auto stats = ASTParseCache::Get(context)->GetStats();
+    auto lookups = stats.hits + stats.misses;
+
+    output.SetValue(0, 0, Value::BIGINT(NumericCast<int64_t>(stats.entries)));
+    output.SetValue(1, 0, Value::BIGINT(NumericCast<int64_t>(stats.bytes_held)));
+    output.SetValue(2, 0, Value::BIGINT(NumericCast<int64_t>(stats.budget)));
+    output.SetValue(3, 0, Value::BIGINT(NumericCast<int64_t>(stats.hits)));
+    output.SetValue(4, 0, Value::BIGINT(NumericCast<int64_t>(stats.misses)));
+    output.SetValue(5, 0, Value::DOUBLE(lookups == 0 ? 0.0 : double(stats.hits) / double(lookups)));
+    output.SetValue(6, 0, Value::BIGINT(NumericCast<int64_t>(stats.insertions)));
+    output.SetValue(7, 0, Value::BIGINT(NumericCast<int64_t>(stats.evictions)));
+    output.SetValue(8, 0, Value::BIGINT(NumericCast<int64_t>(stats.disk_hits)));
+    output.SetValue(9, 0, Value::BIGINT(NumericCast<int64_t>(stats.disk_writes)));
+    output.SetCardinality(1);
+    data.finished = true;
+}
+
+void ASTParseCache::Register(DatabaseInstance &instance) {
+    auto &config = DBConfig::GetConfig(instance);
+    config.AddExtensionOption("sitting_duck_cache_size",
+                              "Memory budget of the shared parse cache used by read_ast (e.g. '256MB'); 0 disables it",
+                              LogicalType::VARCHAR, Value(DEFAULT_CACHE_SIZE), SetCacheSizeCallback,
+                              SetScope::GLOBAL);
+    config.AddExtensionOption("sitting_duck_cache_dir",
+                              "Directory for the persistent on-disk parse cache; empty disables it",
+                              LogicalType::VARCHAR, Value(""), SetCacheDirCallback, SetScope::GLOBAL);
+    config.AddExtensionOption("sitting_duck_cache_verify_content",
+                              "Key the parse cache on a content hash instead of the modification time",
+                              LogicalType::BOOLEAN, Value::BOOLEAN(false), SetCacheVerifyCallback,
+                              SetScope::GLOBAL);
+
+    TableFunction stats_function("sitting_duck_cache_stats", {}, CacheStatsFunction, CacheStatsBind, CacheStatsInit);
+    ExtensionUtil::RegisterFunction(instance, stats_function);
+}
+
+} // namespace duckdb
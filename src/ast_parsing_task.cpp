@@ -1,8 +1,15 @@
 #include "ast_parsing_task.hpp"
+#include "ast_parse_cache.hpp"
 #include "language_adapter.hpp"
 #include "unified_ast_backend_impl.hpp"
 #include "duckdb/common/exception.hpp"
 #include "duckdb/common/file_system.hpp"
+#include "duckdb/parallel/task_scheduler.hpp"
+#include "ast_file_utils.hpp"
+#include "ast_file_discovery.hpp"
+#include "ast_tar_archive.hpp"
+#include <algorithm>
+#include <unordered_set>
 
 namespace duckdb {
 
@@ -22,19 +29,122 @@ void ASTParsingTask::ExecuteTask() {
     }
 }
 
+// Count a finished file and store its result in the calling thread's buffer
+static void StoreResult(ASTParsingState &parsing_state, ASTResult result, idx_t thread_id) {
+    // Update progress atomically (before moving the result)
+    parsing_state.files_processed.fetch_add(1);
+    parsing_state.total_nodes.fetch_add(result.Nodes().size());
+    
+    // Store result in per-thread buffer (no mutex needed!)
+    parsing_state.per_thread_results[thread_id].push_back(std::move(result));
+}
+
+// Result of a file the screen rejected: no nodes, and the reason as its status
+static ASTResult SkippedResult(const string &file_path, const string &file_language, string skip_reason) {
+    ASTResult skipped;
+    skipped.source.file_path = file_path;
+    skipped.source.language = file_language;
+    skipped.status = std::move(skip_reason);
+    return skipped;
+}
+
+// Parse one file with its language's adapter (through the shared parse cache)
+// and store the result in the calling thread's buffer
+static void ParseFileWithAdapter(ASTParsingState &parsing_state, const LanguageAdapter *adapter,
+                                 const string &file_path, const string &file_language, idx_t thread_id) {
+    // Binary, minified, generated and oversized files are skipped on their first few KB
+    if (parsing_state.screen) {
+        auto skip_reason = parsing_state.screen->Check(parsing_state.context, file_path);
+        if (!skip_reason.empty()) {
+            StoreResult(parsing_state, SkippedResult(file_path, file_language, std::move(skip_reason)), thread_id);
+            return;
+        }
+    }
+    
+    // Prefilter on the raw bytes, and hash them for dedup. The parse cache is then handed
+    // the same bytes, so the file is read once either way.
+    string raw_content;
+    const string *known_content = nullptr;
+    if (parsing_state.content_filter || parsing_state.dedup) {
+        raw_content = ASTFileUtils::ReadFile(parsing_state.context, file_path);
+        known_content = &raw_content;
+    }
+    if (parsing_state.content_filter && !parsing_state.content_filter->Matches(raw_content)) {
+        parsing_state.files_processed.fetch_add(1);
+        parsing_state.files_filtered.fetch_add(1);
+        return;
+    }
+    
+    // CRITICAL: Use adapter's parsing function which creates fresh parsers
+    // This ensures thread safety by avoiding shared parser state
+    ParsingFunction parsing_fn = adapter->GetParsingFunction();
+    
+    // Read the file through DuckDB's thread-safe file system; unchanged files are
+    // served from the shared parse cache and skip the parsing function entirely
+    auto parse_file = [&]() {
+        return ASTParseCache::ParseFile(parsing_state.context, file_path, file_language, parsing_state.config,
+                                        [&](const string &content) {
+            if (parsing_state.config.hashes || !parsing_state.config.line_ranges.empty() ||
+                parsing_state.config.max_nodes > 0) {
+                // The adapters' parsing functions only take the legacy peek options
+                return UnifiedASTBackend::ParseToASTResult(content, file_language, file_path, parsing_state.config);
+            }
+            // Call the parsing function with the adapter as context
+            return parsing_fn(adapter, content, file_language, file_path,
+                              parsing_state.peek_size, parsing_state.peek_mode);
+        }, known_content);
+    };
+    StoreResult(parsing_state,
+                parsing_state.dedup ? parsing_state.dedup->ParseFile(file_path, file_language, raw_content, parse_file)
+                                    : ASTResult::Share(parse_file()),
+                thread_id);
+}
+
+// Parse a file that is already in memory (an archive member). There is no file
+// version to key the parse cache on, so it is always parsed.
+static void ParseFileContent(ASTParsingState &parsing_state, const string &file_path, const string &file_language,
+                         const string &content, idx_t thread_id) {
+    if (parsing_state.screen) {
+        auto skip_reason = parsing_state.screen->CheckContent(file_path, content);
+        if (!skip_reason.empty()) {
+            StoreResult(parsing_state, SkippedResult(file_path, file_language, std::move(skip_reason)), thread_id);
+            return;
+        }
+    }
+    if (parsing_state.content_filter && !parsing_state.content_filter->Matches(content)) {
+        parsing_state.files_processed.fetch_add(1);
+        parsing_state.files_filtered.fetch_add(1);
+        return;
+    }
+    auto parse_content = [&]() {
+        return UnifiedASTBackend::ParseToASTResult(content, file_language, file_path, parsing_state.config);
+    };
+    if (parsing_state.dedup) {
+        auto parse_shared = [&]() -> shared_ptr<const ASTResult> { return make_shared_ptr<ASTResult>(parse_content()); };
+        StoreResult(parsing_state, parsing_state.dedup->ParseFile(file_path, file_language, content, parse_shared),
+                    thread_id);
+    } else {
+        StoreResult(parsing_state, parse_content(), thread_id);
+    }
+}
+
+// Record a failed file when ignore_errors is set; rethrow otherwise to stop all tasks
+static void HandleParseError(ASTParsingState &parsing_state, const string &file_path, const Exception &e) {
+    parsing_state.errors_encountered.fetch_add(1);
+    if (!parsing_state.ignore_errors) {
+        throw;
+    }
+    {
+        std::lock_guard<std::mutex> lock(parsing_state.errors_mutex);
+        parsing_state.error_messages.push_back("Error processing file " + file_path + ": " + string(e.what()));
+    }
+    // Continue processing other files
+    parsing_state.files_processed.fetch_add(1);
+}
+
 void ASTParsingTask::ProcessSingleFile(idx_t file_idx) {
+    const auto& file_path = parsing_state.file_paths[file_idx];
     try {
-        const auto& file_path = parsing_state.file_paths[file_idx];
-        
-        // Read file content using DuckDB's thread-safe file system
-        auto &fs = FileSystem::GetFileSystem(parsing_state.context);
-        auto handle = fs.OpenFile(file_path, FileFlags::FILE_FLAGS_READ);
-        auto file_size = fs.GetFileSize(*handle);
-        
-        string content;
-        content.resize(file_size);
-        fs.Read(*handle, (void*)content.data(), file_size);
-        
         // Get language for this specific file
         const auto& file_language = parsing_state.languages[file_idx];
         
@@ -63,42 +173,415 @@ void ASTParsingTask::ProcessSingleFile(idx_t file_idx) {
             throw InvalidInputException("Unsupported language: " + file_language);
         }
         
-        // CRITICAL: Use adapter's parsing function which creates fresh parsers
-        // This ensures thread safety by avoiding shared parser state
-        ParsingFunction parsing_fn = adapter->GetParsingFunction();
-        
-        // Call the parsing function with the adapter as context
-        ASTResult result = parsing_fn(adapter, content, file_language, file_path, 
-                                     parsing_state.peek_size, parsing_state.peek_mode);
-        
-        // Update progress atomically (before moving the result)
-        const idx_t node_count = result.nodes.size();
-        parsing_state.files_processed.fetch_add(1);
-        parsing_state.total_nodes.fetch_add(node_count);
-        
-        // Store result in per-thread buffer (no mutex needed!)
-        parsing_state.per_thread_results[thread_id].push_back(std::move(result));
+        ParseFileWithAdapter(parsing_state, adapter, file_path, file_language, thread_id);
         
     } catch (const Exception &e) {
         // Handle errors based on ignore_errors flag
-        parsing_state.errors_encountered.fetch_add(1);
+        HandleParseError(parsing_state, file_path, e);
+    }
+}
+
+void ResolveFileLanguages(const vector<string> &file_paths, const string &language, bool ignore_errors,
+                          vector<string> &languages,
+                          unordered_map<string, unique_ptr<LanguageAdapter>> &adapters) {
+    // Pre-resolve languages for all files to avoid repeated work
+    languages.clear();
+    languages.reserve(file_paths.size());
+    std::unordered_set<string> unique_languages;
+    
+    for (const auto& file_path : file_paths) {
+        string file_language = language;
+        if (language == "auto" || language.empty()) {
+            file_language = ASTFileUtils::DetectLanguageFromPath(file_path);
+            if (file_language == "auto") {
+                if (!ignore_errors) {
+                    throw BinderException("Could not detect language for file: " + file_path);
+                }
+                file_language = "unknown"; // Will be skipped during processing
+            }
+        }
+        languages.push_back(file_language);
+        if (file_language != "unknown") {
+            unique_languages.insert(file_language);
+        }
+    }
+    
+    // PRE-CREATE ALL NEEDED ADAPTERS (eliminates singleton contention)
+    auto& registry = LanguageAdapterRegistry::GetInstance();
+    for (const auto& file_language : unique_languages) {
+        if (adapters.find(file_language) != adapters.end()) {
+            continue;
+        }
+        auto adapter = registry.CreateAdapter(file_language);
+        if (adapter) {
+            adapters[file_language] = std::move(adapter);
+        } else if (!ignore_errors) {
+            throw InvalidInputException("Unsupported language: " + file_language);
+        }
+    }
+}
+
+vector<ASTResult> ParseFilesParallel(ClientContext &context, const vector<string> &file_paths,
+                                     const vector<string> &languages, bool ignore_errors,
+                                     int32_t peek_size, const string &peek_mode,
+                                     const unordered_map<string, unique_ptr<LanguageAdapter>> &adapters,
+                                     bool hashes, const vector<pair<uint32_t, uint32_t>> &line_ranges,
+                                     const ASTContentFilter *content_filter, ASTContentDedup *dedup,
+                                     const ASTFileScreen *screen) {
+    if (file_paths.empty()) {
+        return vector<ASTResult>();
+    }
+    const auto num_threads = NumericCast<idx_t>(TaskScheduler::GetScheduler(context).NumberOfThreads());
+    const auto files_per_task = MaxValue<idx_t>((file_paths.size() + num_threads - 1) / num_threads, 1);
+    const auto num_tasks = (file_paths.size() + files_per_task - 1) / files_per_task;
+    
+    // Create parsing state for ALL files at once
+    ASTParsingState parsing_state(context, file_paths, languages, ignore_errors, peek_size, peek_mode,
+                                  adapters, num_tasks, hashes, line_ranges, screen ? screen->max_nodes : 0);
+    parsing_state.content_filter = content_filter;
+    parsing_state.dedup = dedup;
+    parsing_state.screen = screen;
+    
+    // Create tasks - let DuckDB's scheduler handle the distribution
+    TaskExecutor executor(context);
+    for (idx_t task_idx = 0; task_idx < num_tasks; task_idx++) {
+        const auto file_idx_start = task_idx * files_per_task;
+        const auto file_idx_end = MinValue<idx_t>(file_idx_start + files_per_task, file_paths.size());
         
-        if (parsing_state.ignore_errors) {
-            // Store error message for later reporting
-            {
-                std::lock_guard<std::mutex> lock(parsing_state.errors_mutex);
-                parsing_state.error_messages.push_back(
-                    "Error processing file " + parsing_state.file_paths[file_idx] + ": " + string(e.what())
-                );
+        auto task = make_uniq<ASTParsingTask>(executor, parsing_state, file_idx_start, file_idx_end, task_idx);
+        executor.ScheduleTask(std::move(task));
+    }
+    
+    // Let DuckDB handle all the parallel work
+    executor.WorkOnTasks();
+    
+    // Per-thread buffers are indexed by task, so collecting them keeps file order
+    parsing_state.CollectResults();
+    return std::move(parsing_state.results);
+}
+
+// Adapters created on first use, for languages that only show up during the walk
+struct ASTDiscoveredAdapters {
+    mutex lock;
+    unordered_map<string, unique_ptr<LanguageAdapter>> adapters;
+
+    const LanguageAdapter *Get(const string &language) {
+        std::lock_guard<std::mutex> guard(lock);
+        auto &adapter = adapters[language];
+        if (!adapter) {
+            adapter = LanguageAdapterRegistry::GetInstance().CreateAdapter(language);
+        }
+        return adapter.get();
+    }
+};
+
+// Worker of DiscoverAndParseFilesParallel: parses queued files first and lists a
+// directory only when no file is waiting, so parsing starts with the first file found
+class ASTDiscoverAndParseTask : public BaseExecutorTask {
+public:
+    ASTDiscoverAndParseTask(TaskExecutor &executor, ASTParsingState &parsing_state, ASTFileDiscovery &discovery,
+                            ASTDiscoveredAdapters &adapters, const string &language, idx_t thread_id)
+        : BaseExecutorTask(executor), parsing_state(parsing_state), discovery(discovery), adapters(adapters),
+          language(language), thread_id(thread_id) {
+    }
+
+    void ExecuteTask() override {
+        string file_path;
+        while (true) {
+            // Once the walk is finished no file can be added, so an empty queue means done
+            bool walk_finished = discovery.WalkFinished();
+            if (discovery.NextFile(file_path)) {
+                ProcessFile(file_path);
+            } else if (walk_finished) {
+                break;
+            } else if (!discovery.WalkDirectory()) {
+                discovery.WaitForWork(true);
+            }
+        }
+    }
+
+    string TaskType() const override {
+        return "ASTDiscoverAndParseTask";
+    }
+
+private:
+    void ProcessFile(const string &file_path) {
+        try {
+            string file_language = language;
+            if (file_language == "auto") {
+                file_language = ASTFileUtils::DetectLanguageFromPath(file_path);
+                if (file_language == "auto") {
+                    if (parsing_state.ignore_errors) {
+                        parsing_state.files_processed.fetch_add(1);
+                        return;
+                    }
+                    throw BinderException("Could not detect language for file: " + file_path);
+                }
             }
-            
-            // Continue processing other files
-            parsing_state.files_processed.fetch_add(1);
+            auto adapter = adapters.Get(file_language);
+            if (!adapter) {
+                throw InvalidInputException("Unsupported language: " + file_language);
+            }
+            ParseFileWithAdapter(parsing_state, adapter, file_path, file_language, thread_id);
+        } catch (const Exception &e) {
+            HandleParseError(parsing_state, file_path, e);
+        }
+    }
+
+    ASTParsingState &parsing_state;
+    ASTFileDiscovery &discovery;
+    ASTDiscoveredAdapters &adapters;
+    const string &language;
+    const idx_t thread_id;
+};
+
+vector<ASTResult> DiscoverAndParseFilesParallel(ClientContext &context, ASTFileDiscovery &discovery,
+                                                const string &language, bool ignore_errors, int32_t peek_size,
+                                                const string &peek_mode, bool ordered,
+                                                const vector<pair<uint32_t, uint32_t>> &line_ranges,
+                                                const ASTContentFilter *content_filter,
+                                                ASTContentDedup *dedup, const ASTFileScreen *screen) {
+    const auto num_tasks = NumericCast<idx_t>(TaskScheduler::GetScheduler(context).NumberOfThreads());
+    
+    // Files are not known up front; every task takes them from the discovery queue
+    const vector<string> no_files;
+    const unordered_map<string, unique_ptr<LanguageAdapter>> no_adapters;
+    ASTParsingState parsing_state(context, no_files, no_files, ignore_errors, peek_size, peek_mode, no_adapters,
+                                  num_tasks, false, line_ranges, screen ? screen->max_nodes : 0);
+    parsing_state.content_filter = content_filter;
+    parsing_state.dedup = dedup;
+    parsing_state.screen = screen;
+    ASTDiscoveredAdapters adapters;
+    
+    TaskExecutor executor(context);
+    for (idx_t task_idx = 0; task_idx < num_tasks; task_idx++) {
+        executor.ScheduleTask(
+            make_uniq<ASTDiscoverAndParseTask>(executor, parsing_state, discovery, adapters, language, task_idx));
+    }
+    executor.WorkOnTasks();
+    
+    parsing_state.CollectResults();
+    if (ordered) {
+        // Same order as ParseFilesParallel over ASTFileUtils::GetFiles (paths are unique)
+        std::sort(parsing_state.results.begin(), parsing_state.results.end(),
+                  [](const ASTResult &a, const ASTResult &b) { return a.source.file_path < b.source.file_path; });
+    }
+    return std::move(parsing_state.results);
+}
+
+// Worker of ParseArchivesParallel: takes the next member (reading or decompressing
+// it when its turn comes) and parses it from memory
+class ASTArchiveParseTask : public BaseExecutorTask {
+public:
+    ASTArchiveParseTask(TaskExecutor &executor, ASTParsingState &parsing_state, ASTTarArchives &archives,
+                        const string &language, idx_t thread_id)
+        : BaseExecutorTask(executor), parsing_state(parsing_state), archives(archives), language(language),
+          thread_id(thread_id) {
+    }
+
+    void ExecuteTask() override {
+        string file_path;
+        string content;
+        while (archives.Next(file_path, content)) {
+            try {
+                string file_language = language;
+                if (file_language == "auto") {
+                    file_language = ASTFileUtils::DetectLanguageFromPath(file_path);
+                    if (file_language == "auto") {
+                        throw BinderException("Could not detect language for file: " + file_path);
+                    }
+                }
+                ParseFileContent(parsing_state, file_path, file_language, content, thread_id);
+            } catch (const Exception &e) {
+                HandleParseError(parsing_state, file_path, e);
+            }
+        }
+    }
+
+    string TaskType() const override {
+        return "ASTArchiveParseTask";
+    }
+
+private:
+    ASTParsingState &parsing_state;
+    ASTTarArchives &archives;
+    const string &language;
+    const idx_t thread_id;
+};
+
+vector<ASTResult> ParseArchivesParallel(ClientContext &context, ASTTarArchives &archives, const string &language,
+                                        bool ignore_errors, int32_t peek_size, const string &peek_mode,
+                                        bool ordered, const vector<pair<uint32_t, uint32_t>> &line_ranges,
+                                        const ASTContentFilter *content_filter, ASTContentDedup *dedup,
+                                        const ASTFileScreen *screen) {
+    const auto num_tasks = NumericCast<idx_t>(TaskScheduler::GetScheduler(context).NumberOfThreads());
+    
+    const vector<string> no_files;
+    const unordered_map<string, unique_ptr<LanguageAdapter>> no_adapters;
+    ASTParsingState parsing_state(context, no_files, no_files, ignore_errors, peek_size, peek_mode, no_adapters,
+                                  num_tasks, false, line_ranges, screen ? screen->max_nodes : 0);
+    parsing_state.content_filter = content_filter;
+    parsing_state.dedup = dedup;
+    parsing_state.screen = screen;
+    
+    TaskExecutor executor(context);
+    for (idx_t task_idx = 0; task_idx < num_tasks; task_idx++) {
+        executor.ScheduleTask(make_uniq<ASTArchiveParseTask>(executor, parsing_state, archives, language, task_idx));
+    }
+    executor.WorkOnTasks();
+    
+    parsing_state.CollectResults();
+    if (ordered) {
+        std::sort(parsing_state.results.begin(), parsing_state.results.end(),
+                  [](const ASTResult &a, const ASTResult &b) { return a.source.file_path < b.source.file_path; });
+    }
+    return std::move(parsing_state.results);
+}
+
+// Worker of ParseContentsParallel: parses a contiguous range of the in-memory sources
+class ASTContentParseTask : public BaseExecutorTask {
+public:
+    ASTContentParseTask(TaskExecutor &executor, ASTParsingState &parsing_state, const vector<string> &contents,
+                        idx_t start, idx_t end, idx_t thread_id)
+        : BaseExecutorTask(executor), parsing_state(parsing_state), contents(contents), start(start), end(end),
+          thread_id(thread_id) {
+    }
+
+    void ExecuteTask() override {
+        for (idx_t idx = start; idx < end; idx++) {
+            const auto &file_path = parsing_state.file_paths[idx];
+            try {
+                string file_language = parsing_state.languages[idx];
+                if (file_language == "auto") {
+                    file_language = ASTFileUtils::DetectLanguageFromPath(file_path);
+                    if (file_language == "auto") {
+                        throw BinderException("Could not detect language for file: " + file_path);
+                    }
+                }
+                ParseFileContent(parsing_state, file_path, file_language, contents[idx], thread_id);
+            } catch (const Exception &e) {
+                HandleParseError(parsing_state, file_path, e);
+            }
+        }
+    }
+
+    string TaskType() const override {
+        return "ASTContentParseTask";
+    }
+
+private:
+    ASTParsingState &parsing_state;
+    const vector<string> &contents;
+    const idx_t start;
+    const idx_t end;
+    const idx_t thread_id;
+};
+
+vector<ASTResult> ParseContentsParallel(ClientContext &context, const vector<string> &file_paths,
+                                        const vector<string> &languages, const vector<string> &contents,
+                                        bool ignore_errors, int32_t peek_size, const string &peek_mode) {
+    if (file_paths.empty()) {
+        return vector<ASTResult>();
+    }
+    const auto num_threads = NumericCast<idx_t>(TaskScheduler::GetScheduler(context).NumberOfThreads());
+    const auto sources_per_task = MaxValue<idx_t>((file_paths.size() + num_threads - 1) / num_threads, 1);
+    const auto num_tasks = (file_paths.size() + sources_per_task - 1) / sources_per_task;
+    
+    const unordered_map<string, unique_ptr<LanguageAdapter>> no_adapters;
+    ASTParsingState parsing_state(context, file_paths, languages, ignore_errors, peek_size, peek_mode, no_adapters,
+                                  num_tasks);
+    
+    TaskExecutor executor(context);
+    for (idx_t task_idx = 0; task_idx < num_tasks; task_idx++) {
+        const auto start = task_idx * sources_per_task;
+        const auto end = MinValue<idx_t>(start + sources_per_task, file_paths.size());
+        executor.ScheduleTask(make_uniq<ASTContentParseTask>(executor, parsing_state, contents, start, end, task_idx));
+    }
+    executor.WorkOnTasks();
+    
+    // Per-thread buffers are indexed by task, so collecting them keeps the input order
+    parsing_state.CollectResults();
+    return std::move(parsing_state.results);
+}
+
+void ASTFileBindData::Bind(ClientContext &context, TableFunctionBindInput &input, const string &function_name) {
+    auto &patterns = input.inputs[0];
+    if (patterns.IsNull()) {
+        throw BinderException(function_name + ": file patterns cannot be NULL");
+    }
+    if (input.inputs.size() > 1) {
+        if (input.inputs[1].IsNull()) {
+            throw BinderException(function_name + ": language cannot be NULL");
+        }
+        language = input.inputs[1].GetValue<string>();
+    }
+    for (auto &kv : input.named_parameters) {
+        if (kv.first == "ignore_errors") {
+            ignore_errors = BooleanValue::Get(kv.second);
+        } else if (kv.first == "peek_size") {
+            peek_size = IntegerValue::Get(kv.second);
+        } else if (kv.first == "peek_mode") {
+            peek_mode = StringValue::Get(kv.second);
         } else {
-            // Re-throw to stop all tasks
-            throw;
+            screen.SetOption(kv.first, kv.second);
+        }
+    }
+
+    vector<string> supported_extensions;
+    if (language != "auto") {
+        supported_extensions = ASTFileUtils::GetSupportedExtensions(language);
+    }
+    file_paths = ASTFileUtils::GetFiles(context, patterns, ignore_errors, supported_extensions);
+}
+
+void ASTFileBindData::ResolveLanguages() {
+    unordered_map<string, unique_ptr<LanguageAdapter>> adapters;
+    ResolveFileLanguages(file_paths, language, ignore_errors, languages, adapters);
+}
+
+shared_ptr<const ASTResult> ASTFileBindData::ParseFile(ClientContext &context, idx_t file_idx) const {
+    const auto &file_path = file_paths[file_idx];
+    const auto &file_language = languages[file_idx];
+    if (file_language == "unknown") {
+        return nullptr;
+    }
+    try {
+        auto config = ASTParsingState::MakeConfig(peek_size, peek_mode, hashes, {}, 0);
+        return ASTParseCache::ParseFile(context, file_path, file_language, config);
+    } catch (const Exception &e) {
+        if (ignore_errors) {
+            return nullptr;
+        }
+        throw IOException("Error processing file " + file_path + ": " + string(e.what()));
+    }
+}
+
+ASTFileParseState::ASTFileParseState() {
+}
+
+ASTFileParseState::~ASTFileParseState() {
+}
+
+void ASTFileParseState::Initialize(const ASTFileBindData &bind_data) {
+    ResolveFileLanguages(bind_data.file_paths, bind_data.language, bind_data.ignore_errors, languages, adapters);
+}
+
+ASTResult *ASTFileParseState::Next(ClientContext &context, const ASTFileBindData &bind_data) {
+    while (batch_offset >= batch.size()) {
+        if (next_file >= bind_data.file_paths.size()) {
+            return nullptr;
         }
+        // Parse the next vector's worth of files in parallel
+        auto batch_end = MinValue<idx_t>(next_file + STANDARD_VECTOR_SIZE, bind_data.file_paths.size());
+        vector<string> batch_files(bind_data.file_paths.begin() + next_file, bind_data.file_paths.begin() + batch_end);
+        vector<string> batch_languages(languages.begin() + next_file, languages.begin() + batch_end);
+        batch = ParseFilesParallel(context, batch_files, batch_languages, bind_data.ignore_errors,
+                                   bind_data.peek_size, bind_data.peek_mode, adapters, bind_data.hashes, {},
+                                   nullptr, nullptr, bind_data.screen.IsActive() ? &bind_data.screen : nullptr);
+        batch_offset = 0;
+        next_file = batch_end;
     }
+    return &batch[batch_offset++];
 }
 
-} // namespace duckdb
\ No newline at end of file
+} // namespace duckdb
@@ -0,0 +1,377 @@
+#include "duckdb.hpp"
+#include "duckdb/common/exception.hpp"
+#include "duckdb/function/table_function.hpp"
+#include "duckdb/main/extension_util.hpp"
+#include "ast_file_utils.hpp"
+#include "ast_parsing_task.hpp"
+#include "language_adapter.hpp"
+#include "tree_sitter_wrappers.hpp"
+#include "unified_ast_backend_impl.hpp"
+#include "re2/re2.h"
+
+namespace duckdb {
+
+//==============================================================================
+// ast_query(file_patterns, language, pattern)
+//==============================================================================
+//
+// Runs a tree-sitter query (S-expression pattern) over every file. The pattern
+// is compiled once per language with ts_query_new; each worker thread claims
+// files, parses them and walks the matches with its own TSQueryCursor. Only
+// the captures are emitted - no other node is ever materialized.
+//
+// Tree-sitter leaves predicates to the client; #eq?, #not-eq?, #match? and
+// #not-match? (against a capture or a string) are evaluated here.
+
+struct ASTQueryPredicate {
+    bool is_match = false;        // #match? (regex) instead of #eq?
+    bool negate = false;
+    uint32_t capture_id = 0;
+    bool compare_capture = false; // Second argument is a capture rather than a string
+    uint32_t other_capture_id = 0;
+    string value;
+    shared_ptr<duckdb_re2::RE2> regex;
+};
+
+// A query compiled for one language, plus the adapter used to parse its files
+struct ASTCompiledQuery {
+    unique_ptr<LanguageAdapter> adapter;
+    TSQueryPtr query;
+    vector<string> capture_names;
+    vector<vector<ASTQueryPredicate>> predicates; // Per pattern index
+};
+
+struct ASTQueryBindData : public TableFunctionData {
+    vector<string> file_paths;
+    vector<string> languages;
+    bool ignore_errors = false;
+    unordered_map<string, shared_ptr<ASTCompiledQuery>> queries;
+};
+
+struct ASTQueryCapture {
+    idx_t file_idx;
+    int64_t match_id;
+    uint32_t pattern_index;
+    uint32_t capture_id;
+    const char *type;     // Static grammar string
+    TSPoint start;
+    TSPoint end;
+    uint32_t start_byte;
+    uint32_t end_byte;
+    string text;
+};
+
+struct ASTQueryGlobalState : public GlobalTableFunctionState {
+    explicit ASTQueryGlobalState(idx_t file_count) : next_file(0), max_threads(MaxValue<idx_t>(file_count, 1)) {
+    }
+
+    idx_t MaxThreads() const override {
+        return max_threads;
+    }
+
+    atomic<idx_t> next_file;
+    const idx_t max_threads;
+};
+
+struct ASTQueryLocalState : public LocalTableFunctionState {
+    ASTQueryLocalState() : cursor(ts_query_cursor_new()) {
+    }
+
+    TSQueryCursorPtr cursor;
+    vector<ASTQueryCapture> captures;   // Captures of the file being emitted
+    idx_t offset = 0;
+};
+
+static string QueryErrorName(TSQueryError error) {
+    switch (error) {
+    case TSQueryErrorSyntax:
+        return "syntax error";
+    case TSQueryErrorNodeType:
+        return "unknown node type";
+    case TSQueryErrorField:
+        return "unknown field";
+    case TSQueryErrorCapture:
+        return "unknown capture";
+    case TSQueryErrorStructure:
+        return "impossible pattern structure";
+    case TSQueryErrorLanguage:
+        return "incompatible language";
+    default:
+        return "error";
+    }
+}
+
+static vector<ASTQueryPredicate> CompilePredicates(const TSQuery *query, uint32_t pattern_index) {
+    vector<ASTQueryPredicate> predicates;
+    uint32_t step_count;
+    auto steps = ts_query_predicates_for_pattern(query, pattern_index, &step_count);
+    auto step_string = [&](const TSQueryPredicateStep &step) {
+        uint32_t length;
+        auto value = ts_query_string_value_for_id(query, step.value_id, &length);
+        return string(value, length);
+    };
+
+    uint32_t begin = 0;
+    for (uint32_t i = 0; i < step_count; i++) {
+        if (steps[i].type != TSQueryPredicateStepTypeDone) {
+            continue;
+        }
+        // One predicate: name, capture, capture-or-string
+        auto argument_count = i - begin;
+        if (argument_count == 0 || steps[begin].type != TSQueryPredicateStepTypeString) {
+            throw BinderException("ast_query: malformed predicate in pattern %u", pattern_index);
+        }
+        auto name = step_string(steps[begin]);
+        ASTQueryPredicate predicate;
+        if (name == "eq?" || name == "not-eq?") {
+            predicate.negate = name == "not-eq?";
+        } else if (name == "match?" || name == "not-match?") {
+            predicate.is_match = true;
+            predicate.negate = name == "not-match?";
+        } else {
+            throw BinderException("ast_query: unsupported predicate #%s (supported: #eq?, #not-eq?, #match?, "
+                                  "#not-match?)",
+                                  name);
+        }
+        if (argument_count != 3 || steps[begin + 1].type != TSQueryPredicateStepTypeCapture) {
+            throw BinderException("ast_query: #%s expects a capture and a capture or string", name);
+        }
+        predicate.capture_id = steps[begin + 1].value_id;
+        auto &argument = steps[begin + 2];
+        if (argument.type == TSQueryPredicateStepTypeCapture) {
+            if (predicate.is_match) {
+                throw BinderException("ast_query: #%s expects a regular expression string", name);
+            }
+            predicate.compare_capture = true;
+            predicate.other_capture_id = argument.value_id;
+        } else {
+            predicate.value = step_string(argument);
+            if (predicate.is_match) {
+                duckdb_re2::RE2::Options options;
+                options.set_log_errors(false);
+                predicate.regex = make_shared_ptr<duckdb_re2::RE2>(predicate.value, options);
+                if (!predicate.regex->ok()) {
+                    throw BinderException("ast_query: invalid regular expression '%s': %s", predicate.value,
+                                          predicate.regex->error());
+                }
+            }
+        }
+        predicates.push_back(std::move(predicate));
+        begin = i + 1;
+    }
+    return predicates;
+}
+
+static shared_ptr<ASTCompiledQuery> CompileQuery(const string &language, unique_ptr<LanguageAdapter> adapter,
+                                                 const string &pattern) {
+    auto result = make_shared_ptr<ASTCompiledQuery>();
+    auto ts_language = ts_parser_language(adapter->GetParser());
+    uint32_t error_offset = 0;
+    TSQueryError error_type = TSQueryErrorNone;
+    result->query = TSQueryPtr(ts_query_new(ts_language, pattern.c_str(), NumericCast<uint32_t>(pattern.size()),
+                                            &error_offset, &error_type));
+    if (!result->query) {
+        throw BinderException("ast_query: %s in pattern for %s at offset %u: %s", QueryErrorName(error_type),
+                              language, error_offset, pattern.substr(error_offset, 40));
+    }
+    for (uint32_t i = 0; i < ts_query_capture_count(result->query.get()); i++) {
+        uint32_t length;
+        auto name = ts_query_capture_name_for_id(result->query.get(), i, &length);
+        result->capture_names.emplace_back(name, length);
+    }
+    for (uint32_t i = 0; i < ts_query_pattern_count(result->query.get()); i++) {
+        result->predicates.push_back(CompilePredicates(result->query.get(), i));
+    }
+    result->adapter = std::move(adapter);
+    return result;
+}
+
+static unique_ptr<FunctionData> ASTQueryBind(ClientContext &context, TableFunctionBindInput &input,
+                                             vector<LogicalType> &return_types, vector<string> &names) {
+    auto result = make_uniq<ASTQueryBindData>();
+
+    auto &patterns = input.inputs[0];
+    if (patterns.IsNull() || input.inputs[1].IsNull() || input.inputs[2].IsNull()) {
+        throw BinderException("ast_query: arguments cannot be NULL");
+    }
+    auto language = input.inputs[1].GetValue<string>();
+    auto pattern = input.inputs[2].GetValue<string>();
+    for (auto &kv : input.named_parameters) {
+        if (kv.first == "ignore_errors") {
+            result->ignore_errors = BooleanValue::Get(kv.second);
+        }
+    }
+
+    vector<string> supported_extensions;
+    if (language != "auto") {
+        supported_extensions = ASTFileUtils::GetSupportedExtensions(language);
+    }
+    result->file_paths = ASTFileUtils::GetFiles(context, patterns, result->ignore_errors, supported_extensions);
+
+    // Compile the pattern once per language present; errors surface at bind time
+    unordered_map<string, unique_ptr<LanguageAdapter>> adapters;
+    ResolveFileLanguages(result->file_paths, language, result->ignore_errors, result->languages, adapters);
+    for (auto &entry : adapters) {
+        result->queries[entry.first] = CompileQuery(entry.first, std::move(entry.second), pattern);
+    }
+
+    names = {"file_path",  "language",     "match_id", "pattern_index", "capture",    "type",     "start_line",
+             "start_column", "end_line", "end_column",    "start_byte", "end_byte", "text"};
+    return_types = {LogicalType::VARCHAR,  LogicalType::VARCHAR,  LogicalType::BIGINT,   LogicalType::UINTEGER,
+                    LogicalType::VARCHAR,  LogicalType::VARCHAR,  LogicalType::UINTEGER, LogicalType::UINTEGER,
+                    LogicalType::UINTEGER, LogicalType::UINTEGER, LogicalType::UINTEGER, LogicalType::UINTEGER,
+                    LogicalType::VARCHAR};
+    return std::move(result);
+}
+
+static unique_ptr<GlobalTableFunctionState> ASTQueryInitGlobal(ClientContext &context,
+                                                               TableFunctionInitInput &input) {
+    auto &bind_data = input.bind_data->Cast<ASTQueryBindData>();
+    return make_uniq<ASTQueryGlobalState>(bind_data.file_paths.size());
+}
+
+static unique_ptr<LocalTableFunctionState> ASTQueryInitLocal(ExecutionContext &context, TableFunctionInitInput &input,
+                                                             GlobalTableFunctionState *global_state) {
+    return make_uniq<ASTQueryLocalState>();
+}
+
+static string NodeText(const string &content, TSNode node) {
+    auto start = ts_node_start_byte(node);
+    auto end = MinValue<uint32_t>(ts_node_end_byte(node), NumericCast<uint32_t>(content.size()));
+    return start < end ? content.substr(start, end - start) : string();
+}
+
+// Text of the first node captured as `capture_id` in a match; false if the capture did not participate
+static bool CaptureText(const TSQueryMatch &match, uint32_t capture_id, const string &content, string &text) {
+    for (uint16_t i = 0; i < match.capture_count; i++) {
+        if (match.captures[i].index == capture_id) {
+            text = NodeText(content, match.captures[i].node);
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool SatisfiesPredicates(const ASTCompiledQuery &compiled, const TSQueryMatch &match, const string &content) {
+    for (auto &predicate : compiled.predicates[match.pattern_index]) {
+        string text;
+        if (!CaptureText(match, predicate.capture_id, content, text)) {
+            continue;
+        }
+        bool result;
+        if (predicate.is_match) {
+            result = duckdb_re2::RE2::PartialMatch(text, *predicate.regex);
+        } else if (predicate.compare_capture) {
+            string other;
+            if (!CaptureText(match, predicate.other_capture_id, content, other)) {
+                continue;
+            }
+            result = text == other;
+        } else {
+            result = text == predicate.value;
+        }
+        if (result == predicate.negate) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void QueryFile(ClientContext &context, const ASTQueryBindData &bind_data, idx_t file_idx,
+                      ASTQueryLocalState &local_state) {
+    local_state.captures.clear();
+    local_state.offset = 0;
+
+    const auto &file_path = bind_data.file_paths[file_idx];
+    auto entry = bind_data.queries.find(bind_data.languages[file_idx]);
+    if (entry == bind_data.queries.end()) {
+        if (bind_data.ignore_errors) {
+            return;
+        }
+        throw InvalidInputException("Unknown language for file: " + file_path);
+    }
+    auto &compiled = *entry->second;
+
+    string content;
+    TSTreePtr tree;
+    try {
+        content = ASTFileUtils::ReadFile(context, file_path);
+        tree = compiled.adapter->ParseContent(content);
+    } catch (const Exception &e) {
+        if (bind_data.ignore_errors) {
+            return;
+        }
+        throw IOException("Error processing file " + file_path + ": " + string(e.what()));
+    }
+
+    auto cursor = local_state.cursor.get();
+    ts_query_cursor_exec(cursor, compiled.query.get(), ts_tree_root_node(tree.get()));
+    TSQueryMatch match;
+    int64_t match_id = 0;
+    while (ts_query_cursor_next_match(cursor, &match)) {
+        if (!SatisfiesPredicates(compiled, match, content)) {
+            continue;
+        }
+        for (uint16_t i = 0; i < match.capture_count; i++) {
+            auto node = match.captures[i].node;
+            ASTQueryCapture capture;
+            capture.file_idx = file_idx;
+            capture.match_id = match_id;
+            capture.pattern_index = match.pattern_index;
+            capture.capture_id = match.captures[i].index;
+            capture.type = ts_node_type(node);
+            capture.start = ts_node_start_point(node);
+            capture.end = ts_node_end_point(node);
+            capture.start_byte = ts_node_start_byte(node);
+            capture.end_byte = ts_node_end_byte(node);
+            capture.text = SanitizeUTF8(NodeText(content, node));
+            local_state.captures.push_back(std::move(capture));
+        }
+        match_id++;
+    }
+}
+
+static void ASTQueryFunction(ClientContext &context, TableFunctionInput &data_p, DataChunk &output) {
+    auto &bind_data = data_p.bind_data->Cast<ASTQueryBindData>();
+    auto &global_state = data_p.global_state->Cast<ASTQueryGlobalState>();
+    auto &local_state = data_p.local_state->Cast<ASTQueryLocalState>();
+
+    idx_t count = 0;
+    while (count < STANDARD_VECTOR_SIZE) {
+        if (local_state.offset >= local_state.captures.size()) {
+            // Claim the next file
+            auto file_idx = global_state.next_file.fetch_add(1);
+            if (file_idx >= bind_data.file_paths.size()) {
+                break;
+            }
+            QueryFile(context, bind_data, file_idx, local_state);
+            continue;
+        }
+        auto &capture = local_state.captures[local_state.offset++];
+        auto &compiled = *bind_data.queries.at(bind_data.languages[capture.file_idx]);
+        output.SetValue(0, count, Value(bind_data.file_paths[capture.file_idx]));
+        output.SetValue(1, count, Value(bind_data.languages[capture.file_idx]));
+        output.SetValue(2, count, Value::BIGINT(capture.match_id));
+        output.SetValue(3, count, Value::UINTEGER(capture.pattern_index));
+        output.SetValue(4, count, Value(compiled.capture_names[capture.capture_id]));
+        output.SetValue(5, count, Value(capture.type));
+        output.SetValue(6, count, Value::UINTEGER(capture.start.row + 1));
+        output.SetValue(7, count, Value::UINTEGER(capture.start.column + 1));
+        output.SetValue(8, count, Value::UINTEGER(capture.end.row + 1));
+        output.SetValue(9, count, Value::UINTEGER(capture.end.column + 1));
+        output.SetValue(10, count, Value::UINTEGER(capture.start_byte));
+        output.SetValue(11, count, Value::UINTEGER(capture.end_byte));
+        output.SetValue(12, count, Value(std::move(capture.text)));
+        count++;
+    }
+    output.SetCardinality(count);
+}
+
+void RegisterASTQueryFunction(DatabaseInstance &instance) {
+    TableFunction ast_query("ast_query", {LogicalType::ANY, LogicalType::VARCHAR, LogicalType::VARCHAR},
+                            ASTQueryFunction, ASTQueryBind, ASTQueryInitGlobal, ASTQueryInitLocal);
+    ast_query.named_parameters["ignore_errors"] = LogicalType::BOOLEAN;
+    ExtensionUtil::RegisterFunction(instance, ast_query);
+}
+
+} // namespace duckdb
@@ -0,0 +1,321 @@
+#include "duckdb.hpp"
+#include "duckdb/catalog/default/default_table_functions.hpp"
+#include "duckdb/common/exception.hpp"
+#include "duckdb/common/types/hash.hpp"
+#include "duckdb/function/scalar_function.hpp"
+#include "duckdb/function/table_function.hpp"
+#include "duckdb/main/extension_util.hpp"
+#include "duckdb/parser/parsed_data/create_macro_info.hpp"
+#include "ast_similarity_functions.hpp"
+#include "ast_file_utils.hpp"
+#include "ast_parsing_task.hpp"
+#include "semantic_types.hpp"
+#include "unified_ast_backend.hpp"
+
+namespace duckdb {
+
+//==============================================================================
+// MinHash signatures of function definitions
+//==============================================================================
+//
+// Every node whose base semantic type is DEFINITION_FUNCTION (in any language)
+// gets a MinHash signature over the shingles of its leaf token sequence. Leaf
+// tokens are normalized to their node type, so identifiers and literals all
+// read "identifier", "integer", ... while keywords and operators keep their
+// text; comments are skipped. Signatures are split into bands whose hashes
+// are the LSH bucket keys: two functions with Jaccard similarity s share at
+// least one bucket with probability 1 - (1 - s^r)^b (r rows per band, b bands).
+//
+// Memory is bounded by one parsed file per thread; only the signatures leave
+// the scan. Candidate pairs are then found by ast_similar_functions with a
+// regular (parallel, spillable) hash join on the bucket keys.
+
+struct ASTSignatureBindData : public ASTFileBindData {
+    idx_t num_hashes = 64;
+    idx_t bands = 16;
+    idx_t shingle_size = 3;
+    idx_t min_tokens = 10;
+    vector<uint64_t> seeds; // One per MinHash function
+};
+
+struct ASTSignatureRow {
+    int64_t node_id;
+    string name;
+    uint32_t start_line;
+    uint32_t end_line;
+    idx_t token_count;
+    vector<uint32_t> signature;
+    vector<uint64_t> band_keys;
+};
+
+using ASTSignatureLocalState = ASTFileScanLocalState<ASTSignatureRow>;
+
+static idx_t GetPositiveParameter(const named_parameter_map_t &parameters, const string &name, idx_t default_value) {
+    auto entry = parameters.find(name);
+    if (entry == parameters.end() || entry->second.IsNull()) {
+        return default_value;
+    }
+    auto value = entry->second.GetValue<int64_t>();
+    if (value <= 0) {
+        throw BinderException("ast_function_signatures: %s must be positive", name);
+    }
+    return NumericCast<idx_t>(value);
+}
+
+static unique_ptr<FunctionData> ASTSignatureBind(ClientContext &context, TableFunctionBindInput &input,
+                                                 vector<LogicalType> &return_types, vector<string> &names) {
+    auto result = make_uniq<ASTSignatureBindData>();
+    result->Bind(context, input, "ast_function_signatures");
+    result->ResolveLanguages();
+    // Signatures only look at node types, so skip the source previews
+    result->peek_size = 0;
+    result->peek_mode = "none";
+
+    result->num_hashes = GetPositiveParameter(input.named_parameters, "num_hashes", result->num_hashes);
+    result->bands = GetPositiveParameter(input.named_parameters, "bands", result->bands);
+    result->shingle_size = GetPositiveParameter(input.named_parameters, "shingle_size", result->shingle_size);
+    result->min_tokens = GetPositiveParameter(input.named_parameters, "min_tokens", result->min_tokens);
+    if (result->num_hashes % result->bands != 0) {
+        throw BinderException("ast_function_signatures: num_hashes (%llu) must be a multiple of bands (%llu)",
+                              result->num_hashes, result->bands);
+    }
+    for (idx_t i = 0; i < result->num_hashes; i++) {
+        result->seeds.push_back(Hash<uint64_t>(i + 1));
+    }
+
+    names = {"file_path", "language",    "node_id",   "name",     "start_line",
+             "end_line",  "token_count", "signature", "band_keys"};
+    return_types = {LogicalType::VARCHAR,  LogicalType::VARCHAR,  LogicalType::BIGINT,
+                    LogicalType::VARCHAR,  LogicalType::UINTEGER, LogicalType::UINTEGER,
+                    LogicalType::UBIGINT,  LogicalType::LIST(LogicalType::UINTEGER),
+                    LogicalType::LIST(LogicalType::UBIGINT)};
+    return std::move(result);
+}
+
+static void ComputeSignatures(const ASTSignatureBindData &bind_data, const ASTResult &result,
+                              vector<ASTSignatureRow> &rows) {
+    const auto &nodes = result.Nodes();
+
+    // Normalized token hash of every leaf, in source order; 0 marks a skipped leaf
+    vector<uint64_t> token_hashes(nodes.size(), 0);
+    for (idx_t i = 0; i < nodes.size(); i++) {
+        auto &node = nodes[i];
+        if (node.structure.descendant_count == 0 &&
+            SemanticTypes::GetKind(node.context.normalized.semantic_type) != SemanticTypes::METADATA) {
+            token_hashes[i] = Hash(node.type.raw.c_str(), node.type.raw.size()) | 1;
+        }
+    }
+
+    const idx_t rows_per_band = bind_data.num_hashes / bind_data.bands;
+    vector<uint64_t> tokens;
+    for (idx_t i = 0; i < nodes.size(); i++) {
+        auto &node = nodes[i];
+        if (SemanticTypes::GetBaseType(node.context.normalized.semantic_type) != SemanticTypes::DEFINITION_FUNCTION) {
+            continue;
+        }
+        // The function's leaves are within its contiguous DFS range
+        tokens.clear();
+        for (idx_t j = i; j <= i + node.structure.descendant_count; j++) {
+            if (token_hashes[j] != 0) {
+                tokens.push_back(token_hashes[j]);
+            }
+        }
+        if (tokens.size() < bind_data.min_tokens) {
+            continue;
+        }
+
+        ASTSignatureRow row;
+        row.node_id = NumericCast<int64_t>(node.node_id);
+        row.name = node.context.name;
+        row.start_line = node.source.start_line;
+        row.end_line = node.source.end_line;
+        row.token_count = tokens.size();
+        row.signature.assign(bind_data.num_hashes, NumericLimits<uint32_t>::Maximum());
+
+        // MinHash over the shingles (k consecutive tokens)
+        auto shingle_size = MinValue<idx_t>(bind_data.shingle_size, tokens.size());
+        for (idx_t start = 0; start + shingle_size <= tokens.size(); start++) {
+            uint64_t shingle = 0;
+            for (idx_t k = 0; k < shingle_size; k++) {
+                shingle = CombineHash(Hash<uint64_t>(shingle), tokens[start + k]);
+            }
+            for (idx_t h = 0; h < bind_data.num_hashes; h++) {
+                auto value = static_cast<uint32_t>(Hash<uint64_t>(shingle ^ bind_data.seeds[h]));
+                row.signature[h] = MinValue<uint32_t>(row.signature[h], value);
+            }
+        }
+
+        // LSH: one bucket key per band, tagged with the band number
+        for (idx_t band = 0; band < bind_data.bands; band++) {
+            uint64_t key = Hash<uint64_t>(band);
+            for (idx_t r = 0; r < rows_per_band; r++) {
+                key = CombineHash(Hash<uint64_t>(key), row.signature[band * rows_per_band + r]);
+            }
+            row.band_keys.push_back(key);
+        }
+        rows.push_back(std::move(row));
+    }
+}
+
+static void ASTSignatureFunction(ClientContext &context, TableFunctionInput &data_p, DataChunk &output) {
+    auto &bind_data = data_p.bind_data->Cast<ASTSignatureBindData>();
+    auto &global_state = data_p.global_state->Cast<ASTFileScanGlobalState>();
+    auto &local_state = data_p.local_state->Cast<ASTSignatureLocalState>();
+
+    idx_t count = 0;
+    while (count < STANDARD_VECTOR_SIZE) {
+        auto next = local_state.Next(context, bind_data, global_state, [&](const ASTResult &result) {
+            ComputeSignatures(bind_data, result, local_state.rows);
+        });
+        if (!next) {
+            break;
+        }
+        auto &row = *next;
+        vector<Value> signature;
+        signature.reserve(row.signature.size());
+        for (auto value : row.signature) {
+            signature.push_back(Value::UINTEGER(value));
+        }
+        vector<Value> band_keys;
+        band_keys.reserve(row.band_keys.size());
+        for (auto key : row.band_keys) {
+            band_keys.push_back(Value::UBIGINT(key));
+        }
+        output.SetValue(0, count, Value(bind_data.file_paths[local_state.file_idx]));
+        output.SetValue(1, count, Value(bind_data.languages[local_state.file_idx]));
+        output.SetValue(2, count, Value::BIGINT(row.node_id));
+        output.SetValue(3, count, ASTFileUtils::OptionalString(row.name));
+        output.SetValue(4, count, Value::UINTEGER(row.start_line));
+        output.SetValue(5, count, Value::UINTEGER(row.end_line));
+        output.SetValue(6, count, Value::UBIGINT(row.token_count));
+        output.SetValue(7, count, Value::LIST(LogicalType::UINTEGER, std::move(signature)));
+        output.SetValue(8, count, Value::LIST(LogicalType::UBIGINT, std::move(band_keys)));
+        count++;
+    }
+    output.SetCardinality(count);
+}
+
+static TableFunction GetASTSignatureFunction(const vector<LogicalType> &arguments) {
+    TableFunction ast_function_signatures("ast_function_signatures", arguments, ASTSignatureFunction,
+                                          ASTSignatureBind, ASTFileScanGlobalState::Init,
+                                          ASTFileScanInitLocal<ASTSignatureLocalState>);
+    ast_function_signatures.named_parameters["ignore_errors"] = LogicalType::BOOLEAN;
+    ast_function_signatures.named_parameters["num_hashes"] = LogicalType::BIGINT;
+    ast_function_signatures.named_parameters["bands"] = LogicalType::BIGINT;
+    ast_function_signatures.named_parameters["shingle_size"] = LogicalType::BIGINT;
+    ast_function_signatures.named_parameters["min_tokens"] = LogicalType::BIGINT;
+    return ast_function_signatures;
+}
+
+//==============================================================================
+// ast_minhash_similarity(signature, signature) -> DOUBLE
+//==============================================================================
+//
+// Estimated Jaccard similarity: the fraction of MinHash positions that agree.
+
+static void ASTMinHashSimilarityFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+    auto &left = args.data[0];
+    auto &right = args.data[1];
+    UnifiedVectorFormat left_format, right_format, left_child_format, right_child_format;
+    left.ToUnifiedFormat(args.size(), left_format);
+    right.ToUnifiedFormat(args.size(), right_format);
+    auto &left_child = ListVector::GetEntry(left);
+    auto &right_child = ListVector::GetEntry(right);
+    left_child.ToUnifiedFormat(ListVector::GetListSize(left), left_child_format);
+    right_child.ToUnifiedFormat(ListVector::GetListSize(right), right_child_format);
+    auto left_entries = UnifiedVectorFormat::GetData<list_entry_t>(left_format);
+    auto right_entries = UnifiedVectorFormat::GetData<list_entry_t>(right_format);
+    auto left_values = UnifiedVectorFormat::GetData<uint32_t>(left_child_format);
+    auto right_values = UnifiedVectorFormat::GetData<uint32_t>(right_child_format);
+
+    result.SetVectorType(VectorType::FLAT_VECTOR);
+    auto result_data = FlatVector::GetData<double>(result);
+    for (idx_t row = 0; row < args.size(); row++) {
+        auto left_idx = left_format.sel->get_index(row);
+        auto right_idx = right_format.sel->get_index(row);
+        if (!left_format.validity.RowIsValid(left_idx) || !right_format.validity.RowIsValid(right_idx)) {
+            FlatVector::SetNull(result, row, true);
+            continue;
+        }
+        auto &left_entry = left_entries[left_idx];
+        auto &right_entry = right_entries[right_idx];
+        if (left_entry.length != right_entry.length) {
+            throw InvalidInputException("ast_minhash_similarity: signatures have different lengths (%llu and %llu)",
+                                        left_entry.length, right_entry.length);
+        }
+        if (left_entry.length == 0) {
+            FlatVector::SetNull(result, row, true);
+            continue;
+        }
+        idx_t matches = 0;
+        for (idx_t i = 0; i < left_entry.length; i++) {
+            auto l = left_child_format.sel->get_index(left_entry.offset + i);
+            auto r = right_child_format.sel->get_index(right_entry.offset + i);
+            matches += left_values[l] == right_values[r];
+        }
+        result_data[row] = double(matches) / double(left_entry.length);
+    }
+    if (args.AllConstant()) {
+        result.SetVectorType(VectorType::CONSTANT_VECTOR);
+    }
+}
+
+//==============================================================================
+// ast_similar_functions(file_patterns, threshold := 0.8, ...)
+//==============================================================================
+//
+// Candidate pairs are functions sharing an LSH bucket (hash join on the band
+// keys); each candidate is then scored on the full signature.
+
+static const DefaultTableMacro AST_SIMILARITY_MACROS[] = {
+    {DEFAULT_SCHEMA,
+     "ast_similar_functions",
+     {"file_patterns", nullptr},
+     {{"threshold", "0.8"},
+      {"num_hashes", "64"},
+      {"bands", "16"},
+      {"shingle_size", "3"},
+      {"min_tokens", "10"},
+      {nullptr, nullptr}},
+     R"(
+WITH signatures AS MATERIALIZED (
+    SELECT row_number() OVER () AS function_id, *
+    FROM ast_function_signatures(file_patterns, num_hashes := num_hashes, bands := bands,
+                                 shingle_size := shingle_size, min_tokens := min_tokens, ignore_errors := true)
+),
+buckets AS (
+    SELECT function_id, unnest(band_keys) AS band_key FROM signatures
+),
+candidates AS (
+    SELECT DISTINCT a.function_id AS left_id, b.function_id AS right_id
+    FROM buckets a JOIN buckets b ON a.band_key = b.band_key AND a.function_id < b.function_id
+)
+SELECT l.file_path, l.name, l.start_line, l.end_line,
+       r.file_path AS other_file_path, r.name AS other_name, r.start_line AS other_start_line,
+       r.end_line AS other_end_line,
+       ast_minhash_similarity(l.signature, r.signature) AS similarity
+FROM candidates c
+JOIN signatures l ON l.function_id = c.left_id
+JOIN signatures r ON r.function_id = c.right_id
+WHERE ast_minhash_similarity(l.signature, r.signature) >= threshold
+)"},
+    {nullptr, nullptr, {nullptr}, {{nullptr, nullptr}}, nullptr}};
+
+void RegisterASTSimilarityFunctions(DatabaseInstance &instance) {
+    TableFunctionSet ast_function_signatures("ast_function_signatures");
+    ast_function_signatures.AddFunction(GetASTSignatureFunction({LogicalType::ANY}));
+    ast_function_signatures.AddFunction(GetASTSignatureFunction({LogicalType::ANY, LogicalType::VARCHAR}));
+    ExtensionUtil::RegisterFunction(instance, ast_function_signatures);
+
+    auto signature_type = LogicalType::LIST(LogicalType::UINTEGER);
+    ExtensionUtil::RegisterFunction(instance, ScalarFunction("ast_minhash_similarity",
+                                                             {signature_type, signature_type}, LogicalType::DOUBLE,
+                                                             ASTMinHashSimilarityFunction));
+
+    for (idx_t i = 0; AST_SIMILARITY_MACROS[i].name != nullptr; i++) {
+        auto info = DefaultTableFunctionGenerator::CreateTableMacroInfo(AST_SIMILARITY_MACROS[i]);
+        ExtensionUtil::RegisterFunction(instance, *info);
+    }
+}
+
+} // namespace duckdb
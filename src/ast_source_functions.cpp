@@ -0,0 +1,132 @@
+#include "ast_source_functions.hpp"
+#include "ast_file_utils.hpp"
+#include "duckdb/common/exception.hpp"
+#include "duckdb/execution/expression_executor_state.hpp"
+#include "duckdb/function/scalar_function.hpp"
+#include "duckdb/main/extension_util.hpp"
+#include "utf8proc_wrapper.hpp"
+#include <algorithm>
+
+namespace duckdb {
+
+//==============================================================================
+// ast_get_source(file_path, start_byte, end_byte) -> VARCHAR
+//==============================================================================
+//
+// Slices [start_byte, end_byte) out of the file, so scans can run with
+// peek_mode := 'none' and fetch full text only for the nodes they need. The
+// rows of a chunk are grouped by file and every file is read once; the last
+// few files stay in a small per-thread cache for the rest of the query, which
+// covers the usual case of many nodes from the same handful of files.
+
+static constexpr idx_t SOURCE_CACHE_FILES = 8;
+
+struct ASTSourceLocalState : public FunctionLocalState {
+    // Most recently used file last
+    vector<pair<string, string>> files;
+
+    const string &GetContent(ClientContext &context, const string &file_path) {
+        for (idx_t i = 0; i < files.size(); i++) {
+            if (files[i].first == file_path) {
+                if (i + 1 != files.size()) {
+                    auto entry = std::move(files[i]);
+                    files.erase(files.begin() + NumericCast<int64_t>(i));
+                    files.push_back(std::move(entry));
+                }
+                return files.back().second;
+            }
+        }
+        string content;
+        try {
+            content = ASTFileUtils::ReadFile(context, file_path);
+        } catch (const Exception &e) {
+            throw IOException("ast_get_source: cannot read file " + file_path + ": " + string(e.what()));
+        }
+        if (files.size() >= SOURCE_CACHE_FILES) {
+            files.erase(files.begin());
+        }
+        files.emplace_back(file_path, std::move(content));
+        return files.back().second;
+    }
+};
+
+static unique_ptr<FunctionLocalState> ASTSourceInitLocal(ExpressionState &state, const BoundFunctionExpression &expr,
+                                                         FunctionData *bind_data) {
+    return make_uniq<ASTSourceLocalState>();
+}
+
+static void ASTGetSourceFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+    auto &local_state = ExecuteFunctionState::GetFunctionState(state)->Cast<ASTSourceLocalState>();
+    auto &context = state.GetContext();
+    const auto count = args.size();
+
+    UnifiedVectorFormat path_format, start_format, end_format;
+    args.data[0].ToUnifiedFormat(count, path_format);
+    args.data[1].ToUnifiedFormat(count, start_format);
+    args.data[2].ToUnifiedFormat(count, end_format);
+    auto paths = UnifiedVectorFormat::GetData<string_t>(path_format);
+    auto starts = UnifiedVectorFormat::GetData<int64_t>(start_format);
+    auto ends = UnifiedVectorFormat::GetData<int64_t>(end_format);
+
+    result.SetVectorType(VectorType::FLAT_VECTOR);
+    auto result_data = FlatVector::GetData<string_t>(result);
+    auto &result_validity = FlatVector::Validity(result);
+
+    // Rows with all arguments present, grouped by file
+    vector<idx_t> rows;
+    rows.reserve(count);
+    for (idx_t row = 0; row < count; row++) {
+        auto path_idx = path_format.sel->get_index(row);
+        auto start_idx = start_format.sel->get_index(row);
+        auto end_idx = end_format.sel->get_index(row);
+        if (!path_format.validity.RowIsValid(path_idx) || !start_format.validity.RowIsValid(start_idx) ||
+            !end_format.validity.RowIsValid(end_idx)) {
+            result_validity.SetInvalid(row);
+            continue;
+        }
+        if (starts[start_idx] < 0 || ends[end_idx] < 0) {
+            throw InvalidInputException("ast_get_source: byte offsets must be >= 0");
+        }
+        rows.push_back(row);
+    }
+    std::stable_sort(rows.begin(), rows.end(), [&](idx_t a, idx_t b) {
+        return paths[path_format.sel->get_index(a)] < paths[path_format.sel->get_index(b)];
+    });
+
+    const string *content = nullptr;
+    string_t current_path;
+    for (auto row : rows) {
+        auto path = paths[path_format.sel->get_index(row)];
+        if (!content || path != current_path) {
+            content = &local_state.GetContent(context, path.GetString());
+            current_path = path;
+        }
+        auto size = NumericCast<int64_t>(content->size());
+        auto start = MinValue(starts[start_format.sel->get_index(row)], size);
+        auto end = MinValue(MaxValue(ends[end_format.sel->get_index(row)], start), size);
+        auto text = content->c_str() + start;
+        auto length = NumericCast<idx_t>(end - start);
+
+        result_data[row] = StringVector::AddString(result, text, length);
+        if (!Utf8Proc::IsValid(text, length)) {
+            // Offsets from another version of the file, or a non UTF-8 file
+            auto data = result_data[row].GetDataWriteable();
+            Utf8Proc::MakeValid(data, length, '?');
+            result_data[row].Finalize();
+        }
+    }
+    if (args.AllConstant()) {
+        result.SetVectorType(VectorType::CONSTANT_VECTOR);
+    }
+}
+
+void RegisterASTSourceFunctions(DatabaseInstance &instance) {
+    ScalarFunction ast_get_source("ast_get_source", {LogicalType::VARCHAR, LogicalType::BIGINT, LogicalType::BIGINT},
+                                  LogicalType::VARCHAR, ASTGetSourceFunction, nullptr, nullptr, nullptr,
+                                  ASTSourceInitLocal);
+    // Reads files, so results may change between queries
+    ast_get_source.stability = FunctionStability::CONSISTENT_WITHIN_QUERY;
+    ExtensionUtil::RegisterFunction(instance, ast_get_source);
+}
+
+} // namespace duckdb
@@ -0,0 +1,459 @@
+#include "duckdb.hpp"
+#include "duckdb/catalog/default/default_table_functions.hpp"
+#include "duckdb/common/exception.hpp"
+#include "duckdb/function/table_function.hpp"
+#include "duckdb/main/client_context.hpp"
+#include "duckdb/main/connection.hpp"
+#include "duckdb/main/extension_util.hpp"
+#include "duckdb/parser/keyword_helper.hpp"
+#include "duckdb/parser/parsed_data/create_macro_info.hpp"
+#include "duckdb/parser/qualified_name.hpp"
+#include "ast_symbol_functions.hpp"
+#include "ast_file_utils.hpp"
+#include "ast_parsing_task.hpp"
+#include "semantic_types.hpp"
+#include "unified_ast_backend.hpp"
+
+namespace duckdb {
+
+//==============================================================================
+// read_ast_symbols(file_patterns, [language]) -> definitions and references
+//==============================================================================
+//
+// Per file, in parallel across files. Scoping follows the semantic types:
+//   scopes       DEFINITION_FUNCTION / DEFINITION_CLASS nodes with children;
+//                the file itself is the outermost scope
+//   definitions  named DEFINITION_* nodes, bound in the scope enclosing them,
+//                plus identifiers in the parameter list (ORGANIZATION_LIST) of
+//                a function, bound in the function's scope
+//   references   NAME_IDENTIFIER leaves that are not the defining occurrence
+//                of their parent definition and not a member after '.'/'->'
+// References are resolved lexically within the file: the innermost scope that
+// defines the name wins, whether the definition comes before or after the use.
+// Python class bodies are not visible from the methods nested in them.
+
+enum class ASTSymbolKind : uint8_t { DEFINITION, REFERENCE };
+
+struct ASTSymbolRow {
+    ASTSymbolKind kind;
+    idx_t node_index;
+    int64_t scope;            // Scope slot (binding scope of a definition, innermost scope of a reference); -1 = file
+    int64_t definition_index; // Resolved definition node of a reference; -1 if none in this file
+};
+
+struct ASTScope {
+    int64_t parent;           // Enclosing scope slot, -1 = file
+    idx_t node_index;
+    bool is_class;
+    string qualified_name;
+    unordered_map<string, idx_t> names; // Name -> first defining node
+};
+
+struct ReadASTSymbolsLocalState : public ASTFileScanLocalState<ASTSymbolRow> {
+    // Scopes of the file being emitted
+    vector<ASTScope> scopes;
+    unordered_map<string, idx_t> file_names; // Definitions at file level
+};
+
+static bool IsMemberAccess(const vector<ASTNode> &nodes, idx_t i) {
+    auto &node = nodes[i];
+    if (node.structure.parent_id < 0 || i == 0) {
+        return false;
+    }
+    auto &parent = nodes[node.structure.parent_id];
+    if (SemanticTypes::GetBaseType(parent.context.normalized.semantic_type) != SemanticTypes::COMPUTATION_ACCESS) {
+        return false;
+    }
+    // The preceding leaf sibling is the access operator
+    auto &previous = nodes[i - 1];
+    if (previous.structure.parent_id != node.structure.parent_id) {
+        return false;
+    }
+    auto &op = previous.type.raw;
+    return op == "." || op == "->" || op == "?." || op == "::";
+}
+
+static void CollectSymbols(const string &language, const vector<ASTNode> &nodes, ReadASTSymbolsLocalState &symbols) {
+    auto &scopes = symbols.scopes;
+    const bool class_scope_hidden = language == "python";
+
+    auto bind = [&](int64_t scope, const string &name, idx_t node_index) {
+        auto &names = scope < 0 ? symbols.file_names : scopes[scope].names;
+        names.emplace(name, node_index);
+    };
+
+    struct OpenScope {
+        idx_t last_index;
+        int64_t slot;
+    };
+    vector<OpenScope> stack;
+
+    // Pass 1: scopes, definitions and unresolved references
+    for (idx_t i = 0; i < nodes.size(); i++) {
+        while (!stack.empty() && stack.back().last_index < i) {
+            stack.pop_back();
+        }
+        const int64_t current_scope = stack.empty() ? -1 : stack.back().slot;
+        auto &node = nodes[i];
+        auto semantic_type = node.context.normalized.semantic_type;
+        auto base_type = SemanticTypes::GetBaseType(semantic_type);
+        bool is_keyword = node.context.normalized.universal_flags & ASTNodeFlags::IS_KEYWORD;
+        const ASTNode *parent = node.structure.parent_id >= 0 ? &nodes[node.structure.parent_id] : nullptr;
+
+        if (SemanticTypes::GetKind(semantic_type) == SemanticTypes::DEFINITION && !is_keyword &&
+            node.structure.descendant_count > 0) {
+            // A declarator nested in a declaration of the same name is the same definition
+            bool nested_duplicate = parent && parent->context.name == node.context.name &&
+                                    SemanticTypes::GetKind(parent->context.normalized.semantic_type) ==
+                                        SemanticTypes::DEFINITION;
+            if (!node.context.name.empty() && !nested_duplicate) {
+                bind(current_scope, node.context.name, i);
+                symbols.rows.push_back({ASTSymbolKind::DEFINITION, i, current_scope, -1});
+            }
+            if (base_type == SemanticTypes::DEFINITION_FUNCTION || base_type == SemanticTypes::DEFINITION_CLASS) {
+                ASTScope scope;
+                scope.parent = current_scope;
+                scope.node_index = i;
+                scope.is_class = base_type == SemanticTypes::DEFINITION_CLASS;
+                if (current_scope >= 0) {
+                    scope.qualified_name = scopes[current_scope].qualified_name;
+                }
+                if (!node.context.name.empty()) {
+                    scope.qualified_name += (scope.qualified_name.empty() ? "" : ".") + node.context.name;
+                }
+                scopes.push_back(std::move(scope));
+                stack.push_back({i + node.structure.descendant_count, NumericCast<int64_t>(scopes.size() - 1)});
+            }
+            continue;
+        }
+
+        if (base_type != SemanticTypes::NAME_IDENTIFIER || node.structure.descendant_count != 0 ||
+            node.context.name.empty()) {
+            continue;
+        }
+        if (parent && SemanticTypes::GetKind(parent->context.normalized.semantic_type) == SemanticTypes::DEFINITION &&
+            parent->context.name == node.context.name) {
+            continue; // Defining occurrence
+        }
+        if (parent && parent->structure.parent_id >= 0 &&
+            SemanticTypes::GetBaseType(parent->context.normalized.semantic_type) == SemanticTypes::ORGANIZATION_LIST &&
+            SemanticTypes::GetBaseType(nodes[parent->structure.parent_id].context.normalized.semantic_type) ==
+                SemanticTypes::DEFINITION_FUNCTION) {
+            // Parameter: bound in the function's own scope
+            bind(current_scope, node.context.name, i);
+            symbols.rows.push_back({ASTSymbolKind::DEFINITION, i, current_scope, -1});
+            continue;
+        }
+        if (IsMemberAccess(nodes, i)) {
+            continue;
+        }
+        symbols.rows.push_back({ASTSymbolKind::REFERENCE, i, current_scope, -1});
+    }
+
+    // Pass 2: resolve references through the scope chain (definitions may follow their uses)
+    for (auto &row : symbols.rows) {
+        if (row.kind != ASTSymbolKind::REFERENCE) {
+            continue;
+        }
+        auto &name = nodes[row.node_index].context.name;
+        for (int64_t scope = row.scope;; scope = scopes[scope].parent) {
+            if (scope >= 0 && class_scope_hidden && scopes[scope].is_class && scope != row.scope) {
+                continue;
+            }
+            auto &names = scope < 0 ? symbols.file_names : scopes[scope].names;
+            auto entry = names.find(name);
+            if (entry != names.end()) {
+                row.definition_index = NumericCast<int64_t>(entry->second);
+                break;
+            }
+            if (scope < 0) {
+                break;
+            }
+        }
+    }
+}
+
+static unique_ptr<FunctionData> ReadASTSymbolsBind(ClientContext &context, TableFunctionBindInput &input,
+                                                   vector<LogicalType> &return_types, vector<string> &names) {
+    auto result = make_uniq<ASTFileBindData>();
+    result->Bind(context, input, "read_ast_symbols");
+    result->ResolveLanguages();
+
+    names = {"file_path",  "language",     "kind",     "name",       "qualified_name",
+             "type",       "semantic_type", "node_id", "scope_node_id", "definition_node_id",
+             "start_line", "start_column", "end_line", "end_column"};
+    return_types = {LogicalType::VARCHAR,  LogicalType::VARCHAR,  LogicalType::VARCHAR,  LogicalType::VARCHAR,
+                    LogicalType::VARCHAR,  LogicalType::VARCHAR,  LogicalType::UTINYINT, LogicalType::BIGINT,
+                    LogicalType::BIGINT,   LogicalType::BIGINT,   LogicalType::UINTEGER, LogicalType::UINTEGER,
+                    LogicalType::UINTEGER, LogicalType::UINTEGER};
+    return std::move(result);
+}
+
+static Value NodeIdValue(const vector<ASTNode> &nodes, int64_t index) {
+    return index < 0 ? Value(LogicalType::BIGINT) : Value::BIGINT(NumericCast<int64_t>(nodes[index].node_id));
+}
+
+static void ReadASTSymbolsFunction(ClientContext &context, TableFunctionInput &data_p, DataChunk &output) {
+    auto &bind_data = data_p.bind_data->Cast<ASTFileBindData>();
+    auto &global_state = data_p.global_state->Cast<ASTFileScanGlobalState>();
+    auto &local_state = data_p.local_state->Cast<ReadASTSymbolsLocalState>();
+
+    idx_t count = 0;
+    while (count < STANDARD_VECTOR_SIZE) {
+        auto next = local_state.Next(context, bind_data, global_state, [&](const ASTResult &result) {
+            local_state.scopes.clear();
+            local_state.file_names.clear();
+            CollectSymbols(bind_data.languages[local_state.file_idx], result.Nodes(), local_state);
+        });
+        if (!next) {
+            break;
+        }
+        auto &row = *next;
+        auto &nodes = local_state.result->Nodes();
+        auto &node = nodes[row.node_index];
+        bool is_definition = row.kind == ASTSymbolKind::DEFINITION;
+        const string *scope_name = row.scope < 0 ? nullptr : &local_state.scopes[row.scope].qualified_name;
+
+        output.SetValue(0, count, Value(bind_data.file_paths[local_state.file_idx]));
+        output.SetValue(1, count, Value(bind_data.languages[local_state.file_idx]));
+        output.SetValue(2, count, Value(is_definition ? "definition" : "reference"));
+        output.SetValue(3, count, Value(node.context.name));
+        if (is_definition) {
+            output.SetValue(4, count, Value(scope_name && !scope_name->empty() ? *scope_name + "." + node.context.name
+                                                                               : node.context.name));
+        } else {
+            output.SetValue(4, count, Value(LogicalType::VARCHAR));
+        }
+        output.SetValue(5, count, Value(node.type.raw));
+        output.SetValue(6, count, Value::UTINYINT(node.context.normalized.semantic_type));
+        output.SetValue(7, count, Value::BIGINT(NumericCast<int64_t>(node.node_id)));
+        output.SetValue(8, count,
+                        row.scope < 0 ? Value(LogicalType::BIGINT)
+                                      : NodeIdValue(nodes, NumericCast<int64_t>(local_state.scopes[row.scope].node_index)));
+        output.SetValue(9, count, NodeIdValue(nodes, row.definition_index));
+        output.SetValue(10, count, Value::UINTEGER(node.source.start_line));
+        output.SetValue(11, count, Value::UINTEGER(node.source.start_column));
+        output.SetValue(12, count, Value::UINTEGER(node.source.end_line));
+        output.SetValue(13, count, Value::UINTEGER(node.source.end_column));
+        count++;
+    }
+    output.SetCardinality(count);
+}
+
+static TableFunction GetReadASTSymbolsFunction(const vector<LogicalType> &arguments) {
+    TableFunction read_ast_symbols("read_ast_symbols", arguments, ReadASTSymbolsFunction, ReadASTSymbolsBind,
+                                   ASTFileScanGlobalState::Init, ASTFileScanInitLocal<ReadASTSymbolsLocalState>);
+    read_ast_symbols.named_parameters["ignore_errors"] = LogicalType::BOOLEAN;
+    return read_ast_symbols;
+}
+
+//==============================================================================
+// ast_symbol_index(index_name, file_patterns, ...)
+//==============================================================================
+//
+// Materializes read_ast_symbols as two tables with integer ids:
+//   <index_name>             one row per definition (symbol_id)
+//   <index_name>_references  one row per reference; symbol_id is the definition
+//                            it resolves to in its own file, NULL if none
+// Cross-file candidates are not stored: ast_references matches unresolved
+// references by name to the file-level definition being looked up. Both tables
+// get ART indexes on their lookup columns, so ast_definition_of and
+// ast_references are index lookups.
+
+struct ASTSymbolIndexBindData : public TableFunctionData {
+    string schema_name;
+    string table_name;
+    Value file_patterns;
+    string language = "auto";
+    bool ignore_errors = false;
+};
+
+struct ASTSymbolIndexGlobalState : public GlobalTableFunctionState {
+    bool built = false;
+    vector<pair<string, int64_t>> tables; // Table name, row count
+    idx_t offset = 0;
+};
+
+static unique_ptr<FunctionData> ASTSymbolIndexBind(ClientContext &context, TableFunctionBindInput &input,
+                                                   vector<LogicalType> &return_types, vector<string> &names) {
+    auto result = make_uniq<ASTSymbolIndexBindData>();
+
+    if (!context.transaction.IsAutoCommit()) {
+        throw InvalidInputException("ast_symbol_index cannot run inside an explicit transaction: it commits the "
+                                    "tables on its own connection, which a ROLLBACK would not undo");
+    }
+    if (input.inputs[0].IsNull()) {
+        throw BinderException("ast_symbol_index: index name cannot be NULL");
+    }
+    auto qualified_name = QualifiedName::Parse(input.inputs[0].GetValue<string>());
+    if (!qualified_name.catalog.empty() && qualified_name.catalog != INVALID_CATALOG) {
+        throw BinderException("ast_symbol_index: catalog-qualified table names are not supported");
+    }
+    result->schema_name = qualified_name.schema == INVALID_SCHEMA ? string() : qualified_name.schema;
+    result->table_name = qualified_name.name;
+
+    if (input.inputs[1].IsNull()) {
+        throw BinderException("ast_symbol_index: file patterns cannot be NULL");
+    }
+    result->file_patterns = input.inputs[1];
+
+    for (auto &kv : input.named_parameters) {
+        if (kv.first == "language") {
+            result->language = StringValue::Get(kv.second);
+        } else if (kv.first == "ignore_errors") {
+            result->ignore_errors = BooleanValue::Get(kv.second);
+        }
+    }
+
+    names = {"table_name", "row_count"};
+    return_types = {LogicalType::VARCHAR, LogicalType::BIGINT};
+    return std::move(result);
+}
+
+static unique_ptr<GlobalTableFunctionState> ASTSymbolIndexInit(ClientContext &context,
+                                                               TableFunctionInitInput &input) {
+    return make_uniq<ASTSymbolIndexGlobalState>();
+}
+
+static string QualifiedTableName(const string &schema_name, const string &table_name) {
+    auto result = KeywordHelper::WriteOptionallyQuoted(table_name);
+    if (!schema_name.empty()) {
+        result = KeywordHelper::WriteOptionallyQuoted(schema_name) + "." + result;
+    }
+    return result;
+}
+
+static unique_ptr<MaterializedQueryResult> RunQuery(Connection &con, const string &sql) {
+    auto result = con.Query(sql);
+    if (result->HasError()) {
+        result->ThrowError();
+    }
+    return result;
+}
+
+static void BuildSymbolIndex(ClientContext &context, const ASTSymbolIndexBindData &bind_data,
+                             vector<pair<string, int64_t>> &tables) {
+    const auto references_name = bind_data.table_name + "_references";
+    const auto symbols_table = QualifiedTableName(bind_data.schema_name, bind_data.table_name);
+    const auto references_table = QualifiedTableName(bind_data.schema_name, references_name);
+    const auto symbols_index = KeywordHelper::WriteOptionallyQuoted(bind_data.table_name + "_name_idx");
+    const auto references_index = KeywordHelper::WriteOptionallyQuoted(references_name + "_symbol_idx");
+    const auto references_name_index = KeywordHelper::WriteOptionallyQuoted(references_name + "_name_idx");
+
+    // Built in one transaction on a side connection, like ast_index_sync: it commits
+    // on its own, which is why bind rejects calls inside an explicit transaction
+    Connection con(*context.db);
+    con.BeginTransaction();
+    try {
+        auto read_symbols = "read_ast_symbols(" + bind_data.file_patterns.ToSQLString() + ", " +
+                            Value(bind_data.language).ToSQLString() +
+                            ", ignore_errors := " + (bind_data.ignore_errors ? "true" : "false") + ")";
+        RunQuery(con, "CREATE OR REPLACE TEMPORARY TABLE __ast_symbol_rows AS SELECT * FROM " + read_symbols);
+
+        RunQuery(con, "CREATE OR REPLACE TABLE " + symbols_table + " AS "
+                      "SELECT (row_number() OVER (ORDER BY file_path, node_id))::INTEGER AS symbol_id, "
+                      "name, qualified_name, type, semantic_type, language, file_path, node_id, "
+                      "scope_node_id IS NULL AS is_file_level, start_line, start_column, end_line, end_column "
+                      "FROM __ast_symbol_rows WHERE kind = 'definition'");
+
+        // Only references that resolve in their own file get a symbol_id here. The
+        // others keep a NULL symbol_id and are matched by name to file-level
+        // definitions in ast_references, so a common name does not multiply the rows
+        RunQuery(con, "CREATE OR REPLACE TABLE " + references_table + " AS "
+                      "SELECT (row_number() OVER (ORDER BY r.file_path, r.node_id))::INTEGER AS reference_id, "
+                      "s.symbol_id, r.name, r.language, r.file_path, r.node_id, "
+                      "r.definition_node_id IS NOT NULL AS is_local, "
+                      "r.start_line, r.start_column, r.end_line, r.end_column "
+                      "FROM __ast_symbol_rows r "
+                      "LEFT JOIN " + symbols_table + " s ON s.file_path = r.file_path AND s.node_id = r.definition_node_id "
+                      "WHERE r.kind = 'reference'");
+        RunQuery(con, "DROP TABLE __ast_symbol_rows");
+
+        RunQuery(con, "CREATE INDEX " + symbols_index + " ON " + symbols_table + " (name)");
+        RunQuery(con, "CREATE INDEX " + references_index + " ON " + references_table + " (symbol_id)");
+        RunQuery(con, "CREATE INDEX " + references_name_index + " ON " + references_table + " (name)");
+
+        auto symbol_count = RunQuery(con, "SELECT count(*) FROM " + symbols_table);
+        auto reference_count = RunQuery(con, "SELECT count(*) FROM " + references_table);
+        con.Commit();
+
+        tables.emplace_back(bind_data.table_name, symbol_count->GetValue(0, 0).GetValue<int64_t>());
+        tables.emplace_back(references_name, reference_count->GetValue(0, 0).GetValue<int64_t>());
+    } catch (...) {
+        if (con.HasActiveTransaction()) {
+            con.Rollback();
+        }
+        throw;
+    }
+}
+
+static void ASTSymbolIndexFunction(ClientContext &context, TableFunctionInput &data_p, DataChunk &output) {
+    auto &bind_data = data_p.bind_data->Cast<ASTSymbolIndexBindData>();
+    auto &state = data_p.global_state->Cast<ASTSymbolIndexGlobalState>();
+
+    if (!state.built) {
+        BuildSymbolIndex(context, bind_data, state.tables);
+        state.built = true;
+    }
+
+    idx_t count = 0;
+    while (state.offset < state.tables.size() && count < STANDARD_VECTOR_SIZE) {
+        auto &table = state.tables[state.offset++];
+        output.SetValue(0, count, Value(table.first));
+        output.SetValue(1, count, Value::BIGINT(table.second));
+        count++;
+    }
+    output.SetCardinality(count);
+}
+
+//==============================================================================
+// Index lookups: ast_definition_of(name), ast_references(symbol_id)
+//
+// ast_references returns the references resolved to the symbol in its own file,
+// plus, for a file-level symbol, the unresolved references of the same name and
+// language in any file. Those are reported with the requested symbol_id.
+//
+// Parameters must not share a name with a column of the tables they filter:
+// inside the macro body the column would win and the filter would be a no-op.
+//==============================================================================
+
+static const DefaultTableMacro AST_SYMBOL_MACROS[] = {
+    {DEFAULT_SCHEMA,
+     "ast_definition_of",
+     {"symbol_name", nullptr},
+     {{"index_name", "'ast_symbols'"}, {nullptr, nullptr}},
+     R"(SELECT s.* FROM query_table(index_name) s WHERE s.name = symbol_name ORDER BY s.symbol_id)"},
+    {DEFAULT_SCHEMA,
+     "ast_references",
+     {"target_symbol_id", nullptr},
+     {{"index_name", "'ast_symbols'"}, {nullptr, nullptr}},
+     R"(SELECT * FROM (
+            SELECT r.* FROM query_table(index_name || '_references') r WHERE r.symbol_id = target_symbol_id
+            UNION ALL
+            SELECT r.reference_id, s.symbol_id, r.name, r.language, r.file_path, r.node_id, r.is_local,
+                   r.start_line, r.start_column, r.end_line, r.end_column
+            FROM query_table(index_name) s
+            JOIN query_table(index_name || '_references') r ON r.name = s.name AND r.language = s.language
+            WHERE s.symbol_id = target_symbol_id AND s.is_file_level AND r.symbol_id IS NULL
+        ) ORDER BY reference_id)"},
+    {nullptr, nullptr, {nullptr}, {{nullptr, nullptr}}, nullptr}};
+
+void RegisterASTSymbolFunctions(DatabaseInstance &instance) {
+    TableFunctionSet read_ast_symbols("read_ast_symbols");
+    read_ast_symbols.AddFunction(GetReadASTSymbolsFunction({LogicalType::ANY}));
+    read_ast_symbols.AddFunction(GetReadASTSymbolsFunction({LogicalType::ANY, LogicalType::VARCHAR}));
+    ExtensionUtil::RegisterFunction(instance, read_ast_symbols);
+
+    TableFunction ast_symbol_index("ast_symbol_index", {LogicalType::VARCHAR, LogicalType::ANY},
+                                   ASTSymbolIndexFunction, ASTSymbolIndexBind, ASTSymbolIndexInit);
+    ast_symbol_index.named_parameters["language"] = LogicalType::VARCHAR;
+    ast_symbol_index.named_parameters["ignore_errors"] = LogicalType::BOOLEAN;
+    ExtensionUtil::RegisterFunction(instance, ast_symbol_index);
+
+    for (idx_t i = 0; AST_SYMBOL_MACROS[i].name != nullptr; i++) {
+        auto info = DefaultTableFunctionGenerator::CreateTableMacroInfo(AST_SYMBOL_MACROS[i]);
+        ExtensionUtil::RegisterFunction(instance, *info);
+    }
+}
+
+} // namespace duckdb
@@ -0,0 +1,414 @@
+#include "ast_tar_archive.hpp"
+#include "ast_file_discovery.hpp"
+#include "ast_file_utils.hpp"
+#include "duckdb/common/exception.hpp"
+#include "duckdb/common/string_util.hpp"
+#include "duckdb/storage/object_cache.hpp"
+#include <algorithm>
+#include <cstring>
+
+namespace duckdb {
+
+//==============================================================================
+// Tar format
+//==============================================================================
+
+static constexpr idx_t TAR_BLOCK_SIZE = 512;
+
+// Header field offsets (POSIX ustar)
+static constexpr idx_t TAR_NAME = 0;
+static constexpr idx_t TAR_NAME_SIZE = 100;
+static constexpr idx_t TAR_SIZE = 124;
+static constexpr idx_t TAR_SIZE_SIZE = 12;
+static constexpr idx_t TAR_CHECKSUM = 148;
+static constexpr idx_t TAR_CHECKSUM_SIZE = 8;
+static constexpr idx_t TAR_TYPE = 156;
+static constexpr idx_t TAR_MAGIC = 257;
+static constexpr idx_t TAR_PREFIX = 345;
+static constexpr idx_t TAR_PREFIX_SIZE = 155;
+
+static idx_t TarPadding(idx_t size) {
+    return (TAR_BLOCK_SIZE - size % TAR_BLOCK_SIZE) % TAR_BLOCK_SIZE;
+}
+
+// Octal number field, or GNU base-256 when the high bit of the first byte is set
+static idx_t ParseTarNumber(const char *field, idx_t width) {
+    idx_t value = 0;
+    if (static_cast<uint8_t>(field[0]) & 0x80) {
+        value = static_cast<uint8_t>(field[0]) & 0x7f;
+        for (idx_t i = 1; i < width; i++) {
+            value = (value << 8) | static_cast<uint8_t>(field[i]);
+        }
+        return value;
+    }
+    for (idx_t i = 0; i < width && field[i] != '\0'; i++) {
+        if (field[i] >= '0' && field[i] <= '7') {
+            value = value * 8 + NumericCast<idx_t>(field[i] - '0');
+        }
+    }
+    return value;
+}
+
+static string TarString(const char *field, idx_t width) {
+    return string(field, strnlen(field, width));
+}
+
+// The "path" record of a pax extended header ("<length> path=<value>\n"), if any
+static string TarPaxPath(const string &data) {
+    idx_t pos = 0;
+    while (pos < data.size()) {
+        auto space = data.find(' ', pos);
+        if (space == string::npos) {
+            break;
+        }
+        auto length = NumericCast<idx_t>(std::strtoull(data.c_str() + pos, nullptr, 10));
+        if (length == 0 || pos + length > data.size()) {
+            break;
+        }
+        auto record = data.substr(space + 1, pos + length - space - 2); // Without the trailing newline
+        if (StringUtil::StartsWith(record, "path=")) {
+            return record.substr(5);
+        }
+        pos += length;
+    }
+    return string();
+}
+
+// Reads the headers and data of a tar stream front to back. Seekable (plain)
+// archives skip file data with seeks; compressed ones have to read through it.
+class ASTTarStream {
+public:
+    // A seekable stream needs the archive's size; compressed streams are read to their end
+    ASTTarStream(FileHandle &handle, const string &archive_path, bool seekable, idx_t file_size = 0)
+        : handle(handle), archive_path(archive_path), seekable(seekable), file_size(file_size) {
+    }
+
+    // Advance to the next regular file; false at the end of the archive
+    bool NextMember(ASTTarMember &member) {
+        string long_name; // From a GNU 'L' entry or a pax header, for the next member
+        char header[TAR_BLOCK_SIZE];
+        while (true) {
+            if (Read(header, TAR_BLOCK_SIZE) < TAR_BLOCK_SIZE || IsZeroBlock(header)) {
+                return false;
+            }
+            VerifyChecksum(header);
+            auto size = ParseTarNumber(header + TAR_SIZE, TAR_SIZE_SIZE);
+            auto type = header[TAR_TYPE];
+            if (type == 'L') {
+                auto data = ReadData(size);
+                long_name = string(data.c_str());
+                continue;
+            }
+            if (type == 'x') {
+                auto path = TarPaxPath(ReadData(size));
+                if (!path.empty()) {
+                    long_name = std::move(path);
+                }
+                continue;
+            }
+            if (type != '0' && type != '\0' && type != '7') {
+                // Directories, links, devices and global pax headers
+                Skip(size + TarPadding(size));
+                long_name.clear();
+                continue;
+            }
+            member.name = long_name.empty() ? HeaderName(header) : std::move(long_name);
+            if (StringUtil::StartsWith(member.name, "./")) {
+                member.name = member.name.substr(2);
+            }
+            member.offset = position;
+            member.size = size;
+            return true;
+        }
+    }
+
+    // Data of the member NextMember stopped at (with its padding consumed)
+    string ReadData(idx_t size) {
+        string data(size, '\0');
+        if (Read(&data[0], size) < size) {
+            throw IOException("Unexpected end of tar archive \"%s\"", archive_path);
+        }
+        Skip(TarPadding(size));
+        return data;
+    }
+
+    void SkipData(const ASTTarMember &member) {
+        Skip(member.size + TarPadding(member.size));
+    }
+
+private:
+    static bool IsZeroBlock(const char *block) {
+        for (idx_t i = 0; i < TAR_BLOCK_SIZE; i++) {
+            if (block[i] != '\0') {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void VerifyChecksum(const char *header) const {
+        // The checksum field itself counts as spaces
+        idx_t sum = ' ' * TAR_CHECKSUM_SIZE;
+        for (idx_t i = 0; i < TAR_BLOCK_SIZE; i++) {
+            if (i < TAR_CHECKSUM || i >= TAR_CHECKSUM + TAR_CHECKSUM_SIZE) {
+                sum += static_cast<uint8_t>(header[i]);
+            }
+        }
+        if (sum != ParseTarNumber(header + TAR_CHECKSUM, TAR_CHECKSUM_SIZE)) {
+            auto offset = std::to_string(position - TAR_BLOCK_SIZE);
+            throw IOException("Invalid tar header at offset " + offset + " of \"" + archive_path + "\"");
+        }
+    }
+
+    static string HeaderName(const char *header) {
+        auto name = TarString(header + TAR_NAME, TAR_NAME_SIZE);
+        if (memcmp(header + TAR_MAGIC, "ustar", 5) == 0) {
+            auto prefix = TarString(header + TAR_PREFIX, TAR_PREFIX_SIZE);
+            if (!prefix.empty()) {
+                return prefix + "/" + name;
+            }
+        }
+        return name;
+    }
+
+    idx_t Read(char *buffer, idx_t size) {
+        idx_t total = 0;
+        if (seekable) {
+            total = position < file_size ? MinValue<idx_t>(size, file_size - position) : 0;
+            if (total > 0) {
+                handle.Read(buffer, total, position);
+            }
+        } else {
+            while (total < size) {
+                auto bytes_read = handle.Read(buffer + total, size - total);
+                if (bytes_read <= 0) {
+                    break;
+                }
+                total += NumericCast<idx_t>(bytes_read);
+            }
+        }
+        position += total;
+        return total;
+    }
+
+    void Skip(idx_t size) {
+        if (seekable) {
+            position += size;
+            return;
+        }
+        char buffer[64 * 1024];
+        while (size > 0) {
+            auto chunk = MinValue<idx_t>(size, sizeof(buffer));
+            if (Read(buffer, chunk) < chunk) {
+                throw IOException("Unexpected end of tar archive \"%s\"", archive_path);
+            }
+            size -= chunk;
+        }
+    }
+
+    FileHandle &handle;
+    const string &archive_path;
+    const bool seekable;
+    const idx_t file_size;
+    idx_t position = 0;
+};
+
+//==============================================================================
+// Member index of plain archives
+//==============================================================================
+
+class ASTTarIndex : public ObjectCacheEntry {
+public:
+    static string ObjectType() {
+        return "sitting_duck_tar_index";
+    }
+
+    string GetObjectType() override {
+        return ObjectType();
+    }
+
+    idx_t file_size = 0;
+    int64_t last_modified = 0;
+    vector<ASTTarMember> members;
+};
+
+// The cached index of a plain archive, rebuilt when the archive changed
+static shared_ptr<ASTTarIndex> GetTarIndex(ClientContext &context, FileSystem &fs, FileHandle &handle,
+                                           const string &archive_path) {
+    auto file_size = NumericCast<idx_t>(fs.GetFileSize(handle));
+    auto last_modified = fs.GetLastModifiedTime(handle).value;
+
+    auto &cache = ObjectCache::GetObjectCache(context);
+    auto key = ASTTarIndex::ObjectType() + ":" + archive_path;
+    auto index = cache.Get<ASTTarIndex>(key);
+    if (index && index->file_size == file_size && index->last_modified == last_modified) {
+        return index;
+    }
+
+    index = make_shared_ptr<ASTTarIndex>();
+    index->file_size = file_size;
+    index->last_modified = last_modified;
+    ASTTarStream stream(handle, archive_path, true, file_size);
+    ASTTarMember member;
+    while (stream.NextMember(member)) {
+        stream.SkipData(member);
+        index->members.push_back(member);
+    }
+    cache.Put(key, index);
+    return index;
+}
+
+//==============================================================================
+// ASTTarArchives
+//==============================================================================
+
+ASTTarArchives::ASTTarArchives(ClientContext &context_p, vector<string> supported_extensions_p, ASTFileShard shard_p)
+    : context(context_p), supported_extensions(std::move(supported_extensions_p)), shard(shard_p), member_count(0) {
+}
+
+ASTTarArchives::~ASTTarArchives() {
+}
+
+static bool IsCompressedArchivePath(const string &path) {
+    auto lower = StringUtil::Lower(path);
+    return StringUtil::EndsWith(lower, ".tar.gz") || StringUtil::EndsWith(lower, ".tgz");
+}
+
+bool ASTTarArchives::IsArchivePath(const string &path) {
+    return StringUtil::EndsWith(StringUtil::Lower(path), ".tar") || IsCompressedArchivePath(path);
+}
+
+bool ASTTarArchives::SplitPattern(ClientContext &context, const string &pattern, string &archive,
+                                  string &member_pattern) {
+    auto &fs = FileSystem::GetFileSystem(context);
+    // Try each leading run of segments; only names that look like archives are stat'ed
+    for (idx_t end = pattern.find('/'); ; end = pattern.find('/', end + 1)) {
+        auto prefix = pattern.substr(0, end);
+        if (IsArchivePath(prefix) && !fs.HasGlob(prefix) && fs.FileExists(prefix)) {
+            archive = prefix;
+            member_pattern = end == string::npos ? string() : pattern.substr(end + 1);
+            return true;
+        }
+        if (end == string::npos) {
+            return false;
+        }
+    }
+}
+
+void ASTTarArchives::AddPattern(const string &archive, const string &member_pattern) {
+    auto &fs = FileSystem::GetFileSystem(context);
+    if (!IsArchivePath(archive)) {
+        throw InvalidInputException("Not a tar archive (.tar, .tar.gz or .tgz): %s", archive);
+    }
+    if (!fs.FileExists(archive)) {
+        throw IOException("Archive does not exist: %s", archive);
+    }
+    // Several patterns over one archive share a single pass through it
+    for (auto &existing : archives) {
+        if (existing->path == archive) {
+            existing->patterns.push_back(member_pattern);
+            return;
+        }
+    }
+    auto entry = make_uniq<Archive>();
+    entry->path = archive;
+    entry->compressed = IsCompressedArchivePath(archive);
+    entry->patterns.push_back(member_pattern);
+    archives.push_back(std::move(entry));
+}
+
+bool ASTTarArchives::Wants(const Archive &archive, const string &member_name) const {
+    if (!supported_extensions.empty() &&
+        !ASTFileUtils::IsFileExtensionSupported(member_name, supported_extensions)) {
+        return false;
+    }
+    for (auto &pattern : archive.patterns) {
+        if (pattern.empty() ? ASTFileUtils::DetectLanguageFromPath(member_name) != "auto"
+                            : ASTFileDiscovery::MatchPath(pattern, member_name)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static string MemberPath(const string &archive_path, const string &member_name) {
+    return archive_path + "/" + member_name;
+}
+
+void ASTTarArchives::Open(Archive &archive) {
+    auto &fs = FileSystem::GetFileSystem(context);
+    archive.opened = true;
+    if (archive.compressed) {
+        archive.handle = fs.OpenFile(archive.path, FileFlags::FILE_FLAGS_READ | FileCompressionType::GZIP);
+        archive.stream = make_uniq<ASTTarStream>(*archive.handle, archive.path, false);
+        return;
+    }
+    archive.handle = fs.OpenFile(archive.path, FileFlags::FILE_FLAGS_READ);
+    archive.index = GetTarIndex(context, fs, *archive.handle, archive.path);
+    for (idx_t i = 0; i < archive.index->members.size(); i++) {
+        auto &member_name = archive.index->members[i].name;
+        if (!Wants(archive, member_name)) {
+            continue;
+        }
+        auto member_path = MemberPath(archive.path, member_name);
+        if (shard.Contains(member_path)) {
+            archive.wanted.push_back(i);
+        } else {
+            member_count++;
+            member_paths.push_back(std::move(member_path));
+        }
+    }
+}
+
+bool ASTTarArchives::Next(string &file_path, string &content) {
+    std::unique_lock<std::mutex> guard(lock);
+    while (current_archive < archives.size()) {
+        auto &archive = *archives[current_archive];
+        if (!archive.opened) {
+            Open(archive);
+        }
+        if (!archive.compressed) {
+            if (archive.next_wanted < archive.wanted.size()) {
+                auto &member = archive.index->members[archive.wanted[archive.next_wanted++]];
+                auto &handle = *archive.handle;
+                file_path = MemberPath(archive.path, member.name);
+                member_count++;
+                member_paths.push_back(file_path);
+                // Positioned reads need no lock: the other workers read their members meanwhile
+                guard.unlock();
+                content.resize(member.size);
+                if (member.size > 0) {
+                    handle.Read(&content[0], member.size, member.offset);
+                }
+                return true;
+            }
+        } else {
+            // Decompressing holds the lock; workers that find it taken are still parsing
+            ASTTarMember member;
+            while (archive.stream->NextMember(member)) {
+                if (Wants(archive, member.name)) {
+                    file_path = MemberPath(archive.path, member.name);
+                    member_count++;
+                    member_paths.push_back(file_path);
+                    if (shard.Contains(file_path)) {
+                        content = archive.stream->ReadData(member.size);
+                        return true;
+                    }
+                }
+                archive.stream->SkipData(member);
+            }
+            archive.stream.reset();
+        }
+        current_archive++;
+    }
+    return false;
+}
+
+vector<string> ASTTarArchives::MemberPaths() {
+    std::lock_guard<std::mutex> guard(lock);
+    auto paths = member_paths;
+    std::sort(paths.begin(), paths.end());
+    return paths;
+}
+
+} // namespace duckdb
@@ -0,0 +1,351 @@
+#include "ast_tree_navigation_functions.hpp"
+#include "duckdb/common/exception.hpp"
+#include "duckdb/function/scalar_function.hpp"
+#include "duckdb/main/extension_util.hpp"
+#include "duckdb/planner/expression/bound_function_expression.hpp"
+#include <algorithm>
+
+namespace duckdb {
+
+//==============================================================================
+// Native tree navigation over per-file node lists
+//==============================================================================
+//
+// Replacements for the 06_tree_helpers.sql macros. Instead of self-joining the
+// whole node table (and recursing for ancestors), each call works on the node
+// list of one file as produced by read_ast_objects, where the list position of
+// a node is its node_id minus the first node's. The DFS invariants then answer
+// every query in time proportional to the answer:
+//   descendants  contiguous range [i + 1, i + descendant_count(i)]
+//   children     first child i + 1, next sibling c + descendant_count(c) + 1
+//   ancestors    parent_id chain
+// Lists with gaps in their ids (line_ranges extractions, filtered lists) work
+// too as long as they stay in node_id order: positions are then found by
+// binary search, and ranges never extend past the end of the list.
+// The node_id argument may also be a LIST(BIGINT) to answer many lookups in
+// one call; the result is then the union of the answers, in node order.
+
+enum class ASTNavigation : uint8_t {
+    CHILDREN,
+    DESCENDANTS,      // Including the node itself
+    SUBTREE,          // Excluding the node itself
+    SIBLINGS,         // Including the node itself
+    PARENT,
+    ANCESTORS,        // Root first, excluding the node itself
+    PATH_TO_NODE,     // Root first, including the node itself
+    NEAREST_ANCESTOR  // Closest ancestor with the given type
+};
+
+struct ASTNodeListBindData : public FunctionData {
+    idx_t node_id_field = DConstants::INVALID_INDEX;
+    idx_t parent_id_field = DConstants::INVALID_INDEX;
+    idx_t descendant_count_field = DConstants::INVALID_INDEX;
+    idx_t type_field = DConstants::INVALID_INDEX;
+
+    unique_ptr<FunctionData> Copy() const override {
+        return make_uniq<ASTNodeListBindData>(*this);
+    }
+    bool Equals(const FunctionData &other_p) const override {
+        auto &other = other_p.Cast<ASTNodeListBindData>();
+        return node_id_field == other.node_id_field && parent_id_field == other.parent_id_field &&
+               descendant_count_field == other.descendant_count_field && type_field == other.type_field;
+    }
+};
+
+static idx_t FindNodeField(const string &function_name, const LogicalType &node_type, const string &field_name,
+                           const LogicalType &field_type) {
+    auto &fields = StructType::GetChildTypes(node_type);
+    for (idx_t i = 0; i < fields.size(); i++) {
+        if (fields[i].first != field_name) {
+            continue;
+        }
+        if (fields[i].second != field_type) {
+            throw BinderException("%s: node field '%s' must be %s, not %s", function_name, field_name,
+                                  field_type.ToString(), fields[i].second.ToString());
+        }
+        return i;
+    }
+    throw BinderException("%s: node list has no '%s' field", function_name, field_name);
+}
+
+static unique_ptr<FunctionData> ASTNodeListBind(ClientContext &context, ScalarFunction &bound_function,
+                                                vector<unique_ptr<Expression>> &arguments) {
+    auto &list_type = arguments[0]->return_type;
+    if (list_type.id() != LogicalTypeId::LIST || ListType::GetChildType(list_type).id() != LogicalTypeId::STRUCT) {
+        throw BinderException("%s: first argument must be a node list such as read_ast_objects(...).nodes, not %s",
+                              bound_function.name, list_type.ToString());
+    }
+    auto &node_type = ListType::GetChildType(list_type);
+
+    auto result = make_uniq<ASTNodeListBindData>();
+    result->node_id_field = FindNodeField(bound_function.name, node_type, "node_id", LogicalType::BIGINT);
+    result->parent_id_field = FindNodeField(bound_function.name, node_type, "parent_id", LogicalType::BIGINT);
+    result->descendant_count_field =
+        FindNodeField(bound_function.name, node_type, "descendant_count", LogicalType::UINTEGER);
+    if (bound_function.arguments.size() > 2) {
+        result->type_field = FindNodeField(bound_function.name, node_type, "type", LogicalType::VARCHAR);
+    }
+
+    bound_function.arguments[0] = list_type;
+    bound_function.return_type = list_type;
+    return std::move(result);
+}
+
+// One file's nodes inside the flattened list child vector
+struct ASTNodeListView {
+    const char *function_name;
+    idx_t offset;
+    idx_t length;
+    const int64_t *node_ids;
+    const int64_t *parent_ids;
+    const ValidityMask *parent_validity;
+    const uint32_t *descendant_counts;
+
+    // Position of a node in the list; false when the id is not part of it
+    bool Find(int64_t node_id, idx_t &position) const {
+        if (length == 0 || node_id < node_ids[offset]) {
+            return false;
+        }
+        // Ids increase by at least one per position, so a node is never after
+        // node_id - first id, and is exactly there when the list has no gaps
+        position = NumericCast<idx_t>(node_id - node_ids[offset]);
+        if (position < length) {
+            if (node_ids[offset + position] == node_id) {
+                return true;
+            }
+            if (node_ids[offset + position] < node_id) {
+                throw InvalidInputException("%s: node list is not in read_ast order (node %lld at position %llu)",
+                                            function_name, node_ids[offset + position], position);
+            }
+        }
+        position = LowerBound(0, MinValue<idx_t>(position, length), node_id);
+        return position < length && node_ids[offset + position] == node_id;
+    }
+
+    // Position of the last node in the subtree of the node at `position`
+    idx_t SubtreeEnd(idx_t position) const {
+        const auto descendant_count = descendant_counts[offset + position];
+        const auto last_id = node_ids[offset + position] + int64_t(descendant_count);
+        const auto end = position + descendant_count;
+        if (end < length && node_ids[offset + end] == last_id) {
+            return end;
+        }
+        // Gaps or a truncated list: the last node with an id in the subtree's range
+        return LowerBound(position + 1, MinValue<idx_t>(end + 1, length), last_id + 1) - 1;
+    }
+
+    // First position in [begin, end) whose id is at least node_id
+    idx_t LowerBound(idx_t begin, idx_t end, int64_t node_id) const {
+        auto first = node_ids + offset;
+        return NumericCast<idx_t>(std::lower_bound(first + begin, first + end, node_id) - first);
+    }
+
+    bool Parent(idx_t position, idx_t &parent) const {
+        if (!parent_validity->RowIsValid(offset + position)) {
+            return false;
+        }
+        return Find(parent_ids[offset + position], parent);
+    }
+};
+
+static void AppendChildren(const ASTNodeListView &view, idx_t position, vector<idx_t> &positions) {
+    const auto end = view.SubtreeEnd(position);
+    for (auto child = position + 1; child <= end; child = view.SubtreeEnd(child) + 1) {
+        positions.push_back(child);
+    }
+}
+
+template <ASTNavigation OP>
+static void Navigate(const ASTNodeListView &view, idx_t position, const string_t *type, const string_t *types,
+                     vector<idx_t> &positions) {
+    switch (OP) {
+    case ASTNavigation::CHILDREN:
+        AppendChildren(view, position, positions);
+        break;
+    case ASTNavigation::DESCENDANTS:
+    case ASTNavigation::SUBTREE: {
+        const auto begin = OP == ASTNavigation::DESCENDANTS ? position : position + 1;
+        const auto end = view.SubtreeEnd(position);
+        for (auto i = begin; i <= end; i++) {
+            positions.push_back(i);
+        }
+        break;
+    }
+    case ASTNavigation::SIBLINGS: {
+        idx_t parent;
+        if (view.Parent(position, parent)) {
+            AppendChildren(view, parent, positions);
+        }
+        break;
+    }
+    case ASTNavigation::PARENT: {
+        idx_t parent;
+        if (view.Parent(position, parent)) {
+            positions.push_back(parent);
+        }
+        break;
+    }
+    case ASTNavigation::ANCESTORS:
+    case ASTNavigation::PATH_TO_NODE: {
+        // The parent chain is collected bottom-up; reverse it so the root comes first
+        const auto first = positions.size();
+        if (OP == ASTNavigation::PATH_TO_NODE) {
+            positions.push_back(position);
+        }
+        idx_t current = position;
+        while (view.Parent(current, current)) {
+            positions.push_back(current);
+        }
+        std::reverse(positions.begin() + NumericCast<int64_t>(first), positions.end());
+        break;
+    }
+    case ASTNavigation::NEAREST_ANCESTOR: {
+        idx_t current = position;
+        while (view.Parent(current, current)) {
+            if (types[view.offset + current] == *type) {
+                positions.push_back(current);
+                break;
+            }
+        }
+        break;
+    }
+    }
+}
+
+template <ASTNavigation OP>
+static void ASTNavigationFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+    auto &func_expr = state.expr.Cast<BoundFunctionExpression>();
+    auto &bind_data = func_expr.bind_info->Cast<ASTNodeListBindData>();
+    const auto count = args.size();
+
+    // Flatten the node fields once for the whole chunk
+    auto &nodes_vector = args.data[0];
+    UnifiedVectorFormat list_format;
+    nodes_vector.ToUnifiedFormat(count, list_format);
+    auto list_entries = UnifiedVectorFormat::GetData<list_entry_t>(list_format);
+    auto &node_vector = ListVector::GetEntry(nodes_vector);
+    const auto node_count = ListVector::GetListSize(nodes_vector);
+    node_vector.Flatten(node_count);
+    auto &fields = StructVector::GetEntries(node_vector);
+    fields[bind_data.node_id_field]->Flatten(node_count);
+    fields[bind_data.parent_id_field]->Flatten(node_count);
+    fields[bind_data.descendant_count_field]->Flatten(node_count);
+    const string_t *types = nullptr;
+    if (OP == ASTNavigation::NEAREST_ANCESTOR) {
+        fields[bind_data.type_field]->Flatten(node_count);
+        types = FlatVector::GetData<string_t>(*fields[bind_data.type_field]);
+    }
+
+    ASTNodeListView view;
+    view.function_name = func_expr.function.name.c_str();
+    view.node_ids = FlatVector::GetData<int64_t>(*fields[bind_data.node_id_field]);
+    view.parent_ids = FlatVector::GetData<int64_t>(*fields[bind_data.parent_id_field]);
+    view.parent_validity = &FlatVector::Validity(*fields[bind_data.parent_id_field]);
+    view.descendant_counts = FlatVector::GetData<uint32_t>(*fields[bind_data.descendant_count_field]);
+
+    // node_id argument: BIGINT or LIST(BIGINT) for batched lookups
+    auto &ids_vector = args.data[1];
+    const bool batched = ids_vector.GetType().id() == LogicalTypeId::LIST;
+    UnifiedVectorFormat ids_format;
+    ids_vector.ToUnifiedFormat(count, ids_format);
+    UnifiedVectorFormat id_values_format;
+    if (batched) {
+        ListVector::GetEntry(ids_vector).ToUnifiedFormat(ListVector::GetListSize(ids_vector), id_values_format);
+    } else {
+        ids_vector.ToUnifiedFormat(count, id_values_format);
+    }
+    auto id_values = UnifiedVectorFormat::GetData<int64_t>(id_values_format);
+
+    UnifiedVectorFormat type_format;
+    if (OP == ASTNavigation::NEAREST_ANCESTOR) {
+        args.data[2].ToUnifiedFormat(count, type_format);
+    }
+
+    result.SetVectorType(VectorType::FLAT_VECTOR);
+    auto result_entries = FlatVector::GetData<list_entry_t>(result);
+    auto &result_validity = FlatVector::Validity(result);
+    vector<idx_t> positions;
+    for (idx_t row = 0; row < count; row++) {
+        auto list_idx = list_format.sel->get_index(row);
+        auto ids_idx = ids_format.sel->get_index(row);
+        if (!list_format.validity.RowIsValid(list_idx) || !ids_format.validity.RowIsValid(ids_idx)) {
+            result_validity.SetInvalid(row);
+            continue;
+        }
+        const string_t *type = nullptr;
+        if (OP == ASTNavigation::NEAREST_ANCESTOR) {
+            auto type_idx = type_format.sel->get_index(row);
+            if (!type_format.validity.RowIsValid(type_idx)) {
+                result_validity.SetInvalid(row);
+                continue;
+            }
+            type = UnifiedVectorFormat::GetData<string_t>(type_format) + type_idx;
+        }
+        view.offset = list_entries[list_idx].offset;
+        view.length = list_entries[list_idx].length;
+
+        // Collect the answer as list positions
+        positions.clear();
+        idx_t id_begin = ids_idx;
+        idx_t id_end = ids_idx + 1;
+        if (batched) {
+            auto &ids_entry = UnifiedVectorFormat::GetData<list_entry_t>(ids_format)[ids_idx];
+            id_begin = ids_entry.offset;
+            id_end = ids_entry.offset + ids_entry.length;
+        }
+        for (auto i = id_begin; i < id_end; i++) {
+            auto id_idx = batched ? id_values_format.sel->get_index(i) : i;
+            if (!id_values_format.validity.RowIsValid(id_idx)) {
+                continue;
+            }
+            idx_t position;
+            if (view.Find(id_values[id_idx], position)) {
+                Navigate<OP>(view, position, type, types, positions);
+            }
+        }
+        if (batched && id_end - id_begin > 1) {
+            std::sort(positions.begin(), positions.end());
+            positions.erase(std::unique(positions.begin(), positions.end()), positions.end());
+        }
+
+        // Copy the selected nodes into the result list
+        const auto result_offset = ListVector::GetListSize(result);
+        SelectionVector sel(positions.size());
+        for (idx_t i = 0; i < positions.size(); i++) {
+            sel.set_index(i, view.offset + positions[i]);
+        }
+        ListVector::Append(result, node_vector, sel, positions.size());
+        result_entries[row].offset = result_offset;
+        result_entries[row].length = positions.size();
+    }
+    if (args.AllConstant()) {
+        result.SetVectorType(VectorType::CONSTANT_VECTOR);
+    }
+}
+
+template <ASTNavigation OP>
+static void RegisterNavigationFunction(DatabaseInstance &instance, const string &name,
+                                       const vector<LogicalType> &extra_arguments = {}) {
+    ScalarFunctionSet set(name);
+    vector<LogicalType> id_types {LogicalType::BIGINT, LogicalType::LIST(LogicalType::BIGINT)};
+    for (auto &id_type : id_types) {
+        vector<LogicalType> arguments {LogicalType::ANY, id_type};
+        arguments.insert(arguments.end(), extra_arguments.begin(), extra_arguments.end());
+        set.AddFunction(ScalarFunction(arguments, LogicalType::ANY, ASTNavigationFunction<OP>, ASTNodeListBind));
+    }
+    ExtensionUtil::RegisterFunction(instance, set);
+}
+
+void RegisterASTTreeNavigationFunctions(DatabaseInstance &instance) {
+    RegisterNavigationFunction<ASTNavigation::CHILDREN>(instance, "ast_get_children");
+    RegisterNavigationFunction<ASTNavigation::DESCENDANTS>(instance, "ast_get_descendants");
+    RegisterNavigationFunction<ASTNavigation::SUBTREE>(instance, "ast_get_subtree");
+    RegisterNavigationFunction<ASTNavigation::SIBLINGS>(instance, "ast_get_siblings");
+    RegisterNavigationFunction<ASTNavigation::PARENT>(instance, "ast_get_parent");
+    RegisterNavigationFunction<ASTNavigation::ANCESTORS>(instance, "ast_get_ancestors");
+    RegisterNavigationFunction<ASTNavigation::PATH_TO_NODE>(instance, "ast_get_path_to_node");
+    RegisterNavigationFunction<ASTNavigation::NEAREST_ANCESTOR>(instance, "ast_find_nearest_ancestor",
+                                                                {LogicalType::VARCHAR});
+}
+
+} // namespace duckdb
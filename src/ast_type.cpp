@@ -3,6 +3,7 @@
 #include "duckdb/common/types/value.hpp"
 #include "duckdb/common/vector.hpp"
 #include "duckdb/common/string_util.hpp"
+#include "duckdb/main/extension_util.hpp"
 #include <sstream>
 
 namespace duckdb {
@@ -24,6 +25,8 @@ Value ASTNode::ToValue() const {
     source_values.emplace_back("start_column", Value::UINTEGER(source.start_column));
     source_values.emplace_back("end_line", Value::UINTEGER(source.end_line));
     source_values.emplace_back("end_column", Value::UINTEGER(source.end_column));
+    source_values.emplace_back("start_byte", Value::UINTEGER(source.start_byte));
+    source_values.emplace_back("end_byte", Value::UINTEGER(source.end_byte));
     struct_values.emplace_back("source", Value::STRUCT(move(source_values)));
     
     // Tree structure struct
@@ -440,10 +443,14 @@ void ASTNode::UpdateTaxonomyFields() {
 
 // Static method implementations moved to header as inline functions
 
-// Type registration will be implemented in extension initialization
+LogicalType GetASTLogicalType() {
+    auto type = LogicalType(LogicalTypeId::BLOB);
+    type.SetAlias("AST");
+    return type;
+}
+
 void RegisterASTType(DatabaseInstance &db) {
-    // This will be implemented when we add the custom type to DuckDB
-    // For now, we'll use serialization to Value
+    ExtensionUtil::RegisterType(db, "AST", GetASTLogicalType());
 }
 
 } // namespace duckdb
\ No newline at end of file
@@ -0,0 +1,195 @@
+#pragma once
+
+#include "duckdb.hpp"
+#include "unified_ast_backend.hpp"
+
+namespace duckdb {
+
+//==============================================================================
+// Compact binary AST encoding
+//==============================================================================
+//
+// Layout (all integers little-endian, no alignment padding):
+//
+//   header      magic, version, flags, node_count, string_count, max_depth,
+//               file_path and language string ids
+//   columns     one fixed-width array per field, node_count entries each,
+//               in ASTBinaryColumn order (strings are dictionary ids)
+//   dictionary  uint32 offsets[string_count + 1], then the string bytes;
+//               id 0 is always the empty string
+//   hashes      only with FLAG_HASHES: uint64 subtree_hash[node_count],
+//               then uint64 shape_hash[node_count]
+//   native      uint32 count, uint32 node_index[count] (ascending),
+//               uint32 entry_offset[count], then the encoded entries
+//
+// Because nodes keep the DFS order of the walker, the subtree of node i is
+// the contiguous range [i, i + descendant_count(i)] of every column.
+
+enum class ASTBinaryColumn : uint8_t {
+    TYPE = 0,
+    NAME,
+    PEEK,
+    START_LINE,
+    START_COLUMN,
+    END_LINE,
+    END_COLUMN,
+    PARENT_ID,
+    DEPTH,
+    SIBLING_INDEX,
+    CHILDREN_COUNT,
+    DESCENDANT_COUNT,
+    SEMANTIC_TYPE,
+    UNIVERSAL_FLAGS,
+    ARITY_BIN,
+    START_BYTE,
+    END_BYTE,
+    COLUMN_COUNT
+};
+
+struct ASTBinaryFormat {
+    static constexpr uint32_t MAGIC = 0x54534144; // "DAST"
+    static constexpr uint16_t VERSION = 2; // 2: START_BYTE / END_BYTE columns
+    static constexpr uint16_t FLAG_HASHES = 0x01; // Merkle subtree hashes are present
+    static constexpr uint16_t FLAG_TRUNCATED = 0x02; // A max_nodes prefix of the file's tree
+
+    // Encode a parse result
+    static string Serialize(const ASTResult &result);
+
+    // Decode a full parse result (throws InvalidInputException on malformed input)
+    static ASTResult Deserialize(const_data_ptr_t data, idx_t size);
+
+    // Byte width of one value in the given column
+    static idx_t ColumnWidth(ASTBinaryColumn column);
+};
+
+// Zero-copy view over an encoded AST; accessors read straight from the buffer.
+// The buffer must outlive the reader.
+class ASTBinaryReader {
+public:
+    ASTBinaryReader(const_data_ptr_t data, idx_t size);
+
+    idx_t NodeCount() const {
+        return node_count;
+    }
+    uint32_t MaxDepth() const {
+        return max_depth;
+    }
+    string FilePath() const;
+    string Language() const;
+
+    // Dictionary access
+    uint32_t StringCount() const {
+        return string_count;
+    }
+    string_t GetStringRef(uint32_t id) const;
+    string GetString(uint32_t id) const {
+        return GetStringRef(id).GetString();
+    }
+
+    // Column access
+    uint32_t TypeId(idx_t node) const {
+        return Read<uint32_t>(ASTBinaryColumn::TYPE, node);
+    }
+    uint32_t NameId(idx_t node) const {
+        return Read<uint32_t>(ASTBinaryColumn::NAME, node);
+    }
+    uint32_t PeekId(idx_t node) const {
+        return Read<uint32_t>(ASTBinaryColumn::PEEK, node);
+    }
+    uint32_t StartLine(idx_t node) const {
+        return Read<uint32_t>(ASTBinaryColumn::START_LINE, node);
+    }
+    uint32_t StartColumn(idx_t node) const {
+        return Read<uint32_t>(ASTBinaryColumn::START_COLUMN, node);
+    }
+    uint32_t EndLine(idx_t node) const {
+        return Read<uint32_t>(ASTBinaryColumn::END_LINE, node);
+    }
+    uint32_t EndColumn(idx_t node) const {
+        return Read<uint32_t>(ASTBinaryColumn::END_COLUMN, node);
+    }
+    uint32_t StartByte(idx_t node) const {
+        return Read<uint32_t>(ASTBinaryColumn::START_BYTE, node);
+    }
+    uint32_t EndByte(idx_t node) const {
+        return Read<uint32_t>(ASTBinaryColumn::END_BYTE, node);
+    }
+    int64_t ParentId(idx_t node) const {
+        return Read<int64_t>(ASTBinaryColumn::PARENT_ID, node);
+    }
+    uint32_t Depth(idx_t node) const {
+        return Read<uint32_t>(ASTBinaryColumn::DEPTH, node);
+    }
+    uint32_t SiblingIndex(idx_t node) const {
+        return Read<uint32_t>(ASTBinaryColumn::SIBLING_INDEX, node);
+    }
+    uint32_t ChildrenCount(idx_t node) const {
+        return Read<uint32_t>(ASTBinaryColumn::CHILDREN_COUNT, node);
+    }
+    uint32_t DescendantCount(idx_t node) const {
+        return Read<uint32_t>(ASTBinaryColumn::DESCENDANT_COUNT, node);
+    }
+    // Last node of the subtree [node, node + descendant_count]. The range is checked
+    // here, not when the reader is opened, so opening a value stays O(1).
+    idx_t SubtreeEnd(idx_t node) const;
+    uint8_t SemanticType(idx_t node) const {
+        return Read<uint8_t>(ASTBinaryColumn::SEMANTIC_TYPE, node);
+    }
+    uint8_t UniversalFlags(idx_t node) const {
+        return Read<uint8_t>(ASTBinaryColumn::UNIVERSAL_FLAGS, node);
+    }
+    uint8_t ArityBin(idx_t node) const {
+        return Read<uint8_t>(ASTBinaryColumn::ARITY_BIN, node);
+    }
+
+    // Merkle hashes (0 when the AST was parsed without hashes)
+    // Whether the nodes are a max_nodes prefix of the file's tree
+    bool Truncated() const {
+        return truncated;
+    }
+
+    bool HasHashes() const {
+        return subtree_hashes != nullptr;
+    }
+    uint64_t SubtreeHash(idx_t node) const {
+        return subtree_hashes ? Load<uint64_t>(subtree_hashes + node * sizeof(uint64_t)) : 0;
+    }
+    uint64_t ShapeHash(idx_t node) const {
+        return shape_hashes ? Load<uint64_t>(shape_hashes + node * sizeof(uint64_t)) : 0;
+    }
+
+    // Native context of a node (empty NativeContext when none was extracted)
+    NativeContext GetNativeContext(idx_t node) const;
+
+    // Materialize a single node / the whole result
+    ASTNode GetNode(idx_t node) const;
+    ASTResult ToASTResult() const;
+
+private:
+    template <class T>
+    T Read(ASTBinaryColumn column, idx_t node) const {
+        D_ASSERT(node < node_count);
+        return Load<T>(column_data[static_cast<idx_t>(column)] + node * sizeof(T));
+    }
+
+    const_data_ptr_t data;
+    idx_t size;
+    idx_t node_count;
+    uint32_t string_count;
+    uint32_t max_depth;
+    uint32_t file_path_id;
+    uint32_t language_id;
+    bool truncated;
+
+    const_data_ptr_t column_data[static_cast<idx_t>(ASTBinaryColumn::COLUMN_COUNT)];
+    const_data_ptr_t string_offsets;
+    const_data_ptr_t string_data;
+    const_data_ptr_t subtree_hashes = nullptr;
+    const_data_ptr_t shape_hashes = nullptr;
+    uint32_t native_count;
+    const_data_ptr_t native_nodes;
+    const_data_ptr_t native_offsets;
+    const_data_ptr_t native_data;
+};
+
+} // namespace duckdb
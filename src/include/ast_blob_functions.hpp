@@ -0,0 +1,12 @@
+#pragma once
+
+#include "duckdb.hpp"
+
+namespace duckdb {
+
+// Register the AST BLOB functions: parse_ast_blob, read_ast_blob and the
+// native accessors (ast_node_count, ast_children, ast_descendants,
+// ast_find_type, ast_functions, ast_subtree)
+void RegisterASTBlobFunctions(DatabaseInstance &instance);
+
+} // namespace duckdb
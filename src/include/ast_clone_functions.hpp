@@ -0,0 +1,11 @@
+#pragma once
+
+#include "duckdb.hpp"
+
+namespace duckdb {
+
+// Register ast_subtree_hashes (per-subtree Merkle hashes) and the ast_clones
+// table macro that groups identical subtrees across files
+void RegisterASTCloneFunctions(DatabaseInstance &instance);
+
+} // namespace duckdb
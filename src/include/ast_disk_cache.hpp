@@ -0,0 +1,40 @@
+#pragma once
+
+#include "duckdb.hpp"
+#include "unified_ast_backend.hpp"
+#include <functional>
+
+namespace duckdb {
+
+class FileSystem;
+
+// Persistent cache of parse results in a directory (SET sitting_duck_cache_dir).
+//
+// Each cache file holds one parsed source file in ASTBinaryFormat, preceded by a
+// header with the source file's size, mtime and content hash. A matching size and
+// mtime is a hit without touching the source; a changed mtime with an unchanged
+// content hash is still a hit, and the header is refreshed.
+class ASTDiskCache {
+public:
+    static constexpr uint32_t MAGIC = 0x43415344; // "DSAC"
+    static constexpr uint16_t VERSION = 1;
+
+    // Cache file for a (path, language, config) identity
+    static string GetCacheFilePath(FileSystem &fs, const string &cache_dir, const string &identity);
+
+    // Load a cached result. `load_content` reads the source file and is only called
+    // when the mtime changed and the content hash has to be compared.
+    static bool TryLoad(FileSystem &fs, const string &cache_dir, const string &identity, idx_t file_size,
+                        int64_t last_modified, const std::function<const string &()> &load_content,
+                        ASTResult &result);
+
+    // Save a result; failures are ignored since the cache is only an optimization
+    static bool Save(FileSystem &fs, const string &cache_dir, const string &identity, idx_t file_size,
+                     int64_t last_modified, hash_t content_hash, const ASTResult &result);
+
+    // Save an already encoded result
+    static bool StoreEncoded(FileSystem &fs, const string &cache_dir, const string &identity, idx_t file_size,
+                             int64_t last_modified, hash_t content_hash, const string &encoded);
+};
+
+} // namespace duckdb
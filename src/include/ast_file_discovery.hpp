@@ -0,0 +1,139 @@
+#pragma once
+
+#include "duckdb.hpp"
+#include "duckdb/main/client_context.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <unordered_set>
+
+namespace duckdb {
+
+// One of `count` fixed partitions of a file list. A file's shard depends only
+// on its path, through a hash that is the same on every platform and release,
+// so shards can run on different machines, in any order, and be re-run alone.
+struct ASTFileShard {
+    idx_t count = 1;
+    idx_t index = 0;
+
+    bool IsActive() const {
+        return count > 1;
+    }
+
+    bool Contains(const string &file_path) const {
+        return !IsActive() || PathHash(file_path) % count == index;
+    }
+
+    static uint64_t PathHash(const string &file_path);
+};
+
+// Pruning applied while walking: excluded directories are never listed
+struct ASTDiscoveryOptions {
+    // Globs; without a '/' they match a file or directory name at any depth
+    // ("node_modules", "*.min.js"), otherwise the whole path ("src/gen/**")
+    vector<string> exclude;
+    // Honor .gitignore and .ignore files found during walks, and skip .git
+    bool respect_gitignore = false;
+    // Only files of this shard are returned (they still count in FileCount)
+    ASTFileShard shard;
+};
+
+struct ASTIgnoreRules;
+
+// Parallel file discovery for the AST table functions.
+//
+// Patterns are classified once: plain files are emitted right away, while
+// directories and local glob patterns become walks. A walk lists one
+// directory at a time with FileSystem::ListFiles, whose callback already says
+// whether an entry is a directory, so no entry is stat'ed a second time.
+// Subdirectories that can still match the pattern go back on the shared
+// queue, so any number of threads can list directories at once.
+//
+// Found files are queued as well: a consumer can take them while the walk is
+// still running (see DiscoverAndParseFilesParallel), or wait for the whole
+// walk with DiscoverAll. Files matched by several patterns are returned once.
+//
+// Exclusions and ignore files are checked before a directory is queued, so
+// pruned trees cost one name match instead of a listing per directory.
+class ASTFileDiscovery {
+public:
+    ASTFileDiscovery(ClientContext &context, vector<string> supported_extensions, bool ignore_errors,
+                     ASTDiscoveryOptions options = ASTDiscoveryOptions());
+    ~ASTFileDiscovery();
+
+    // Whether the patterns need a walk; explicit file lists are cheaper to
+    // handle with ASTFileUtils directly
+    static bool NeedsWalk(ClientContext &context, const vector<string> &patterns);
+
+    // Emit plain files and queue the walks. Missing non-glob paths throw
+    // unless ignore_errors is set.
+    void AddPatterns(const vector<string> &patterns);
+
+    // List one pending directory; false when no directory is pending right now
+    bool WalkDirectory();
+
+    // Take the next discovered file; false when none is queued right now
+    bool NextFile(string &file_path);
+
+    // True once no directory is pending or being listed: every file is known
+    bool WalkFinished();
+
+    // Block until a directory is pending or the walk is finished, or with
+    // wake_on_files also until a file is queued. For workers that found nothing
+    // to do while another thread lists a directory that may add more work.
+    void WaitForWork(bool wake_on_files);
+
+    // Whether a relative path matches a glob, with the walk's rules ("**" spans
+    // any number of directories); used for paths that are not walked, e.g. archive members
+    static bool MatchPath(const string &pattern, const string &path);
+
+    // Walk on all scheduler threads and return every file, sorted
+    vector<string> DiscoverAll();
+
+    // Number of distinct files found so far, in any shard
+    idx_t FileCount() const {
+        return file_count.load();
+    }
+
+    // Every distinct file found so far, in any shard, sorted
+    vector<string> AllFiles();
+
+private:
+    struct Walk {
+        vector<string> segments; // Glob segments below the base directory, "**" = any depth
+    };
+
+    struct PendingDirectory {
+        string path;
+        idx_t walk_index;
+        vector<string> relative;                    // Names between the walk's base and this directory
+        shared_ptr<const ASTIgnoreRules> ignore_rules; // Innermost ignore file in effect, if any
+    };
+
+    void AddPattern(const string &pattern);
+    void AddWalk(const string &base, vector<string> segments);
+    void EmitFile(const string &file_path);
+    bool IsExcluded(const string &path, const string &name, bool is_directory,
+                    const ASTIgnoreRules *ignore_rules) const;
+    shared_ptr<const ASTIgnoreRules> LoadIgnoreRules(const string &directory, bool has_gitignore, bool has_ignore,
+                                                     shared_ptr<const ASTIgnoreRules> parent);
+
+    ClientContext &context;
+    const vector<string> supported_extensions;
+    const bool ignore_errors;
+    const ASTDiscoveryOptions options;
+    shared_ptr<const ASTIgnoreRules> exclude_rules; // options.exclude, parsed
+
+    vector<Walk> walks;
+
+    std::mutex lock;
+    std::condition_variable work_added; // A directory or file was queued, or a listing ended
+    std::deque<PendingDirectory> pending_directories;
+    idx_t active_walkers = 0;
+    std::deque<string> found_files;
+    std::unordered_set<string> seen_files;
+    std::atomic<idx_t> file_count;
+};
+
+} // namespace duckdb
@@ -4,8 +4,81 @@
 #include "duckdb/common/file_system.hpp"
 #include "duckdb/main/client_context.hpp"
 
+namespace duckdb_re2 {
+class RE2;
+}
+
 namespace duckdb {
 
+/**
+ * @brief Raw-content prefilter (read_ast content_filter): files whose bytes
+ * do not match are skipped before they are parsed
+ */
+struct ASTContentFilter {
+    string pattern;
+    bool is_regex = false;
+    shared_ptr<duckdb_re2::RE2> regex;
+
+    /**
+     * @brief Build a filter for content_filter / content_filter_mode ('literal' or 'regex')
+     *
+     * Throws BinderException for an unknown mode or an invalid regular expression.
+     */
+    static ASTContentFilter Create(const string &pattern, const string &mode);
+
+    /**
+     * @brief Whether the content contains the literal, or a match of the regex
+     * (`^` and `$` match at line boundaries)
+     */
+    bool Matches(const string &content) const;
+};
+
+/**
+ * @brief Cheap pre-parse screen (read_ast skip_generated / max_file_size /
+ * max_nodes): only the size and the first few KB of a file are looked at
+ */
+struct ASTFileScreen {
+    //! Bytes read to classify a file
+    static constexpr idx_t SAMPLE_SIZE = 8192;
+    //! Average line length from which a sample counts as minified
+    static constexpr idx_t MINIFIED_LINE_LENGTH = 500;
+
+    bool skip_generated = false;
+    idx_t max_file_size = 0; // 0 = no limit
+    idx_t max_nodes = 0;     // Per-file node budget, 0 = no limit
+
+    bool IsActive() const {
+        return skip_generated || max_file_size > 0 || max_nodes > 0;
+    }
+
+    /**
+     * @brief Read skip_generated / max_file_size / max_nodes if `name` is one of them
+     *
+     * Throws BinderException for negative limits.
+     *
+     * @return bool True if the parameter was consumed
+     */
+    bool SetOption(const string &name, const Value &value);
+
+    /**
+     * @brief Why a file should not be parsed: "too_large", "binary", "minified"
+     * or "generated", or an empty string to parse it
+     */
+    string Check(ClientContext &context, const string &file_path) const;
+
+    /**
+     * @brief Same as Check for a file that is already in memory (e.g. an archive member)
+     */
+    string CheckContent(const string &file_path, const string &content) const;
+
+    /**
+     * @brief Classify a file from its name and leading bytes: "binary" (NUL bytes),
+     * "minified" (.min. names, very long lines), "generated" (lockfiles, generator
+     * banners such as "@generated" or "DO NOT EDIT"), or an empty string
+     */
+    static string Classify(const string &file_path, const char *data, idx_t size);
+};
+
 /**
  * @brief Utility class for handling file operations in AST functions
  * 
@@ -30,6 +103,8 @@ public:
     /**
      * @brief Get files from multiple patterns
      *
+     * Directories and local globs are walked in parallel (see ASTFileDiscovery).
+     *
      * @param context Client context for file operations
      * @param patterns Vector of file patterns/paths to process
      * @param ignore_errors Whether to ignore missing files
@@ -76,19 +151,32 @@ public:
      */
     static vector<string> GetSupportedExtensions(const string &language);
 
-private:
     /**
-     * @brief Process a single path (file, directory, or glob pattern)
+     * @brief Read the remaining content of an open file
+     *
+     * @param fs File system the handle belongs to
+     * @param handle Open file handle
+     * @param file_size Number of bytes to read
+     * @return string File content
+     */
+    static string ReadFileContent(FileSystem &fs, FileHandle &handle, idx_t file_size);
+
+    /**
+     * @brief Read a whole file through DuckDB's file system
      *
      * @param context Client context for file operations
-     * @param path Single path to process
-     * @param supported_extensions List of supported file extensions
-     * @param ignore_errors Whether to ignore missing files
-     * @return vector<string> List of matching files
+     * @param file_path Path to the file
+     * @return string File content
      */
-    static vector<string> ProcessSinglePath(ClientContext &context, const string &path,
-                                           const vector<string> &supported_extensions,
-                                           bool ignore_errors);
+    static string ReadFile(ClientContext &context, const string &file_path);
+
+    /**
+     * @brief Output value of an optional name: NULL for an empty string
+     *
+     * @param value Name, empty when the node has none
+     * @return Value VARCHAR value, NULL if value is empty
+     */
+    static Value OptionalString(const string &value);
 
     /**
      * @brief Check if a file extension is in the supported extensions list
@@ -98,6 +186,20 @@ private:
      * @return bool True if the extension is supported
      */
     static bool IsFileExtensionSupported(const string &file_path, const vector<string> &supported_extensions);
+
+private:
+    /**
+     * @brief Process a single path (file, directory, or glob pattern)
+     *
+     * @param context Client context for file operations
+     * @param path Single path to process
+     * @param supported_extensions List of supported file extensions
+     * @param ignore_errors Whether to ignore missing files
+     * @return vector<string> List of matching files
+     */
+    static vector<string> ProcessSinglePath(ClientContext &context, const string &path,
+                                           const vector<string> &supported_extensions,
+                                           bool ignore_errors);
 };
 
 } // namespace duckdb
\ No newline at end of file
@@ -0,0 +1,75 @@
+#pragma once
+
+#include "duckdb.hpp"
+#include "duckdb/common/file_system.hpp"
+#include "duckdb/main/client_context.hpp"
+#include <mutex>
+
+namespace duckdb {
+
+// A file in a commit's tree
+struct ASTGitTreeEntry {
+    string path;    // Relative to the repository root
+    string blob_id; // Raw 20-byte object id
+};
+
+class ASTGitPack;
+
+// Read-only access to a local git object store, without a checkout or a git
+// binary. Loose objects and packfiles (v2 indexes, offset and ref deltas) are
+// inflated with the zlib DuckDB bundles.
+//
+// Trees are listed recursively, and a subtree that several commits share is
+// listed once. Blobs can be read from any number of threads: pack data is
+// read with positioned reads, and only the delta base cache is locked.
+class ASTGitRepository {
+public:
+    // `path` is a working tree (with a .git directory or gitdir file) or a bare repository
+    ASTGitRepository(ClientContext &context, const string &path);
+    ~ASTGitRepository();
+
+    // Commit id named by a revision: a full or abbreviated object id, HEAD, a
+    // branch, tag or other ref, each optionally followed by ~N and ^N steps.
+    // Tags are peeled to the commit they point at.
+    string ResolveRevision(const string &revision);
+
+    // Every regular file of a commit's tree; symlinks and submodules are skipped
+    void ListFiles(const string &commit_id, vector<ASTGitTreeEntry> &entries);
+
+    // Content of a blob
+    string ReadBlob(const string &blob_id);
+
+    static string ToHex(const string &object_id);
+
+private:
+    enum class ObjectType : uint8_t { NONE = 0, COMMIT = 1, TREE = 2, BLOB = 3, TAG = 4 };
+
+    void ReadObject(const string &object_id, ObjectType &type, string &data);
+    bool ReadLooseObject(const string &object_id, ObjectType &type, string &data);
+    void ReadPackObject(ASTGitPack &pack, idx_t offset, ObjectType &type, string &data, idx_t depth);
+    shared_ptr<const string> DeltaBase(ASTGitPack &pack, idx_t offset, ObjectType &type, idx_t depth);
+    void LoadPacks();
+
+    string ReadRef(const string &name, idx_t depth);
+    string ResolveName(const string &name);
+    string FindByPrefix(const string &hex_prefix);
+    string Peel(string object_id);
+    string Parent(const string &commit_id, idx_t parent_number);
+    shared_ptr<vector<ASTGitTreeEntry>> ListTree(const string &tree_id);
+
+    ClientContext &context;
+    FileSystem &fs;
+    string git_dir;    // HEAD and per-worktree refs
+    string common_dir; // Objects and shared refs
+    vector<unique_ptr<ASTGitPack>> packs;
+    unordered_map<string, string> packed_refs;
+    bool packed_refs_loaded = false;
+    unordered_map<string, shared_ptr<vector<ASTGitTreeEntry>>> listed_trees;
+
+    // Recently used delta bases, by pack and offset
+    std::mutex base_lock;
+    unordered_map<string, pair<ObjectType, shared_ptr<const string>>> base_cache;
+    idx_t base_cache_size = 0;
+};
+
+} // namespace duckdb
@@ -0,0 +1,12 @@
+#pragma once
+
+#include "duckdb.hpp"
+
+namespace duckdb {
+
+// Register ast_node_at(file_path, line, column) and its range form
+// ast_node_at(file_path, start_line, start_column, end_line, end_column):
+// the innermost node at a source position followed by its ancestors
+void RegisterASTNodeAtFunctions(DatabaseInstance &instance);
+
+} // namespace duckdb
@@ -0,0 +1,148 @@
+#pragma once
+
+#include "duckdb.hpp"
+#include "duckdb/storage/object_cache.hpp"
+#include "duckdb/storage/buffer/block_handle.hpp"
+#include "unified_ast_backend.hpp"
+#include <functional>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+
+namespace duckdb {
+
+// Identity of one parse result: the file version (path, size and mtime, or a
+// content hash when verification is enabled) plus everything that changes
+// the shape of the parsed nodes (language and extraction config).
+struct ASTParseCacheKey {
+    string file_path;
+    idx_t file_size = 0;
+    int64_t last_modified = 0;   // Microseconds; unused when content_hash is set
+    hash_t content_hash = 0;     // Only set when sitting_duck_cache_verify_content is on
+    string language;
+    string config;               // ExtractionConfig::GetFingerprint()
+
+    // Key of the in-memory cache (includes the file version)
+    string ToString() const;
+    // Path, language and config only - the on-disk cache validates the version itself
+    string Identity() const;
+};
+
+struct ASTParseCacheStats {
+    idx_t entries = 0;
+    idx_t bytes_held = 0;
+    idx_t budget = 0;
+    idx_t hits = 0;
+    idx_t misses = 0;
+    idx_t insertions = 0;
+    idx_t evictions = 0;
+    idx_t disk_hits = 0;
+    idx_t disk_writes = 0;
+};
+
+// DatabaseInstance-wide LRU cache of parse results, shared by every query.
+// Lives in the instance's ObjectCache; its memory is reported to the buffer
+// pool under MemoryTag::EXTENSION so it counts against memory_limit.
+// Misses fall through to the optional on-disk cache (ASTDiskCache).
+class ASTParseCache : public ObjectCacheEntry {
+public:
+    static constexpr const char *DEFAULT_CACHE_SIZE = "256MB";
+
+    ASTParseCache(DatabaseInstance &db, idx_t budget);
+    ~ASTParseCache() override;
+
+    static string ObjectType();
+    string GetObjectType() override;
+
+    // Get (or lazily create) the cache of the database this context belongs to
+    static shared_ptr<ASTParseCache> Get(ClientContext &context);
+
+    // Register the sitting_duck_cache_* settings and sitting_duck_cache_stats()
+    static void Register(DatabaseInstance &instance);
+
+    // Read and parse a file, serving the result from the cache when the file is unchanged.
+    // `parse` is only invoked on a miss and receives the file content. A hit returns the
+    // cached result itself, so a warm cache costs no copy of the nodes. Callers that
+    // already read the file pass its bytes as `content`, so it is not read again.
+    static shared_ptr<const ASTResult> ParseFile(ClientContext &context, const string &file_path,
+                                                 const string &language, const ExtractionConfig &config,
+                                                 const std::function<ASTResult(const string &content)> &parse,
+                                                 const string *content = nullptr);
+
+    // Same, parsing with UnifiedASTBackend::ParseToASTResult. A default ExtractionConfig
+    // is read_ast's default, so callers passing one share read_ast's cache entries.
+    static shared_ptr<const ASTResult> ParseFile(ClientContext &context, const string &file_path,
+                                                 const string &language, const ExtractionConfig &config);
+
+    // Approximate heap footprint of a parse result, used for budget accounting
+    static idx_t EstimateMemoryUsage(const ASTResult &result);
+
+    bool IsEnabled() const;
+    bool VerifyContent() const;
+    string CacheDirectory() const;
+    void SetBudget(idx_t new_budget);
+    void SetVerifyContent(bool verify);
+    void SetCacheDirectory(const string &directory);
+
+    shared_ptr<const ASTResult> Lookup(const string &key);
+    void Insert(const string &key, shared_ptr<const ASTResult> result);
+    ASTParseCacheStats GetStats();
+
+private:
+    struct CacheEntry {
+        string key;
+        shared_ptr<const ASTResult> result;
+        idx_t size;
+    };
+
+    // Evict least recently used entries until bytes_held fits the budget (lock must be held)
+    void EvictToBudget();
+
+    mutable std::mutex lock;
+    std::list<CacheEntry> lru;   // Most recently used at the front
+    std::unordered_map<string, std::list<CacheEntry>::iterator> index;
+    BufferPoolReservation reservation;
+    idx_t max_memory;
+    idx_t budget;
+    bool verify_content;
+    string cache_directory;      // Empty when the on-disk cache is disabled
+
+    idx_t bytes_held;
+    idx_t hits;
+    idx_t misses;
+    idx_t insertions;
+    idx_t evictions;
+    atomic<idx_t> disk_hits;
+    atomic<idx_t> disk_writes;
+};
+
+// Per-scan table of parse results by content (read_ast dedup := true). The first
+// file with a given language and content is parsed; every later file with the
+// same bytes becomes a stub that shares its nodes (see ASTResult::shared), so
+// vendored copies and generated stubs cost one parse and one set of nodes.
+// Hard links are caught as well, since they read back the same bytes.
+//
+// The table only holds weak references: a parse is shared while some result
+// still uses it, and freed with the last one, so memory stays bounded by what
+// the scan holds anyway. A copy read after that is parsed again. Entries do not
+// keep the bytes: a second, independent hash of the content has to match too.
+class ASTContentDedup {
+public:
+    // Parse `file_path` through the table. `parse` is only invoked for content
+    // not seen before in this scan; `content` is the file's raw bytes.
+    ASTResult ParseFile(const string &file_path, const string &language, const string &content,
+                        const std::function<shared_ptr<const ASTResult>()> &parse);
+
+private:
+    // A parse with a check hash of its bytes, so that a collision of the key hash is not reused
+    struct Entry {
+        uint64_t check_hash;
+        shared_ptr<const ASTResult> result;
+    };
+
+    std::mutex lock;
+    std::unordered_map<string, weak_ptr<const Entry>> results; // By language, size and content hash
+    idx_t prune_size = 1024; // Drop expired references once the table reaches this size
+};
+
+} // namespace duckdb
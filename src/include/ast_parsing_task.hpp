@@ -1,8 +1,10 @@
 #pragma once
 
 #include "duckdb.hpp"
+#include "duckdb/function/table_function.hpp"
 #include "duckdb/parallel/task_executor.hpp"
 #include "unified_ast_backend.hpp"
+#include "ast_file_utils.hpp"
 #include <atomic>
 #include <mutex>
 #include <vector>
@@ -10,8 +12,12 @@
 
 namespace duckdb {
 
-// Forward declaration
+// Forward declarations
 class LanguageAdapter;
+class ASTFileDiscovery;
+class ASTTarArchives;
+struct ASTContentFilter;
+class ASTContentDedup;
 
 // Shared state for parallel AST parsing tasks
 struct ASTParsingState {
@@ -22,9 +28,13 @@ struct ASTParsingState {
                    int32_t peek_size_p,
                    const string &peek_mode_p,
                    const unordered_map<string, unique_ptr<LanguageAdapter>> &adapters_p,
-                   idx_t num_threads_p = 1)
+                   idx_t num_threads_p = 1,
+                   bool hashes_p = false,
+                   const vector<pair<uint32_t, uint32_t>> &line_ranges_p = {},
+                   idx_t max_nodes_p = 0)
         : context(context_p), file_paths(file_paths_p), languages(languages_p),
           ignore_errors(ignore_errors_p), peek_size(peek_size_p), peek_mode(peek_mode_p),
+          config(MakeConfig(peek_size_p, peek_mode_p, hashes_p, line_ranges_p, max_nodes_p)),
           pre_created_adapters(adapters_p), files_processed(0), total_nodes(0), errors_encountered(0) {
         // Initialize per-thread result buffers
         per_thread_results.resize(num_threads_p);
@@ -36,6 +46,10 @@ struct ASTParsingState {
     const bool ignore_errors;
     const int32_t peek_size;
     const string peek_mode;
+    const ExtractionConfig config;  // peek_size/peek_mode (hashes, line ranges) as a config, for cache keys
+    const ASTContentFilter *content_filter = nullptr;  // Files without a match are skipped unparsed
+    ASTContentDedup *dedup = nullptr;                  // Identical files share one parse when set
+    const ASTFileScreen *screen = nullptr;             // Skipped files get an empty result with a status
     
     // Pre-created adapters (no singleton lookup needed)
     const unordered_map<string, unique_ptr<LanguageAdapter>> &pre_created_adapters;
@@ -55,6 +69,16 @@ struct ASTParsingState {
     atomic<idx_t> files_processed;
     atomic<idx_t> total_nodes;
     atomic<idx_t> errors_encountered;
+    atomic<idx_t> files_filtered{0};
+    
+    static ExtractionConfig MakeConfig(int32_t peek_size, const string &peek_mode, bool hashes,
+                                       const vector<pair<uint32_t, uint32_t>> &line_ranges, idx_t max_nodes) {
+        auto config = UnifiedASTBackend::LegacyExtractionConfig(peek_size, peek_mode);
+        config.hashes = hashes;
+        config.line_ranges = line_ranges;
+        config.max_nodes = max_nodes;
+        return config;
+    }
     
     // Collect all per-thread results into main results vector
     void CollectResults() {
@@ -89,4 +113,154 @@ private:
     void ProcessSingleFile(idx_t file_idx);
 };
 
-} // namespace duckdb
\ No newline at end of file
+// Resolve the language of every file ("unknown" when it cannot be detected and
+// ignore_errors is set) and create one adapter per language for ASTParsingTask
+void ResolveFileLanguages(const vector<string> &file_paths, const string &language, bool ignore_errors,
+                          vector<string> &languages,
+                          unordered_map<string, unique_ptr<LanguageAdapter>> &adapters);
+
+// Parse files on all scheduler threads; results keep the order of file_paths.
+// With hashes set, every node also gets its Merkle subtree/shape hashes; with
+// line_ranges, only the nodes overlapping those lines (and their ancestors).
+// Files that do not match content_filter produce no result; with dedup, files
+// with identical content share the nodes of one parse (see ASTContentDedup).
+// Files rejected by screen produce a result without nodes whose status says why.
+vector<ASTResult> ParseFilesParallel(ClientContext &context, const vector<string> &file_paths,
+                                     const vector<string> &languages, bool ignore_errors,
+                                     int32_t peek_size, const string &peek_mode,
+                                     const unordered_map<string, unique_ptr<LanguageAdapter>> &adapters,
+                                     bool hashes = false,
+                                     const vector<pair<uint32_t, uint32_t>> &line_ranges = {},
+                                     const ASTContentFilter *content_filter = nullptr,
+                                     ASTContentDedup *dedup = nullptr,
+                                     const ASTFileScreen *screen = nullptr);
+
+// Walk and parse in one pass on all scheduler threads: a file is parsed as soon
+// as the walk finds it, and workers list directories while no file is waiting.
+// With ordered set the results are sorted by path, as ParseFilesParallel over
+// ASTFileUtils::GetFiles would return them; otherwise they come in completion order.
+vector<ASTResult> DiscoverAndParseFilesParallel(ClientContext &context, ASTFileDiscovery &discovery,
+                                                const string &language, bool ignore_errors, int32_t peek_size,
+                                                const string &peek_mode, bool ordered,
+                                                const vector<pair<uint32_t, uint32_t>> &line_ranges = {},
+                                                const ASTContentFilter *content_filter = nullptr,
+                                                ASTContentDedup *dedup = nullptr,
+                                                const ASTFileScreen *screen = nullptr);
+
+// Parse the members of tar archives on all scheduler threads, straight from the
+// archive (see ASTTarArchives); options as for DiscoverAndParseFilesParallel.
+// Member paths are "<archive>/<member name>".
+vector<ASTResult> ParseArchivesParallel(ClientContext &context, ASTTarArchives &archives, const string &language,
+                                        bool ignore_errors, int32_t peek_size, const string &peek_mode,
+                                        bool ordered, const vector<pair<uint32_t, uint32_t>> &line_ranges = {},
+                                        const ASTContentFilter *content_filter = nullptr,
+                                        ASTContentDedup *dedup = nullptr, const ASTFileScreen *screen = nullptr);
+
+// Parse in-memory sources on all scheduler threads, e.g. the rows of parse_ast(TABLE ...);
+// results keep the input order. A language of "auto" is detected from the path.
+vector<ASTResult> ParseContentsParallel(ClientContext &context, const vector<string> &file_paths,
+                                        const vector<string> &languages, const vector<string> &contents,
+                                        bool ignore_errors, int32_t peek_size, const string &peek_mode);
+
+//==============================================================================
+// Per-file table functions (one output row per parsed file)
+//==============================================================================
+
+// Arguments shared by read_ast_blob and read_ast_objects: file patterns, an
+// optional language and the ignore_errors / peek_size / peek_mode options
+struct ASTFileBindData : public TableFunctionData {
+    vector<string> file_paths;
+    string language = "auto";
+    bool ignore_errors = false;
+    int32_t peek_size = 120;
+    string peek_mode = "auto";
+    bool hashes = false; // Set by functions that need structure.subtree_hash / shape_hash
+    ASTFileScreen screen; // read_ast_objects skip_generated / max_file_size / max_nodes
+    vector<string> languages; // Per file, once ResolveLanguages has run
+
+    // Read the arguments and expand the patterns into file_paths
+    void Bind(ClientContext &context, TableFunctionBindInput &input, const string &function_name);
+
+    // Fill languages, for functions that parse file by file with ParseFile
+    void ResolveLanguages();
+
+    // Parse one file through the parse cache with these settings; the defaults are
+    // read_ast's, so the cache entries are shared with it. nullptr for a file of
+    // unknown language, or one that fails to parse with ignore_errors set.
+    shared_ptr<const ASTResult> ParseFile(ClientContext &context, idx_t file_idx) const;
+};
+
+// Parses the files of an ASTFileBindData one vector's worth at a time, each
+// batch in parallel on all scheduler threads
+struct ASTFileParseState {
+    ASTFileParseState();
+    ~ASTFileParseState();
+
+    void Initialize(const ASTFileBindData &bind_data);
+
+    // Next parsed file in input order, or nullptr once all files are consumed.
+    // The result may be moved from; it stays valid until the next call.
+    ASTResult *Next(ClientContext &context, const ASTFileBindData &bind_data);
+
+    vector<string> languages;
+    unordered_map<string, unique_ptr<LanguageAdapter>> adapters;
+    idx_t next_file = 0;
+    vector<ASTResult> batch;
+    idx_t batch_offset = 0;
+};
+
+// Per-file scans (read_ast_calls, read_ast_symbols, ...): the scan threads claim
+// the files of an ASTFileBindData one at a time and emit the rows extracted from each
+struct ASTFileScanGlobalState : public GlobalTableFunctionState {
+    explicit ASTFileScanGlobalState(idx_t file_count)
+        : next_file(0), max_threads(MaxValue<idx_t>(file_count, 1)) {
+    }
+
+    idx_t MaxThreads() const override {
+        return max_threads;
+    }
+
+    static unique_ptr<GlobalTableFunctionState> Init(ClientContext &context, TableFunctionInitInput &input) {
+        return make_uniq<ASTFileScanGlobalState>(input.bind_data->Cast<ASTFileBindData>().file_paths.size());
+    }
+
+    atomic<idx_t> next_file;
+    const idx_t max_threads;
+};
+
+template <class ROW>
+struct ASTFileScanLocalState : public LocalTableFunctionState {
+    idx_t file_idx = 0;
+    shared_ptr<const ASTResult> result; // Parse of the file being emitted
+    vector<ROW> rows;                   // Its rows
+    idx_t offset = 0;
+
+    // Next row to emit, or nullptr once all files are done. When the rows of the
+    // current file are used up, files are claimed and passed to extract(*result),
+    // which appends to rows, until one yields any.
+    template <class EXTRACT>
+    const ROW *Next(ClientContext &context, const ASTFileBindData &bind_data, ASTFileScanGlobalState &global_state,
+                    EXTRACT &&extract) {
+        while (offset >= rows.size()) {
+            file_idx = global_state.next_file.fetch_add(1);
+            if (file_idx >= bind_data.file_paths.size()) {
+                return nullptr;
+            }
+            rows.clear();
+            offset = 0;
+            result = bind_data.ParseFile(context, file_idx);
+            if (result) {
+                extract(*result);
+            }
+        }
+        return &rows[offset++];
+    }
+};
+
+template <class LOCAL_STATE>
+unique_ptr<LocalTableFunctionState> ASTFileScanInitLocal(ExecutionContext &context, TableFunctionInitInput &input,
+                                                         GlobalTableFunctionState *global_state) {
+    return make_uniq<LOCAL_STATE>();
+}
+
+} // namespace duckdb
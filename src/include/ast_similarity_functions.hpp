@@ -0,0 +1,12 @@
+#pragma once
+
+#include "duckdb.hpp"
+
+namespace duckdb {
+
+// Register near-duplicate function detection: ast_function_signatures (MinHash
+// signatures and LSH band keys per function definition), the
+// ast_minhash_similarity scalar and the ast_similar_functions table macro
+void RegisterASTSimilarityFunctions(DatabaseInstance &instance);
+
+} // namespace duckdb
@@ -0,0 +1,11 @@
+#pragma once
+
+#include "duckdb.hpp"
+
+namespace duckdb {
+
+// Register ast_get_source(file_path, start_byte, end_byte): exact source text
+// of a byte range, as reported in read_ast's source.start_byte / end_byte
+void RegisterASTSourceFunctions(DatabaseInstance &instance);
+
+} // namespace duckdb
@@ -0,0 +1,12 @@
+#pragma once
+
+#include "duckdb.hpp"
+
+namespace duckdb {
+
+// Register the symbol index: read_ast_symbols (per-file definitions and
+// references), ast_symbol_index (persisted symbol/reference tables) and the
+// ast_definition_of / ast_references lookup macros
+void RegisterASTSymbolFunctions(DatabaseInstance &instance);
+
+} // namespace duckdb
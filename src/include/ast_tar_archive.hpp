@@ -0,0 +1,96 @@
+#pragma once
+
+#include "duckdb.hpp"
+#include "duckdb/common/file_system.hpp"
+#include "duckdb/main/client_context.hpp"
+#include "ast_file_discovery.hpp"
+#include <atomic>
+#include <mutex>
+
+namespace duckdb {
+
+// A regular file stored in a tar archive
+struct ASTTarMember {
+    string name;      // Path inside the archive
+    idx_t offset = 0; // Start of the data in the uncompressed tar stream
+    idx_t size = 0;
+};
+
+class ASTTarIndex;
+class ASTTarStream;
+
+// Members of tar archives, handed out to parse workers one at a time.
+//
+// Headers are parsed natively (ustar prefixes, GNU long names and pax path
+// records); anything but a regular file is skipped. Compressed archives go
+// through DuckDB's gzip file system, so no extraction to disk is needed.
+//
+// A plain .tar is indexed once - headers only, file data is skipped with
+// seeks - and the index stays in the database's ObjectCache until the archive
+// changes, so later scans go straight to the members they need. Those are
+// read with positioned reads, by all workers at once.
+//
+// A .tar.gz / .tgz can only be read front to back: one worker at a time
+// decompresses up to the next wanted member, while the others parse the
+// members that were already read.
+class ASTTarArchives {
+public:
+    // Only members of `shard` (by "<archive>/<member name>") are handed out
+    ASTTarArchives(ClientContext &context, vector<string> supported_extensions,
+                   ASTFileShard shard = ASTFileShard());
+    ~ASTTarArchives();
+
+    // Whether the path names a tar archive (.tar, .tar.gz or .tgz)
+    static bool IsArchivePath(const string &path);
+
+    // Split "release.tar.gz/src/**/*.py" into the archive file and the pattern
+    // inside it; false when no leading part of the pattern is an archive file
+    static bool SplitPattern(ClientContext &context, const string &pattern, string &archive,
+                             string &member_pattern);
+
+    // Read the members of `archive` that match `member_pattern`. An empty
+    // pattern selects every member whose language can be detected.
+    void AddPattern(const string &archive, const string &member_pattern);
+
+    // Take the next wanted member; `file_path` is "<archive>/<member name>".
+    // False once every archive is exhausted.
+    bool Next(string &file_path, string &content);
+
+    // Number of wanted members found so far, in any shard
+    idx_t MemberCount() const {
+        return member_count.load();
+    }
+
+    // "<archive>/<member name>" of every wanted member found so far, in any shard, sorted
+    vector<string> MemberPaths();
+
+private:
+    struct Archive {
+        string path;
+        bool compressed = false;
+        vector<string> patterns;
+        unique_ptr<FileHandle> handle;
+        bool opened = false;
+        // Plain tar: the cached index and the members still to read
+        shared_ptr<ASTTarIndex> index;
+        vector<idx_t> wanted;
+        idx_t next_wanted = 0;
+        // Compressed tar: the sequential reader
+        unique_ptr<ASTTarStream> stream;
+    };
+
+    void Open(Archive &archive);
+    bool Wants(const Archive &archive, const string &member_name) const;
+
+    ClientContext &context;
+    const vector<string> supported_extensions;
+    const ASTFileShard shard;
+
+    std::mutex lock;
+    vector<unique_ptr<Archive>> archives;
+    idx_t current_archive = 0;
+    std::atomic<idx_t> member_count;
+    vector<string> member_paths;
+};
+
+} // namespace duckdb
@@ -0,0 +1,13 @@
+#pragma once
+
+#include "duckdb.hpp"
+
+namespace duckdb {
+
+// Register the native tree navigation functions over per-file node lists
+// (read_ast_objects(...).nodes): ast_get_children, ast_get_descendants,
+// ast_get_subtree, ast_get_siblings, ast_get_parent, ast_get_ancestors,
+// ast_get_path_to_node and ast_find_nearest_ancestor
+void RegisterASTTreeNavigationFunctions(DatabaseInstance &instance);
+
+} // namespace duckdb
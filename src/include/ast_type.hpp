@@ -83,9 +83,11 @@ struct SourceLocation {
     uint32_t end_line;      // Available if source >= LINES_ONLY
     uint32_t start_column;  // Available if source >= FULL
     uint32_t end_column;    // Available if source >= FULL
+    uint32_t start_byte;    // Byte offsets into the file content, end exclusive
+    uint32_t end_byte;
     
     // Default constructor
-    SourceLocation() : start_line(0), end_line(0), start_column(0), end_column(0) {}
+    SourceLocation() : start_line(0), end_line(0), start_column(0), end_column(0), start_byte(0), end_byte(0) {}
 };
 
 struct TreeStructure {
@@ -94,10 +96,12 @@ struct TreeStructure {
     uint32_t sibling_index;     // Available if structure >= MINIMAL (O(1))
     uint32_t children_count;    // Available if structure >= FULL (O(child_count))
     uint32_t descendant_count;  // Available if structure >= FULL (O(child_count))
+    uint64_t subtree_hash;      // Merkle hash of the subtree, available if ExtractionConfig::hashes
+    uint64_t shape_hash;        // Same, ignoring leaf text (identifiers, literals)
     
     // Default constructor
     TreeStructure() : parent_id(-1), depth(0), sibling_index(0), 
-                     children_count(0), descendant_count(0) {}
+                     children_count(0), descendant_count(0), subtree_hash(0), shape_hash(0) {}
 };
 
 struct NormalizedSemantics {
@@ -374,6 +378,9 @@ private:
 };
 
 // DuckDB type registration
+// SQL type AST: a BLOB holding one parsed file in ASTBinaryFormat
+LogicalType GetASTLogicalType();
+
 void RegisterASTType(DatabaseInstance &db);
 
 } // namespace duckdb
\ No newline at end of file
@@ -4,6 +4,10 @@
 #include "duckdb/function/table_function.hpp"
 #include "duckdb/common/multi_file/multi_file_reader.hpp"
 #include "unified_ast_backend.hpp"
+#include "ast_file_discovery.hpp"
+#include "ast_file_utils.hpp"
+#include "ast_parse_cache.hpp"
+#include "ast_tar_archive.hpp"
 #include <unordered_map>
 
 namespace duckdb {
@@ -40,6 +44,8 @@ struct ReadASTStreamingGlobalState : public GlobalTableFunctionState {
     int32_t peek_size;
     string peek_mode;
     int32_t batch_size = 1;
+    vector<pair<uint32_t, uint32_t>> line_ranges;  // Empty = whole files
+    bool ordered = true;                            // Sort walked files by path
     
     // Batch processing state
     vector<string> current_batch_files;
@@ -48,6 +54,25 @@ struct ReadASTStreamingGlobalState : public GlobalTableFunctionState {
     // Pre-created language adapters (eliminates singleton contention)
     unordered_map<string, unique_ptr<LanguageAdapter>> pre_created_adapters;
     
+    // Set when the patterns need a walk: files are discovered while parsing
+    unique_ptr<ASTFileDiscovery> discovery;
+    
+    // Set when the patterns point into tar archives: members are parsed straight from them
+    unique_ptr<ASTTarArchives> archives;
+    
+    // content_filter prefilter, when given
+    unique_ptr<ASTContentFilter> content_filter;
+    
+    // Parse results by content for dedup := true, shared by all files of the scan
+    unique_ptr<ASTContentDedup> dedup;
+    
+    // skip_generated / max_file_size / max_nodes, when any is set
+    unique_ptr<ASTFileScreen> screen;
+    
+    // global_keys := true: file_id of every file the patterns match, in any shard
+    bool global_keys = false;
+    unordered_map<string, int32_t> file_ids;
+    
     ReadASTStreamingGlobalState() = default;
 };
 
@@ -61,6 +86,15 @@ struct ReadASTStreamingBindData : public TableFunctionData {
     int32_t peek_size;
     string peek_mode;
     int32_t batch_size;
+    vector<pair<uint32_t, uint32_t>> line_ranges;  // read_ast line_ranges := [[start, end], ...]
+    bool ordered = true;                            // read_ast ordered := false = completion order
+    ASTDiscoveryOptions discovery_options;          // read_ast exclude / respect_gitignore
+    string content_filter;                          // Empty = parse every file
+    string content_filter_mode = "literal";         // 'literal' or 'regex'
+    bool dedup = false;                             // Parse identical files once
+    ASTFileScreen screen;                           // read_ast skip_generated / max_file_size / max_nodes
+    string archive;                                 // read_ast archive := tar file the patterns apply to
+    bool global_keys = false;                       // Add file_id, node_key and parent_key columns
     
     // Constructor for Value-based input (legacy)
     ReadASTStreamingBindData(Value file_path_value, string language, bool ignore_errors = false, 
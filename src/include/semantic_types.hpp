@@ -158,6 +158,10 @@ constexpr uint8_t GetLanguageSpecific(uint8_t semantic_type) {
     return semantic_type & 0x03; // Extract bits 0-1
 }
 
+constexpr uint8_t GetBaseType(uint8_t semantic_type) {
+    return semantic_type & 0xFC; // Drop language-specific bits 0-1 (e.g. DEFINITION_FUNCTION refinements)
+}
+
 // Get human-readable names
 string GetSemanticTypeName(uint8_t semantic_type);
 string GetSuperKindName(uint8_t super_kind);
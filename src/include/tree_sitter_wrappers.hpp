@@ -23,9 +23,27 @@ struct TSTreeDeleter {
     }
 };
 
+struct TSQueryDeleter {
+    void operator()(TSQuery* query) const {
+        if (query) {
+            ts_query_delete(query);
+        }
+    }
+};
+
+struct TSQueryCursorDeleter {
+    void operator()(TSQueryCursor* cursor) const {
+        if (cursor) {
+            ts_query_cursor_delete(cursor);
+        }
+    }
+};
+
 // Smart pointer type aliases using DuckDB's unique_ptr
 using TSParserPtr = unique_ptr<TSParser, TSParserDeleter>;
 using TSTreePtr = unique_ptr<TSTree, TSTreeDeleter>;
+using TSQueryPtr = unique_ptr<TSQuery, TSQueryDeleter>;
+using TSQueryCursorPtr = unique_ptr<TSQueryCursor, TSQueryCursorDeleter>;
 
 // RAII wrapper for TSParser with helper methods
 class TSParserWrapper {
@@ -20,6 +20,14 @@ struct ExtractionConfig {
     StructureLevel structure = StructureLevel::FULL;
     PeekLevel peek = PeekLevel::SMART;
     int32_t peek_size = 120;  // Used when peek == CUSTOM
+    bool hashes = false;      // Compute structure.subtree_hash / shape_hash during the walk
+    // 1-based, inclusive [start, end] line ranges. When set, only nodes overlapping a range
+    // (with their ancestors) are extracted; node_id and descendant_count match the full tree.
+    vector<pair<uint32_t, uint32_t>> line_ranges;
+    // Node budget per file (0 = none). The walk stops once it is reached; the nodes kept
+    // are a preorder prefix of the full tree, and the result is marked "truncated".
+    // descendant_count then only counts kept nodes, so every subtree range stays in the list.
+    idx_t max_nodes = 0;
     
     // Validation methods
     bool is_valid() const {
@@ -27,7 +35,26 @@ struct ExtractionConfig {
                source <= SourceLevel::FULL &&
                structure <= StructureLevel::FULL &&
                peek <= PeekLevel::CUSTOM &&
-               peek_size >= 0;
+               peek_size >= 0 && LineRangesValid();
+    }
+    
+    bool LineRangesValid() const {
+        for (auto &range : line_ranges) {
+            if (range.first == 0 || range.first > range.second) {
+                return false;
+            }
+        }
+        return true;
+    }
+    
+    // Whether any line of [start_line, end_line] falls in a requested range
+    bool OverlapsLineRanges(uint32_t start_line, uint32_t end_line) const {
+        for (auto &range : line_ranges) {
+            if (start_line <= range.second && range.first <= end_line) {
+                return true;
+            }
+        }
+        return line_ranges.empty();
     }
     
     // Performance estimation
@@ -43,6 +70,22 @@ struct ExtractionConfig {
         }
         return "MAXIMUM";
     }
+    
+    // Stable identity of the config, used to key cached parse results
+    string GetFingerprint() const {
+        string fingerprint = std::to_string(static_cast<int>(context)) + ":" +
+                             std::to_string(static_cast<int>(source)) + ":" +
+                             std::to_string(static_cast<int>(structure)) + ":" +
+                             std::to_string(static_cast<int>(peek)) + ":" +
+                             std::to_string(peek_size) + (hashes ? ":h" : "");
+        for (auto &range : line_ranges) {
+            fingerprint += ":" + std::to_string(range.first) + "-" + std::to_string(range.second);
+        }
+        if (max_nodes > 0) {
+            fingerprint += ":n" + std::to_string(max_nodes);
+        }
+        return fingerprint;
+    }
 };
 
 // Parse extraction config from SQL parameters
@@ -67,7 +110,34 @@ struct ASTResult {
     uint32_t node_count;
     uint32_t max_depth;
     
+    // Set when the nodes belong to another result (a parse cache hit, or a duplicate
+    // found by read_ast dedup): `nodes` stays empty and the shared result's nodes
+    // are emitted under `source`
+    shared_ptr<const ASTResult> shared;
+    
+    // Empty for a complete parse. "truncated" when config.max_nodes cut the walk short;
+    // "binary", "minified", "generated" or "too_large" when ASTFileScreen skipped the
+    // file, which then has no nodes.
+    string status;
+    
     ASTResult() : parse_time(std::chrono::system_clock::now()), node_count(0), max_depth(0) {}
+    
+    // The nodes to emit, whether owned or shared
+    const vector<ASTNode> &Nodes() const {
+        return shared ? shared->nodes : nodes;
+    }
+    
+    // A result that emits `original`'s nodes without copying them
+    static ASTResult Share(shared_ptr<const ASTResult> original) {
+        ASTResult result;
+        result.source = original->source;
+        result.parse_time = original->parse_time;
+        result.node_count = original->node_count;
+        result.max_depth = original->max_depth;
+        result.status = original->status;
+        result.shared = original->shared ? original->shared : std::move(original);
+        return result;
+    }
 };
 
 // Collection of parse results for multi-file parsing
@@ -78,12 +148,16 @@ struct ASTResultCollection {
     idx_t GetTotalNodeCount() const {
         idx_t total = 0;
         for (const auto& result : results) {
-            total += result.nodes.size();
+            total += result.Nodes().size();
         }
         return total;
     }
 };
 
+struct ASTContentFilter;
+class ASTContentDedup;
+struct ASTFileScreen;
+
 // Unified parsing backend - single source of truth for all AST parsing
 class UnifiedASTBackend {
 public:
@@ -100,6 +174,9 @@ public:
                                      int32_t peek_size,
                                      const string& peek_mode);
     
+    // Map legacy peek_size/peek_mode parameters to an ExtractionConfig
+    static ExtractionConfig LegacyExtractionConfig(int32_t peek_size, const string& peek_mode);
+    
     // Multi-file parsing function with glob support
     static ASTResultCollection ParseFilesToASTCollection(ClientContext &context,
                                                          const Value &file_path_value,
@@ -122,12 +199,17 @@ public:
                                                            const string& language = "auto",
                                                            bool ignore_errors = false,
                                                            int32_t peek_size = 120,
-                                                           const string& peek_mode = "auto");
+                                                           const string& peek_mode = "auto",
+                                                           const vector<pair<uint32_t, uint32_t>>& line_ranges = {},
+                                                           const ASTContentFilter* content_filter = nullptr,
+                                                           ASTContentDedup* dedup = nullptr,
+                                                           const ASTFileScreen* screen = nullptr);
     
     // Helper functions for different output formats
     static vector<LogicalType> GetFlatTableSchema();
     static vector<string> GetFlatTableColumnNames();
     static LogicalType GetASTStructSchema();
+    static LogicalType GetASTNodeStructSchema();   // Element type of GetASTStructSchema().nodes
     
     // NEW: Hierarchical schema functions for structured field access
     static vector<LogicalType> GetHierarchicalTableSchema();
@@ -138,6 +220,11 @@ public:
     static void ProjectToTable(const ASTResult& result, DataChunk& output, idx_t& current_row, idx_t& output_index);
     static Value CreateASTStruct(const ASTResult& result);
     static Value CreateASTStructValue(const ASTResult& result); // For scalar functions
+    // Write all nodes of a result as list entry `row` of a LIST(GetASTNodeStructSchema()) vector
+    static void ProjectToNodeList(const ASTResult& result, Vector& list_vector, idx_t row);
+    // Same for a subset of the nodes, in the given order
+    static void ProjectToNodeList(const ASTResult& result, const vector<idx_t>& node_indices,
+                                  Vector& list_vector, idx_t row);
     
     // NEW: Hierarchical table projection
     static void ProjectToHierarchicalTable(const ASTResult& result, DataChunk& output, idx_t& current_row, idx_t& output_index);
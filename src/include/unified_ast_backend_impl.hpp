@@ -3,6 +3,7 @@
 #include "unified_ast_backend.hpp"
 #include "native_context_extraction.hpp"
 #include "duckdb/common/string_util.hpp"
+#include "duckdb/common/types/hash.hpp"
 #include "utf8proc_wrapper.hpp"
 #include <algorithm>
 
@@ -26,6 +27,38 @@ static string SanitizeUTF8(const string& input) {
     return string(char_array.begin(), char_array.end() - 1);  // Exclude null terminator
 }
 
+// Order-sensitive combination of a child hash into its parent's Merkle hash
+static inline uint64_t CombineSubtreeHash(uint64_t seed, uint64_t value) {
+    return Hash<uint64_t>(seed ^ (value + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2)));
+}
+
+// Merkle hashes of a node whose descendants are complete: the grammar symbol
+// combined with the children's hashes in order. Leaves add their text to
+// subtree_hash (comments excepted); shape_hash never includes leaf text, so
+// renamed identifiers and changed literals hash the same.
+static void ComputeSubtreeHashes(vector<ASTNode> &nodes, idx_t node_index, TSNode ts_node, const string &content) {
+    auto &node = nodes[node_index];
+    uint64_t subtree_hash = Hash<uint64_t>(ts_node_symbol(ts_node));
+    uint64_t shape_hash = subtree_hash;
+    if (node.structure.descendant_count == 0) {
+        uint32_t start_byte = ts_node_start_byte(ts_node);
+        uint32_t end_byte = MinValue<uint32_t>(ts_node_end_byte(ts_node), content.size());
+        if (start_byte < end_byte &&
+            SemanticTypes::GetKind(node.context.normalized.semantic_type) != SemanticTypes::METADATA) {
+            subtree_hash = CombineSubtreeHash(subtree_hash, Hash(content.data() + start_byte, end_byte - start_byte));
+        }
+    } else {
+        // Children are contiguous in DFS order: next sibling = child + descendant_count + 1
+        idx_t end = node_index + node.structure.descendant_count;
+        for (idx_t child = node_index + 1; child <= end; child += nodes[child].structure.descendant_count + 1) {
+            subtree_hash = CombineSubtreeHash(subtree_hash, nodes[child].structure.subtree_hash);
+            shape_hash = CombineSubtreeHash(shape_hash, nodes[child].structure.shape_hash);
+        }
+    }
+    node.structure.subtree_hash = subtree_hash;
+    node.structure.shape_hash = shape_hash;
+}
+
 // Template implementation with ExtractionConfig - eliminates virtual calls
 template<typename AdapterType>
 ASTResult UnifiedASTBackend::ParseToASTResultTemplated(const AdapterType* adapter,
@@ -55,26 +88,49 @@ ASTResult UnifiedASTBackend::ParseToASTResultTemplated(const AdapterType* adapte
         uint32_t sibling_index;
         bool processed;        // Track if node has been processed
         idx_t node_index;      // Index in nodes array for this node
+        idx_t node_id;         // DFS id in the full tree (differs from node_index when pruning)
     };
     
     // Hoist GetNodeConfigs outside the hot loop - huge performance optimization!
     const auto& node_configs = adapter->GetNodeConfigs();
     
     vector<StackEntry> stack;
-    stack.push_back({root, -1, 0, 0, false, 0});
+    stack.push_back({root, -1, 0, 0, false, 0, 0});
+    
+    // With line ranges, subtrees outside every range are skipped whole. Their ids are still
+    // consumed (ts_node_descendant_count is O(1) and counts the node itself), so node_id,
+    // parent_id and descendant_count agree with a full extraction of the file.
+    const bool scoped = !config.line_ranges.empty();
+    idx_t next_id = 0;
     
     while (!stack.empty()) {
         // Check if the top entry is processed before copying
         if (!stack.back().processed) {
             // Copy the entry to avoid reference invalidation when stack reallocates
             auto entry = stack.back();
+            
+            TSPoint start = ts_node_start_point(entry.node);
+            TSPoint end = ts_node_end_point(entry.node);
+            if (config.max_nodes > 0 && result.nodes.size() >= config.max_nodes) {
+                // Out of budget: skip the rest like a pruned subtree (the ancestors
+                // still on the stack are capped at the kept nodes on their second visit)
+                result.status = "truncated";
+            }
+            if ((scoped && !config.OverlapsLineRanges(start.row + 1, end.row + 1)) || !result.status.empty()) {
+                next_id += ts_node_descendant_count(entry.node);
+                stack.pop_back();
+                continue;
+            }
+            
             // First visit - create node and add children
             entry.processed = true;
             entry.node_index = result.nodes.size();
+            entry.node_id = next_id++;
             
-            // Update the stack entry with the processed flag and node_index
+            // Update the stack entry with the processed flag, node_index and node_id
             stack.back().processed = true;
             stack.back().node_index = entry.node_index;
+            stack.back().node_id = entry.node_id;
             
             // Track max depth
             max_depth = std::max(max_depth, entry.depth);
@@ -82,17 +138,17 @@ ASTResult UnifiedASTBackend::ParseToASTResultTemplated(const AdapterType* adapte
             // Create ASTNode
             ASTNode ast_node;
             
-            // Basic information - use node_index as node_id
-            ast_node.node_id = entry.node_index;
+            // Basic information - DFS position in the full tree as node_id
+            ast_node.node_id = entry.node_id;
             ast_node.type.raw = ts_node_type(entry.node);
             
             // Position information -> NEW STRUCTURED FIELDS
-            TSPoint start = ts_node_start_point(entry.node);
-            TSPoint end = ts_node_end_point(entry.node);
             ast_node.source.start_line = start.row + 1;
             ast_node.source.end_line = end.row + 1;
             ast_node.source.start_column = start.column + 1;
             ast_node.source.end_column = end.column + 1;
+            ast_node.source.start_byte = ts_node_start_byte(entry.node);
+            ast_node.source.end_byte = ts_node_end_byte(entry.node);
             
             // Tree structure -> NEW STRUCTURED FIELDS
             ast_node.structure.parent_id = entry.parent_id;
@@ -107,8 +163,8 @@ ASTResult UnifiedASTBackend::ParseToASTResultTemplated(const AdapterType* adapte
             ast_node.context.name = SanitizeUTF8(raw_name);
             
             // Extract source text (peek) with configurable size and mode
-            uint32_t start_byte = ts_node_start_byte(entry.node);
-            uint32_t end_byte = ts_node_end_byte(entry.node);
+            uint32_t start_byte = ast_node.source.start_byte;
+            uint32_t end_byte = ast_node.source.end_byte;
             if (start_byte < content.size() && end_byte <= content.size() && end_byte > start_byte) {
                 string source_text = content.substr(start_byte, end_byte - start_byte);
                 
@@ -153,18 +209,30 @@ ASTResult UnifiedASTBackend::ParseToASTResultTemplated(const AdapterType* adapte
             int64_t current_id = ast_node.tree_position.node_index;
             for (int32_t i = child_count - 1; i >= 0; i--) {
                 TSNode child = ts_node_child(entry.node, i);
-                stack.push_back({child, current_id, entry.depth + 1, static_cast<uint32_t>(i), false, 0});
+                stack.push_back({child, current_id, entry.depth + 1, static_cast<uint32_t>(i), false, 0, 0});
             }
         } else {
             // Second visit - get the processed entry for descendant calculation
             auto entry = stack.back();
             
             // O(1) descendant count calculation!
-            // All nodes between entry.node_index+1 and nodes.size() are descendants
-            // due to DFS ordering
-            int32_t descendant_count = result.nodes.size() - entry.node_index - 1;
+            // All ids between entry.node_id+1 and next_id are descendants
+            // due to DFS ordering (skipped subtrees included)
+            int32_t descendant_count = next_id - entry.node_id - 1;
+            if (!result.status.empty()) {
+                // Truncated: only the kept prefix is below this node, so that
+                // node_id + descendant_count never runs past the last kept node
+                auto last_kept_id = result.nodes.back().node_id;
+                descendant_count = static_cast<int32_t>(std::min<int64_t>(descendant_count, last_kept_id - entry.node_id));
+            }
             result.nodes[entry.node_index].structure.descendant_count = descendant_count;
             
+            // Merkle hashes come out of the same post-order visit (all children are done);
+            // a pruned or truncated subtree has no complete children to combine
+            if (config.hashes && !scoped && result.status.empty()) {
+                ComputeSubtreeHashes(result.nodes, entry.node_index, entry.node, content);
+            }
+            
             // Update legacy fields after descendant count change
             result.nodes[entry.node_index].UpdateComputedLegacyFields();
             
@@ -1,6 +1,8 @@
 #include "parse_ast_function.hpp"
 #include "unified_ast_backend.hpp"
+#include "ast_parsing_task.hpp"
 #include "duckdb/common/exception.hpp"
+#include "duckdb/common/string_util.hpp"
 #include "duckdb/function/table_function.hpp"
 #include "duckdb/main/extension_util.hpp"
 
@@ -99,6 +101,152 @@ static void ParseASTHierarchicalExecute(ClientContext &context, TableFunctionInp
     output.SetCardinality(output_index);
 }
 
+//==============================================================================
+// parse_ast(TABLE src, code_column, language_column, path_column)
+//==============================================================================
+//
+// Table in-out variant for source stored in tables: every input row is parsed,
+// with the rows of one input chunk spread over all scheduler threads, and its
+// nodes are emitted with the row's path as source.file_path (the row's key).
+// Rows with a NULL code are skipped; a NULL or 'auto' language is detected
+// from the path.
+
+struct ParseASTInOutData : public TableFunctionData {
+    idx_t code_index = 0;
+    idx_t language_index = 0;
+    idx_t path_index = 0;
+    bool ignore_errors = false;
+    int32_t peek_size = 120;
+    string peek_mode = "auto";
+};
+
+struct ParseASTInOutLocalState : public LocalTableFunctionState {
+    vector<ASTResult> results; // Parse results of the current input chunk
+    bool parsed = false;
+    idx_t result_index = 0;
+    idx_t row_index = 0;
+};
+
+// Index of a VARCHAR column of the input table, by (case-insensitive) name
+static idx_t FindInputColumn(TableFunctionBindInput &input, const Value &column_name, const string &argument) {
+    if (column_name.IsNull()) {
+        throw BinderException("parse_ast: %s cannot be NULL", argument);
+    }
+    auto name = StringValue::Get(column_name);
+    for (idx_t i = 0; i < input.input_table_names.size(); i++) {
+        if (!StringUtil::CIEquals(input.input_table_names[i], name)) {
+            continue;
+        }
+        if (input.input_table_types[i].id() != LogicalTypeId::VARCHAR) {
+            throw BinderException("parse_ast: %s \"%s\" must be VARCHAR, not %s", argument, name,
+                                  input.input_table_types[i].ToString());
+        }
+        return i;
+    }
+    throw BinderException("parse_ast: %s \"%s\" is not a column of the input table", argument, name);
+}
+
+static unique_ptr<FunctionData> ParseASTInOutBind(ClientContext &context, TableFunctionBindInput &input,
+                                                  vector<LogicalType> &return_types, vector<string> &names) {
+    // The column names are the last three arguments, after the TABLE
+    auto &inputs = input.inputs;
+    if (inputs.size() < 3) {
+        throw BinderException("parse_ast requires a table and the names of its code, language and path columns");
+    }
+    auto offset = inputs.size() - 3;
+    auto result = make_uniq<ParseASTInOutData>();
+    result->code_index = FindInputColumn(input, inputs[offset], "code_column");
+    result->language_index = FindInputColumn(input, inputs[offset + 1], "language_column");
+    result->path_index = FindInputColumn(input, inputs[offset + 2], "path_column");
+    for (auto &kv : input.named_parameters) {
+        if (kv.first == "ignore_errors") {
+            result->ignore_errors = BooleanValue::Get(kv.second);
+        } else if (kv.first == "peek_size") {
+            result->peek_size = IntegerValue::Get(kv.second);
+        } else if (kv.first == "peek_mode") {
+            result->peek_mode = StringValue::Get(kv.second);
+        }
+    }
+    
+    return_types = UnifiedASTBackend::GetHierarchicalTableSchema();
+    names = UnifiedASTBackend::GetHierarchicalTableColumnNames();
+    return std::move(result);
+}
+
+static unique_ptr<LocalTableFunctionState> ParseASTInOutInitLocal(ExecutionContext &context,
+                                                                  TableFunctionInitInput &input,
+                                                                  GlobalTableFunctionState *global_state) {
+    return make_uniq<ParseASTInOutLocalState>();
+}
+
+// Parse every row of an input chunk at once
+static vector<ASTResult> ParseInputChunk(ClientContext &context, const ParseASTInOutData &bind_data,
+                                         DataChunk &input) {
+    UnifiedVectorFormat code_data;
+    UnifiedVectorFormat language_data;
+    UnifiedVectorFormat path_data;
+    input.data[bind_data.code_index].ToUnifiedFormat(input.size(), code_data);
+    input.data[bind_data.language_index].ToUnifiedFormat(input.size(), language_data);
+    input.data[bind_data.path_index].ToUnifiedFormat(input.size(), path_data);
+    auto codes = UnifiedVectorFormat::GetData<string_t>(code_data);
+    auto languages = UnifiedVectorFormat::GetData<string_t>(language_data);
+    auto paths = UnifiedVectorFormat::GetData<string_t>(path_data);
+    
+    vector<string> row_paths;
+    vector<string> row_languages;
+    vector<string> row_contents;
+    for (idx_t row = 0; row < input.size(); row++) {
+        auto code_idx = code_data.sel->get_index(row);
+        if (!code_data.validity.RowIsValid(code_idx)) {
+            continue;
+        }
+        auto language_idx = language_data.sel->get_index(row);
+        auto path_idx = path_data.sel->get_index(row);
+        row_contents.push_back(codes[code_idx].GetString());
+        row_languages.push_back(language_data.validity.RowIsValid(language_idx) ? languages[language_idx].GetString()
+                                                                                : "auto");
+        row_paths.push_back(path_data.validity.RowIsValid(path_idx) ? paths[path_idx].GetString() : "<inline>");
+    }
+    return ParseContentsParallel(context, row_paths, row_languages, row_contents, bind_data.ignore_errors,
+                                 bind_data.peek_size, bind_data.peek_mode);
+}
+
+static OperatorResultType ParseASTInOutExecute(ExecutionContext &context, TableFunctionInput &data_p,
+                                               DataChunk &input, DataChunk &output) {
+    auto &bind_data = data_p.bind_data->Cast<ParseASTInOutData>();
+    auto &state = data_p.local_state->Cast<ParseASTInOutLocalState>();
+    
+    if (!state.parsed) {
+        state.results = ParseInputChunk(context.client, bind_data, input);
+        state.parsed = true;
+        state.result_index = 0;
+        state.row_index = 0;
+    }
+    
+    // Same columnar projection as read_ast, resumed where the previous output chunk stopped
+    idx_t output_index = 0;
+    while (output_index < STANDARD_VECTOR_SIZE && state.result_index < state.results.size()) {
+        const auto &result = state.results[state.result_index];
+        idx_t old_output_index = output_index;
+        UnifiedASTBackend::ProjectToHierarchicalTableStreaming(result.Nodes(), output, state.row_index, output_index,
+                                                              result.source);
+        state.row_index += output_index - old_output_index;
+        if (state.row_index >= result.Nodes().size()) {
+            state.result_index++;
+            state.row_index = 0;
+        }
+    }
+    output.SetCardinality(output_index);
+    
+    if (state.result_index < state.results.size()) {
+        return OperatorResultType::HAVE_MORE_OUTPUT;
+    }
+    // This chunk is done; release its nodes before the next one arrives
+    state.results.clear();
+    state.parsed = false;
+    return OperatorResultType::NEED_MORE_INPUT;
+}
+
 void ParseASTFunction::Register(DatabaseInstance &instance) {
     // Register parse_ast_flat(code, language) -> TABLE with flat schema (legacy)
     TableFunction parse_ast_flat_func("parse_ast_flat", {LogicalType::VARCHAR, LogicalType::VARCHAR}, 
@@ -107,10 +255,22 @@ void ParseASTFunction::Register(DatabaseInstance &instance) {
     ExtensionUtil::RegisterFunction(instance, parse_ast_flat_func);
     
     // Register parse_ast(code, language) -> TABLE with flat schema (temporarily)
+    TableFunctionSet parse_ast_set("parse_ast");
     TableFunction parse_ast_func("parse_ast", {LogicalType::VARCHAR, LogicalType::VARCHAR}, 
                                 ParseASTHierarchicalExecute, ParseASTHierarchicalBind);
     parse_ast_func.name = "parse_ast";
-    ExtensionUtil::RegisterFunction(instance, parse_ast_func);
+    parse_ast_set.AddFunction(parse_ast_func);
+    
+    // Register parse_ast(TABLE src, code_column, language_column, path_column) -> one row per node
+    TableFunction parse_ast_table("parse_ast",
+                                  {LogicalType::TABLE, LogicalType::VARCHAR, LogicalType::VARCHAR, LogicalType::VARCHAR},
+                                  nullptr, ParseASTInOutBind, nullptr, ParseASTInOutInitLocal);
+    parse_ast_table.in_out_function = ParseASTInOutExecute;
+    parse_ast_table.named_parameters["ignore_errors"] = LogicalType::BOOLEAN;
+    parse_ast_table.named_parameters["peek_size"] = LogicalType::INTEGER;
+    parse_ast_table.named_parameters["peek_mode"] = LogicalType::VARCHAR;
+    parse_ast_set.AddFunction(parse_ast_table);
+    ExtensionUtil::RegisterFunction(instance, parse_ast_set);
 }
 
 } // namespace duckdb
\ No newline at end of file
@@ -0,0 +1,164 @@
+#include "duckdb.hpp"
+#include "duckdb/common/exception.hpp"
+#include "duckdb/function/table_function.hpp"
+#include "duckdb/main/extension_util.hpp"
+#include "ast_file_utils.hpp"
+#include "ast_parsing_task.hpp"
+#include "semantic_types.hpp"
+#include "unified_ast_backend.hpp"
+
+namespace duckdb {
+
+//==============================================================================
+// read_ast_calls(file_patterns, [language]) -> one row per call site
+//==============================================================================
+//
+// Native replacement for the ast_to_call_edges macro. One forward pass over
+// the DFS-ordered nodes keeps a stack of enclosing definitions (functions and
+// classes); a definition is popped once the pass leaves its range
+// [i, i + descendant_count]. Every COMPUTATION_CALL node then yields an edge
+// from the innermost enclosing function, so a file costs O(nodes) instead of
+// a range join. Files are claimed by the scan threads and processed in
+// parallel.
+
+struct ASTCallEdge {
+    int64_t caller_id; // -1 for calls outside any function
+    string caller;
+    string caller_qualified_name;
+    int64_t call_id;
+    string callee;
+    uint32_t start_line;
+    uint32_t start_column;
+    uint32_t end_line;
+    uint32_t end_column;
+};
+
+using ReadASTCallsLocalState = ASTFileScanLocalState<ASTCallEdge>;
+
+static unique_ptr<FunctionData> ReadASTCallsBind(ClientContext &context, TableFunctionBindInput &input,
+                                                 vector<LogicalType> &return_types, vector<string> &names) {
+    auto result = make_uniq<ASTFileBindData>();
+    result->Bind(context, input, "read_ast_calls");
+    result->ResolveLanguages();
+
+    names = {"file_path", "language",   "caller",       "caller_qualified_name", "caller_node_id", "callee",
+             "node_id",   "start_line", "start_column", "end_line",              "end_column"};
+    return_types = {LogicalType::VARCHAR,  LogicalType::VARCHAR,  LogicalType::VARCHAR, LogicalType::VARCHAR,
+                    LogicalType::BIGINT,   LogicalType::VARCHAR,  LogicalType::BIGINT,  LogicalType::UINTEGER,
+                    LogicalType::UINTEGER, LogicalType::UINTEGER, LogicalType::UINTEGER};
+    return std::move(result);
+}
+
+// Text of the called expression: the call's own name when the language config
+// extracts one, otherwise the name (or source preview) of its function child
+static string CalleeText(const vector<ASTNode> &nodes, idx_t call_index) {
+    auto &call = nodes[call_index];
+    if (!call.context.name.empty() || call.structure.descendant_count == 0) {
+        return call.context.name;
+    }
+    auto &function = nodes[call_index + 1];
+    return function.context.name.empty() ? function.peek : function.context.name;
+}
+
+static void ExtractCallEdges(const ASTResult &result, vector<ASTCallEdge> &edges) {
+    const auto &nodes = result.Nodes();
+
+    struct EnclosingDefinition {
+        idx_t last_index; // Last node of the definition's subtree
+        idx_t node_index;
+        bool is_function;
+    };
+    vector<EnclosingDefinition> stack;
+
+    for (idx_t i = 0; i < nodes.size(); i++) {
+        while (!stack.empty() && stack.back().last_index < i) {
+            stack.pop_back();
+        }
+        auto &node = nodes[i];
+        auto base_type = SemanticTypes::GetBaseType(node.context.normalized.semantic_type);
+
+        if (base_type == SemanticTypes::COMPUTATION_CALL) {
+            ASTCallEdge edge;
+            edge.caller_id = -1;
+            // Innermost enclosing function; its qualified name runs through all enclosing definitions
+            for (idx_t s = stack.size(); s > 0; s--) {
+                if (!stack[s - 1].is_function) {
+                    continue;
+                }
+                auto &caller = nodes[stack[s - 1].node_index];
+                edge.caller_id = NumericCast<int64_t>(caller.node_id);
+                edge.caller = caller.context.name;
+                if (!caller.context.native.qualified_name.empty()) {
+                    edge.caller_qualified_name = caller.context.native.qualified_name;
+                } else {
+                    for (idx_t d = 0; d < s; d++) {
+                        auto &name = nodes[stack[d].node_index].context.name;
+                        if (name.empty()) {
+                            continue;
+                        }
+                        if (!edge.caller_qualified_name.empty()) {
+                            edge.caller_qualified_name += ".";
+                        }
+                        edge.caller_qualified_name += name;
+                    }
+                }
+                break;
+            }
+            edge.call_id = NumericCast<int64_t>(node.node_id);
+            edge.callee = CalleeText(nodes, i);
+            edge.start_line = node.source.start_line;
+            edge.start_column = node.source.start_column;
+            edge.end_line = node.source.end_line;
+            edge.end_column = node.source.end_column;
+            edges.push_back(std::move(edge));
+        }
+
+        if (base_type == SemanticTypes::DEFINITION_FUNCTION || base_type == SemanticTypes::DEFINITION_CLASS) {
+            stack.push_back({i + node.structure.descendant_count, i, base_type == SemanticTypes::DEFINITION_FUNCTION});
+        }
+    }
+}
+
+static void ReadASTCallsFunction(ClientContext &context, TableFunctionInput &data_p, DataChunk &output) {
+    auto &bind_data = data_p.bind_data->Cast<ASTFileBindData>();
+    auto &global_state = data_p.global_state->Cast<ASTFileScanGlobalState>();
+    auto &local_state = data_p.local_state->Cast<ReadASTCallsLocalState>();
+
+    idx_t count = 0;
+    while (count < STANDARD_VECTOR_SIZE) {
+        auto edge = local_state.Next(context, bind_data, global_state,
+                                     [&](const ASTResult &result) { ExtractCallEdges(result, local_state.rows); });
+        if (!edge) {
+            break;
+        }
+        output.SetValue(0, count, Value(bind_data.file_paths[local_state.file_idx]));
+        output.SetValue(1, count, Value(bind_data.languages[local_state.file_idx]));
+        output.SetValue(2, count, ASTFileUtils::OptionalString(edge->caller));
+        output.SetValue(3, count, ASTFileUtils::OptionalString(edge->caller_qualified_name));
+        output.SetValue(4, count, edge->caller_id < 0 ? Value(LogicalType::BIGINT) : Value::BIGINT(edge->caller_id));
+        output.SetValue(5, count, ASTFileUtils::OptionalString(edge->callee));
+        output.SetValue(6, count, Value::BIGINT(edge->call_id));
+        output.SetValue(7, count, Value::UINTEGER(edge->start_line));
+        output.SetValue(8, count, Value::UINTEGER(edge->start_column));
+        output.SetValue(9, count, Value::UINTEGER(edge->end_line));
+        output.SetValue(10, count, Value::UINTEGER(edge->end_column));
+        count++;
+    }
+    output.SetCardinality(count);
+}
+
+static TableFunction GetReadASTCallsFunction(const vector<LogicalType> &arguments) {
+    TableFunction read_ast_calls("read_ast_calls", arguments, ReadASTCallsFunction, ReadASTCallsBind,
+                                 ASTFileScanGlobalState::Init, ASTFileScanInitLocal<ReadASTCallsLocalState>);
+    read_ast_calls.named_parameters["ignore_errors"] = LogicalType::BOOLEAN;
+    return read_ast_calls;
+}
+
+void RegisterReadASTCallsFunction(DatabaseInstance &instance) {
+    TableFunctionSet read_ast_calls("read_ast_calls");
+    read_ast_calls.AddFunction(GetReadASTCallsFunction({LogicalType::ANY}));                       // Auto-detect
+    read_ast_calls.AddFunction(GetReadASTCallsFunction({LogicalType::ANY, LogicalType::VARCHAR})); // Explicit language
+    ExtensionUtil::RegisterFunction(instance, read_ast_calls);
+}
+
+} // namespace duckdb
@@ -0,0 +1,266 @@
+#include "duckdb.hpp"
+#include "duckdb/common/exception.hpp"
+#include "duckdb/function/table_function.hpp"
+#include "duckdb/main/extension_util.hpp"
+#include "ast_file_discovery.hpp"
+#include "ast_file_utils.hpp"
+#include "ast_git_repository.hpp"
+#include "unified_ast_backend.hpp"
+#include <algorithm>
+#include <unordered_set>
+
+namespace duckdb {
+
+//==============================================================================
+// read_ast_git(repo_path, [pattern], revs := [...]) -> one row per node per commit
+//==============================================================================
+//
+// Parses files straight from a repository's object store, without checking
+// anything out. The trees of all revisions are listed first; a file is then
+// identified by its blob id (and language), so each distinct blob is parsed
+// exactly once, and its nodes are emitted for every (commit, path) holding it.
+// Scanning many commits costs about as much as parsing the distinct blobs.
+//
+// Threads claim blobs, not commits: a blob's rows are emitted by the thread
+// that parsed it, so there is no shared result store.
+
+struct ReadASTGitBlob {
+    string blob_id;
+    string language;
+};
+
+struct ReadASTGitEntry {
+    idx_t commit_idx;
+    idx_t blob_idx;
+    string path;
+};
+
+struct ReadASTGitBindData : public TableFunctionData {
+    shared_ptr<ASTGitRepository> repository;
+    vector<string> commit_hashes;  // Hex ids, one per distinct revision
+    vector<ReadASTGitBlob> blobs;
+    vector<ReadASTGitEntry> entries; // Grouped by blob
+    vector<idx_t> blob_entry_starts; // First entry of each blob, plus the end
+    bool ignore_errors = false;
+    int32_t peek_size = 120;
+    string peek_mode = "auto";
+};
+
+struct ReadASTGitGlobalState : public GlobalTableFunctionState {
+    explicit ReadASTGitGlobalState(idx_t blob_count) : next_blob(0), max_threads(MaxValue<idx_t>(blob_count, 1)) {
+    }
+
+    idx_t MaxThreads() const override {
+        return max_threads;
+    }
+
+    atomic<idx_t> next_blob;
+    const idx_t max_threads;
+};
+
+struct ReadASTGitLocalState : public LocalTableFunctionState {
+    ASTResult result;     // Parse of the claimed blob
+    idx_t entry_idx = 0;  // Entry being emitted
+    idx_t entry_end = 0;  // End of the claimed blob's entries
+    idx_t row_index = 0;  // Next node of the current entry
+};
+
+static unique_ptr<FunctionData> ReadASTGitBind(ClientContext &context, TableFunctionBindInput &input,
+                                               vector<LogicalType> &return_types, vector<string> &names) {
+    auto result = make_uniq<ReadASTGitBindData>();
+
+    if (input.inputs[0].IsNull()) {
+        throw BinderException("read_ast_git: repo_path cannot be NULL");
+    }
+    auto repo_path = input.inputs[0].GetValue<string>();
+    string pattern;
+    if (input.inputs.size() > 1) {
+        if (input.inputs[1].IsNull()) {
+            throw BinderException("read_ast_git: pattern cannot be NULL");
+        }
+        pattern = input.inputs[1].GetValue<string>();
+    }
+    vector<string> revisions;
+    for (auto &kv : input.named_parameters) {
+        if (kv.first == "revs") {
+            if (kv.second.IsNull()) {
+                throw BinderException("read_ast_git: revs cannot be NULL");
+            }
+            for (auto &revision : ListValue::GetChildren(kv.second)) {
+                if (revision.IsNull()) {
+                    throw BinderException("read_ast_git: revs cannot contain NULL");
+                }
+                revisions.push_back(revision.GetValue<string>());
+            }
+        } else if (kv.first == "ignore_errors") {
+            result->ignore_errors = BooleanValue::Get(kv.second);
+        } else if (kv.first == "peek_size") {
+            result->peek_size = IntegerValue::Get(kv.second);
+        } else if (kv.first == "peek_mode") {
+            result->peek_mode = StringValue::Get(kv.second);
+        }
+    }
+    if (revisions.empty()) {
+        revisions.push_back("HEAD");
+    }
+
+    result->repository = make_shared_ptr<ASTGitRepository>(context, repo_path);
+    auto &repository = *result->repository;
+
+    // List every revision's files, keeping one blob per (content, language)
+    unordered_map<string, idx_t> blob_indexes;
+    unordered_set<string> seen_commits;
+    vector<ASTGitTreeEntry> files;
+    for (auto &revision : revisions) {
+        auto commit_id = repository.ResolveRevision(revision);
+        if (!seen_commits.insert(commit_id).second) {
+            continue;
+        }
+        auto commit_idx = result->commit_hashes.size();
+        result->commit_hashes.push_back(ASTGitRepository::ToHex(commit_id));
+
+        files.clear();
+        repository.ListFiles(commit_id, files);
+        for (auto &file : files) {
+            // Without a pattern, files of unknown languages are skipped quietly
+            if (!pattern.empty() && !ASTFileDiscovery::MatchPath(pattern, file.path)) {
+                continue;
+            }
+            auto language = ASTFileUtils::DetectLanguageFromPath(file.path);
+            if (language == "auto") {
+                if (pattern.empty() || result->ignore_errors) {
+                    continue;
+                }
+                throw BinderException("Could not detect language for file: " + file.path);
+            }
+            auto key = file.blob_id + ":" + language;
+            auto entry = blob_indexes.find(key);
+            if (entry == blob_indexes.end()) {
+                entry = blob_indexes.emplace(key, result->blobs.size()).first;
+                result->blobs.push_back(ReadASTGitBlob {file.blob_id, language});
+            }
+            result->entries.push_back(ReadASTGitEntry {commit_idx, entry->second, file.path});
+        }
+    }
+
+    // Group the entries by blob, in revision order within each blob
+    std::stable_sort(result->entries.begin(), result->entries.end(),
+                     [](const ReadASTGitEntry &a, const ReadASTGitEntry &b) { return a.blob_idx < b.blob_idx; });
+    result->blob_entry_starts.resize(result->blobs.size() + 1, result->entries.size());
+    for (idx_t i = result->entries.size(); i > 0; i--) {
+        result->blob_entry_starts[result->entries[i - 1].blob_idx] = i - 1;
+    }
+
+    names = {"commit_hash", "file_hash"};
+    return_types = {LogicalType::VARCHAR, LogicalType::VARCHAR};
+    for (auto &name : UnifiedASTBackend::GetHierarchicalTableColumnNames()) {
+        names.push_back(name);
+    }
+    for (auto &type : UnifiedASTBackend::GetHierarchicalTableSchema()) {
+        return_types.push_back(type);
+    }
+    return std::move(result);
+}
+
+static unique_ptr<GlobalTableFunctionState> ReadASTGitInitGlobal(ClientContext &context,
+                                                                 TableFunctionInitInput &input) {
+    auto &bind_data = input.bind_data->Cast<ReadASTGitBindData>();
+    return make_uniq<ReadASTGitGlobalState>(bind_data.blobs.size());
+}
+
+static unique_ptr<LocalTableFunctionState> ReadASTGitInitLocal(ExecutionContext &context,
+                                                               TableFunctionInitInput &input,
+                                                               GlobalTableFunctionState *global_state) {
+    return make_uniq<ReadASTGitLocalState>();
+}
+
+// Read and parse a blob; false when it failed and ignore_errors is set
+static bool ParseBlob(const ReadASTGitBindData &bind_data, idx_t blob_idx, ASTResult &result) {
+    const auto &blob = bind_data.blobs[blob_idx];
+    const auto &path = bind_data.entries[bind_data.blob_entry_starts[blob_idx]].path;
+    try {
+        auto content = bind_data.repository->ReadBlob(blob.blob_id);
+        auto config = UnifiedASTBackend::LegacyExtractionConfig(bind_data.peek_size, bind_data.peek_mode);
+        result = UnifiedASTBackend::ParseToASTResult(content, blob.language, path, config);
+        return true;
+    } catch (const Exception &e) {
+        if (!bind_data.ignore_errors) {
+            throw;
+        }
+        return false;
+    }
+}
+
+static void ReadASTGitFunction(ClientContext &context, TableFunctionInput &data_p, DataChunk &output) {
+    auto &bind_data = data_p.bind_data->Cast<ReadASTGitBindData>();
+    auto &global_state = data_p.global_state->Cast<ReadASTGitGlobalState>();
+    auto &local_state = data_p.local_state->Cast<ReadASTGitLocalState>();
+
+    // The node columns are projected like read_ast's, into a chunk of their own
+    DataChunk nodes;
+    nodes.Initialize(Allocator::Get(context), UnifiedASTBackend::GetHierarchicalTableSchema());
+    auto commit_hashes = FlatVector::GetData<string_t>(output.data[0]);
+    auto file_hashes = FlatVector::GetData<string_t>(output.data[1]);
+
+    idx_t output_index = 0;
+    while (output_index < STANDARD_VECTOR_SIZE) {
+        if (local_state.entry_idx >= local_state.entry_end) {
+            // Claim the next blob
+            auto blob_idx = global_state.next_blob.fetch_add(1);
+            if (blob_idx >= bind_data.blobs.size()) {
+                break;
+            }
+            local_state.entry_idx = bind_data.blob_entry_starts[blob_idx];
+            local_state.entry_end = bind_data.blob_entry_starts[blob_idx + 1];
+            local_state.row_index = 0;
+            if (!ParseBlob(bind_data, blob_idx, local_state.result)) {
+                local_state.entry_idx = local_state.entry_end;
+            }
+            continue;
+        }
+
+        const auto &entry = bind_data.entries[local_state.entry_idx];
+        const auto &result_nodes = local_state.result.Nodes();
+        ASTSource source {entry.path, local_state.result.source.language};
+        auto old_output_index = output_index;
+        UnifiedASTBackend::ProjectToHierarchicalTableStreaming(result_nodes, nodes, local_state.row_index,
+                                                               output_index, source);
+        auto commit_hash = bind_data.commit_hashes[entry.commit_idx];
+        auto file_hash = ASTGitRepository::ToHex(bind_data.blobs[entry.blob_idx].blob_id);
+        for (idx_t row = old_output_index; row < output_index; row++) {
+            commit_hashes[row] = StringVector::AddString(output.data[0], commit_hash);
+            file_hashes[row] = StringVector::AddString(output.data[1], file_hash);
+        }
+
+        local_state.row_index += output_index - old_output_index;
+        if (local_state.row_index >= result_nodes.size()) {
+            local_state.entry_idx++;
+            local_state.row_index = 0;
+        }
+    }
+
+    nodes.SetCardinality(output_index);
+    for (idx_t col = 0; col < nodes.ColumnCount(); col++) {
+        output.data[col + 2].Reference(nodes.data[col]);
+    }
+    output.SetCardinality(output_index);
+}
+
+static TableFunction GetReadASTGitFunction(const vector<LogicalType> &arguments) {
+    TableFunction read_ast_git("read_ast_git", arguments, ReadASTGitFunction, ReadASTGitBind, ReadASTGitInitGlobal,
+                               ReadASTGitInitLocal);
+    read_ast_git.named_parameters["revs"] = LogicalType::LIST(LogicalType::VARCHAR);
+    read_ast_git.named_parameters["ignore_errors"] = LogicalType::BOOLEAN;
+    read_ast_git.named_parameters["peek_size"] = LogicalType::INTEGER;
+    read_ast_git.named_parameters["peek_mode"] = LogicalType::VARCHAR;
+    return read_ast_git;
+}
+
+void RegisterReadASTGitFunction(DatabaseInstance &instance) {
+    TableFunctionSet read_ast_git("read_ast_git");
+    read_ast_git.AddFunction(GetReadASTGitFunction({LogicalType::VARCHAR}));                       // Whole tree
+    read_ast_git.AddFunction(GetReadASTGitFunction({LogicalType::VARCHAR, LogicalType::VARCHAR})); // Path pattern
+    ExtensionUtil::RegisterFunction(instance, read_ast_git);
+}
+
+} // namespace duckdb
@@ -0,0 +1,266 @@
+#include "duckdb.hpp"
+#include "duckdb/common/exception.hpp"
+#include "duckdb/function/table_function.hpp"
+#include "duckdb/main/extension_util.hpp"
+#include "ast_file_utils.hpp"
+#include "ast_parsing_task.hpp"
+#include "node_config.hpp"
+#include "semantic_types.hpp"
+#include "unified_ast_backend.hpp"
+#include <cmath>
+#include <unordered_set>
+
+namespace duckdb {
+
+//==============================================================================
+// read_ast_metrics(file_patterns, [language]) -> one row per function
+//==============================================================================
+//
+// Complexity metrics computed in a single forward pass over the DFS-ordered
+// nodes, replacing the self-joins of ast_to_complexity_metrics. Every open
+// function keeps an accumulator on a stack; nodes are attributed to the
+// innermost function only, and a function's row is emitted when the pass
+// leaves its range [i, i + descendant_count] - its post-order visit.
+//
+// - cyclomatic_complexity: 1 + decisions. A decision is a non-leaf
+//   FLOW_CONDITIONAL or FLOW_LOOP node (else clauses excluded) or a binary
+//   OPERATOR_LOGICAL token (and, or, &&, ||).
+// - max_nesting_depth: deepest chain of decision nodes inside the function.
+//   A conditional directly under a conditional (elif, else if) continues the
+//   chain instead of nesting.
+// - Halstead: operators are keyword and OPERATOR tokens, operands are NAME
+//   tokens and whole LITERAL subtrees. Punctuation is not counted.
+
+struct ASTFunctionMetrics {
+    int64_t node_id;
+    string type;
+    string name;
+    string qualified_name;
+    uint32_t start_line;
+    uint32_t end_line;
+    uint32_t decisions = 0;
+    uint32_t max_nesting_depth = 0;
+    uint32_t total_operators = 0;
+    uint32_t total_operands = 0;
+    uint32_t distinct_operators = 0;
+    uint32_t distinct_operands = 0;
+};
+
+using ReadASTMetricsLocalState = ASTFileScanLocalState<ASTFunctionMetrics>;
+
+static unique_ptr<FunctionData> ReadASTMetricsBind(ClientContext &context, TableFunctionBindInput &input,
+                                                   vector<LogicalType> &return_types, vector<string> &names) {
+    auto result = make_uniq<ASTFileBindData>();
+    result->Bind(context, input, "read_ast_metrics");
+    result->ResolveLanguages();
+
+    names = {"file_path",          "language",          "node_id",           "type",
+             "name",               "qualified_name",    "start_line",        "end_line",
+             "lines",              "cyclomatic_complexity", "max_nesting_depth", "distinct_operators",
+             "distinct_operands",  "total_operators",   "total_operands",    "halstead_volume",
+             "halstead_difficulty", "halstead_effort"};
+    return_types = {LogicalType::VARCHAR,  LogicalType::VARCHAR,  LogicalType::BIGINT,   LogicalType::VARCHAR,
+                    LogicalType::VARCHAR,  LogicalType::VARCHAR,  LogicalType::UINTEGER, LogicalType::UINTEGER,
+                    LogicalType::UINTEGER, LogicalType::UINTEGER, LogicalType::UINTEGER, LogicalType::UINTEGER,
+                    LogicalType::UINTEGER, LogicalType::UINTEGER, LogicalType::UINTEGER, LogicalType::DOUBLE,
+                    LogicalType::DOUBLE,   LogicalType::DOUBLE};
+    return std::move(result);
+}
+
+static bool IsConditional(const ASTNode &node) {
+    return SemanticTypes::GetBaseType(node.context.normalized.semantic_type) == SemanticTypes::FLOW_CONDITIONAL;
+}
+
+// Non-leaf conditional or loop, other than an else clause
+static bool IsDecisionNode(const ASTNode &node) {
+    auto base_type = SemanticTypes::GetBaseType(node.context.normalized.semantic_type);
+    if (base_type != SemanticTypes::FLOW_CONDITIONAL && base_type != SemanticTypes::FLOW_LOOP) {
+        return false;
+    }
+    return node.structure.children_count > 0 && node.type.raw != "else_clause";
+}
+
+static void ExtractFunctionMetrics(const ASTResult &result, vector<ASTFunctionMetrics> &functions) {
+    const auto &nodes = result.Nodes();
+
+    struct OpenDefinition {
+        idx_t last_index; // Last node of the definition's subtree
+        idx_t node_index;
+        bool is_function;
+        // Function accumulator
+        idx_t metrics_index;
+        idx_t nesting_base; // Size of the decision stack when the function was entered
+        unordered_set<string> operators;
+        unordered_set<string> operands;
+    };
+    vector<OpenDefinition> stack;
+    vector<idx_t> decisions; // Last index of each open nesting decision node
+    idx_t literal_last = 0;  // Tokens up to here belong to an already counted literal
+    bool in_literal = false;
+
+    auto close_definition = [&](OpenDefinition &definition) {
+        if (definition.is_function) {
+            auto &metrics = functions[definition.metrics_index];
+            metrics.distinct_operators = NumericCast<uint32_t>(definition.operators.size());
+            metrics.distinct_operands = NumericCast<uint32_t>(definition.operands.size());
+        }
+    };
+
+    for (idx_t i = 0; i < nodes.size(); i++) {
+        while (!stack.empty() && stack.back().last_index < i) {
+            close_definition(stack.back());
+            stack.pop_back();
+        }
+        while (!decisions.empty() && decisions.back() < i) {
+            decisions.pop_back();
+        }
+        if (in_literal && literal_last < i) {
+            in_literal = false;
+        }
+        auto &node = nodes[i];
+        auto semantic_type = node.context.normalized.semantic_type;
+        auto base_type = SemanticTypes::GetBaseType(semantic_type);
+        auto kind = SemanticTypes::GetKind(semantic_type);
+        bool is_leaf = node.structure.children_count == 0;
+
+        // Innermost enclosing function
+        OpenDefinition *function = nullptr;
+        for (idx_t s = stack.size(); s > 0; s--) {
+            if (stack[s - 1].is_function) {
+                function = &stack[s - 1];
+                break;
+            }
+        }
+
+        if (function && !in_literal) {
+            auto &metrics = functions[function->metrics_index];
+            if (IsDecisionNode(node)) {
+                metrics.decisions++;
+                bool continues_chain = IsConditional(node) && node.structure.parent_id >= 0 &&
+                                       IsConditional(nodes[node.structure.parent_id]);
+                if (!continues_chain) {
+                    decisions.push_back(i + node.structure.descendant_count);
+                    auto depth = NumericCast<uint32_t>(decisions.size() - function->nesting_base);
+                    metrics.max_nesting_depth = MaxValue(metrics.max_nesting_depth, depth);
+                }
+            }
+            if (kind == SemanticTypes::LITERAL) {
+                // A literal counts once as an operand, whatever its inner structure
+                metrics.total_operands++;
+                function->operands.insert(node.context.name.empty() ? node.peek : node.context.name);
+                in_literal = true;
+                literal_last = i + node.structure.descendant_count;
+            } else if (is_leaf && kind == SemanticTypes::NAME) {
+                metrics.total_operands++;
+                function->operands.insert(node.context.name.empty() ? node.peek : node.context.name);
+            } else if (is_leaf && (kind == SemanticTypes::OPERATOR ||
+                                   (node.context.normalized.universal_flags & ASTNodeFlags::IS_KEYWORD))) {
+                metrics.total_operators++;
+                function->operators.insert(node.type.raw);
+                if (base_type == SemanticTypes::OPERATOR_LOGICAL && node.structure.parent_id >= 0 &&
+                    nodes[node.structure.parent_id].structure.children_count >= 3) {
+                    metrics.decisions++;
+                }
+            }
+        }
+
+        // Keyword leaves such as `def` share the definition's semantic type
+        if (!is_leaf &&
+            (base_type == SemanticTypes::DEFINITION_FUNCTION || base_type == SemanticTypes::DEFINITION_CLASS)) {
+            OpenDefinition definition;
+            definition.last_index = i + node.structure.descendant_count;
+            definition.node_index = i;
+            definition.is_function = base_type == SemanticTypes::DEFINITION_FUNCTION;
+            definition.metrics_index = functions.size();
+            definition.nesting_base = decisions.size();
+            if (definition.is_function) {
+                ASTFunctionMetrics metrics;
+                metrics.node_id = NumericCast<int64_t>(node.node_id);
+                metrics.type = node.type.raw;
+                metrics.name = node.context.name;
+                if (!node.context.native.qualified_name.empty()) {
+                    metrics.qualified_name = node.context.native.qualified_name;
+                } else {
+                    for (auto &open : stack) {
+                        auto &name = nodes[open.node_index].context.name;
+                        if (!name.empty()) {
+                            metrics.qualified_name += name + ".";
+                        }
+                    }
+                    metrics.qualified_name += node.context.name;
+                }
+                metrics.start_line = node.source.start_line;
+                metrics.end_line = node.source.end_line;
+                functions.push_back(std::move(metrics));
+            }
+            stack.push_back(std::move(definition));
+        }
+    }
+    while (!stack.empty()) {
+        close_definition(stack.back());
+        stack.pop_back();
+    }
+}
+
+static void ReadASTMetricsFunction(ClientContext &context, TableFunctionInput &data_p, DataChunk &output) {
+    auto &bind_data = data_p.bind_data->Cast<ASTFileBindData>();
+    auto &global_state = data_p.global_state->Cast<ASTFileScanGlobalState>();
+    auto &local_state = data_p.local_state->Cast<ReadASTMetricsLocalState>();
+
+    idx_t count = 0;
+    while (count < STANDARD_VECTOR_SIZE) {
+        auto function = local_state.Next(context, bind_data, global_state, [&](const ASTResult &result) {
+            ExtractFunctionMetrics(result, local_state.rows);
+        });
+        if (!function) {
+            break;
+        }
+        auto &metrics = *function;
+
+        // Halstead measures from the operator/operand counts
+        double vocabulary = metrics.distinct_operators + metrics.distinct_operands;
+        double length = metrics.total_operators + metrics.total_operands;
+        double volume = vocabulary > 0 ? length * std::log2(vocabulary) : 0;
+        double difficulty = metrics.distinct_operands > 0
+                                ? (metrics.distinct_operators / 2.0) *
+                                      (double(metrics.total_operands) / metrics.distinct_operands)
+                                : 0;
+
+        output.SetValue(0, count, Value(bind_data.file_paths[local_state.file_idx]));
+        output.SetValue(1, count, Value(bind_data.languages[local_state.file_idx]));
+        output.SetValue(2, count, Value::BIGINT(metrics.node_id));
+        output.SetValue(3, count, Value(metrics.type));
+        output.SetValue(4, count, ASTFileUtils::OptionalString(metrics.name));
+        output.SetValue(5, count, ASTFileUtils::OptionalString(metrics.qualified_name));
+        output.SetValue(6, count, Value::UINTEGER(metrics.start_line));
+        output.SetValue(7, count, Value::UINTEGER(metrics.end_line));
+        output.SetValue(8, count, Value::UINTEGER(metrics.end_line - metrics.start_line + 1));
+        output.SetValue(9, count, Value::UINTEGER(1 + metrics.decisions));
+        output.SetValue(10, count, Value::UINTEGER(metrics.max_nesting_depth));
+        output.SetValue(11, count, Value::UINTEGER(metrics.distinct_operators));
+        output.SetValue(12, count, Value::UINTEGER(metrics.distinct_operands));
+        output.SetValue(13, count, Value::UINTEGER(metrics.total_operators));
+        output.SetValue(14, count, Value::UINTEGER(metrics.total_operands));
+        output.SetValue(15, count, Value::DOUBLE(volume));
+        output.SetValue(16, count, Value::DOUBLE(difficulty));
+        output.SetValue(17, count, Value::DOUBLE(difficulty * volume));
+        count++;
+    }
+    output.SetCardinality(count);
+}
+
+static TableFunction GetReadASTMetricsFunction(const vector<LogicalType> &arguments) {
+    TableFunction read_ast_metrics("read_ast_metrics", arguments, ReadASTMetricsFunction, ReadASTMetricsBind,
+                                   ASTFileScanGlobalState::Init, ASTFileScanInitLocal<ReadASTMetricsLocalState>);
+    read_ast_metrics.named_parameters["ignore_errors"] = LogicalType::BOOLEAN;
+    return read_ast_metrics;
+}
+
+void RegisterReadASTMetricsFunction(DatabaseInstance &instance) {
+    TableFunctionSet read_ast_metrics("read_ast_metrics");
+    read_ast_metrics.AddFunction(GetReadASTMetricsFunction({LogicalType::ANY}));                       // Auto-detect
+    read_ast_metrics.AddFunction(GetReadASTMetricsFunction({LogicalType::ANY, LogicalType::VARCHAR})); // Explicit language
+    ExtensionUtil::RegisterFunction(instance, read_ast_metrics);
+}
+
+} // namespace duckdb
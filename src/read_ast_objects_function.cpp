@@ -0,0 +1,85 @@
+#include "duckdb.hpp"
+#include "duckdb/function/table_function.hpp"
+#include "duckdb/main/extension_util.hpp"
+#include "ast_parsing_task.hpp"
+#include "unified_ast_backend.hpp"
+
+namespace duckdb {
+
+//==============================================================================
+// read_ast_objects(file_patterns, [language], ...) -> one row per file
+//==============================================================================
+//
+// Same parse as read_ast, but each file becomes a single row whose `nodes`
+// column holds all of its nodes as LIST(STRUCT). The list child vectors are
+// filled straight from the parse results (UnifiedASTBackend::ProjectToNodeList),
+// which replaces `read_ast` + `GROUP BY file_path` + `LIST(...)`.
+//
+// `status` says how each file was read: 'ok', 'truncated' (max_nodes reached,
+// `nodes` is a preorder prefix) or why skip_generated / max_file_size skipped
+// it ('binary', 'minified', 'generated', 'too_large'; `nodes` is empty).
+
+struct ReadASTObjectsGlobalState : public GlobalTableFunctionState {
+    ASTFileParseState files;
+};
+
+static unique_ptr<FunctionData> ReadASTObjectsBind(ClientContext &context, TableFunctionBindInput &input,
+                                                   vector<LogicalType> &return_types, vector<string> &names) {
+    auto result = make_uniq<ASTFileBindData>();
+    result->Bind(context, input, "read_ast_objects");
+
+    names = {"file_path", "language", "nodes", "status"};
+    return_types = {LogicalType::VARCHAR, LogicalType::VARCHAR,
+                    LogicalType::LIST(UnifiedASTBackend::GetASTNodeStructSchema()), LogicalType::VARCHAR};
+    return std::move(result);
+}
+
+static unique_ptr<GlobalTableFunctionState> ReadASTObjectsInit(ClientContext &context,
+                                                               TableFunctionInitInput &input) {
+    auto result = make_uniq<ReadASTObjectsGlobalState>();
+    result->files.Initialize(input.bind_data->Cast<ASTFileBindData>());
+    return std::move(result);
+}
+
+static void ReadASTObjectsFunction(ClientContext &context, TableFunctionInput &data_p, DataChunk &output) {
+    auto &bind_data = data_p.bind_data->Cast<ASTFileBindData>();
+    auto &state = data_p.global_state->Cast<ReadASTObjectsGlobalState>();
+
+    auto file_path_vec = FlatVector::GetData<string_t>(output.data[0]);
+    auto language_vec = FlatVector::GetData<string_t>(output.data[1]);
+    auto status_vec = FlatVector::GetData<string_t>(output.data[3]);
+
+    idx_t count = 0;
+    ASTResult *parsed;
+    while (count < STANDARD_VECTOR_SIZE && (parsed = state.files.Next(context, bind_data)) != nullptr) {
+        file_path_vec[count] = StringVector::AddString(output.data[0], parsed->source.file_path);
+        language_vec[count] = StringVector::AddString(output.data[1], parsed->source.language);
+        UnifiedASTBackend::ProjectToNodeList(*parsed, output.data[2], count);
+        status_vec[count] = StringVector::AddString(output.data[3], parsed->status.empty() ? "ok" : parsed->status);
+        // Nodes now live in the output vector
+        *parsed = ASTResult();
+        count++;
+    }
+    output.SetCardinality(count);
+}
+
+static TableFunction GetReadASTObjectsFunction(const vector<LogicalType> &arguments) {
+    TableFunction read_ast_objects("read_ast_objects", arguments, ReadASTObjectsFunction, ReadASTObjectsBind,
+                                   ReadASTObjectsInit);
+    read_ast_objects.named_parameters["ignore_errors"] = LogicalType::BOOLEAN;
+    read_ast_objects.named_parameters["peek_size"] = LogicalType::INTEGER;
+    read_ast_objects.named_parameters["peek_mode"] = LogicalType::VARCHAR;
+    read_ast_objects.named_parameters["skip_generated"] = LogicalType::BOOLEAN;
+    read_ast_objects.named_parameters["max_file_size"] = LogicalType::BIGINT;
+    read_ast_objects.named_parameters["max_nodes"] = LogicalType::BIGINT;
+    return read_ast_objects;
+}
+
+void RegisterReadASTObjectsFunction(DatabaseInstance &instance) {
+    TableFunctionSet read_ast_objects("read_ast_objects");
+    read_ast_objects.AddFunction(GetReadASTObjectsFunction({LogicalType::ANY}));                       // Auto-detect
+    read_ast_objects.AddFunction(GetReadASTObjectsFunction({LogicalType::ANY, LogicalType::VARCHAR})); // Explicit language
+    ExtensionUtil::RegisterFunction(instance, read_ast_objects);
+}
+
+} // namespace duckdb
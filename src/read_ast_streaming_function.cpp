@@ -4,13 +4,16 @@
 #include "duckdb/common/file_system.hpp"
 #include "duckdb/common/string_util.hpp"
 #include "duckdb/common/multi_file/multi_file_reader.hpp"
+#include "duckdb/common/types/hash.hpp"
 #include "duckdb/parallel/task_executor.hpp"
 #include "duckdb/parallel/task_scheduler.hpp"
 #include "unified_ast_backend.hpp"
 #include "ast_file_utils.hpp"
+#include "ast_file_discovery.hpp"
 #include "ast_parsing_task.hpp"
 #include "read_ast_streaming_state.hpp"
 #include "language_adapter.hpp"
+#include <algorithm>
 #include <unordered_set>
 
 namespace duckdb {
@@ -162,6 +165,56 @@ static unique_ptr<FunctionData> ReadASTFlatStreamingBindOneArg(ClientContext &co
     return make_uniq<ReadASTStreamingBindData>(file_patterns, language, ignore_errors, peek_size, peek_mode, batch_size);
 }
 
+// file_id = 31-bit hash of the path, so a file keeps its id, and its nodes keep
+// their keys, across runs and as other files come and go. Paths are assigned in
+// path order and a path whose id is taken moves to the next free one, so ids are
+// unique; that only depends on the other paths when two of them collide. Every
+// file the patterns match, in any shard, is assigned, so the ids agree with
+// read_ast_files and between shards.
+static void AssignFileIds(unordered_map<string, int32_t> &file_ids, vector<string> file_paths) {
+    std::sort(file_paths.begin(), file_paths.end());
+    file_paths.erase(std::unique(file_paths.begin(), file_paths.end()), file_paths.end());
+    file_ids.clear();
+    file_ids.reserve(file_paths.size());
+    std::unordered_set<int32_t> taken;
+    for (auto &file_path : file_paths) {
+        auto file_id = int32_t(Hash(file_path.c_str(), file_path.size()) & 0x7FFFFFFF);
+        while (!taken.insert(file_id).second) {
+            file_id = (file_id + 1) & 0x7FFFFFFF;
+        }
+        file_ids[file_path] = file_id;
+    }
+}
+
+// Fill file_id, node_key (file_id << 32 | node_id) and parent_key for the output
+// rows [first_output, end_output), which hold the result's nodes from start_row on
+static void ProjectGlobalKeys(const ReadASTStreamingGlobalState &global_state, const ASTResult &result,
+                              idx_t start_row, idx_t first_output, idx_t end_output, DataChunk &output) {
+    if (!global_state.global_keys || first_output == end_output) {
+        return;
+    }
+    auto entry = global_state.file_ids.find(result.source.file_path);
+    if (entry == global_state.file_ids.end()) {
+        throw InternalException("read_ast: no file_id for \"%s\"", result.source.file_path);
+    }
+    auto file_ids = FlatVector::GetData<int32_t>(output.data[6]);
+    auto node_keys = FlatVector::GetData<int64_t>(output.data[7]);
+    auto parent_keys = FlatVector::GetData<int64_t>(output.data[8]);
+    auto &parent_validity = FlatVector::Validity(output.data[8]);
+    const auto key_base = int64_t(entry->second) << 32;
+    const auto &nodes = result.Nodes();
+    for (idx_t row = first_output; row < end_output; row++) {
+        const auto &node = nodes[start_row + row - first_output];
+        file_ids[row] = entry->second;
+        node_keys[row] = key_base | node.node_id;
+        if (node.tree_position.parent_index < 0) {
+            parent_validity.SetInvalid(row);
+        } else {
+            parent_keys[row] = key_base | node.tree_position.parent_index;
+        }
+    }
+}
+
 // Initialize global state for streaming with parallel processing
 static unique_ptr<GlobalTableFunctionState> ReadASTStreamingInit(ClientContext &context, TableFunctionInitInput &input) {
     auto &bind_data = input.bind_data->Cast<ReadASTStreamingBindData>();
@@ -173,6 +226,19 @@ static unique_ptr<GlobalTableFunctionState> ReadASTStreamingInit(ClientContext &
     result->peek_size = bind_data.peek_size;
     result->peek_mode = bind_data.peek_mode;
     result->batch_size = bind_data.batch_size;
+    result->line_ranges = bind_data.line_ranges;
+    result->ordered = bind_data.ordered;
+    if (!bind_data.content_filter.empty()) {
+        result->content_filter = make_uniq<ASTContentFilter>(
+            ASTContentFilter::Create(bind_data.content_filter, bind_data.content_filter_mode));
+    }
+    if (bind_data.dedup) {
+        result->dedup = make_uniq<ASTContentDedup>();
+    }
+    if (bind_data.screen.IsActive()) {
+        result->screen = make_uniq<ASTFileScreen>(bind_data.screen);
+    }
+    result->global_keys = bind_data.global_keys;
     
     try {
         // Use our reliable ASTFileUtils for pattern expansion and deduplication
@@ -181,6 +247,39 @@ static unique_ptr<GlobalTableFunctionState> ReadASTStreamingInit(ClientContext &
             supported_extensions = ASTFileUtils::GetSupportedExtensions(bind_data.language);
         }
         
+        // Patterns inside tar archives ("release.tar.gz/**/*.py", or any pattern with archive :=)
+        // are read from the archive by the parse workers
+        auto archives = make_uniq<ASTTarArchives>(context, supported_extensions, bind_data.discovery_options.shard);
+        idx_t archive_patterns = 0;
+        for (auto &pattern : bind_data.file_patterns) {
+            string archive = bind_data.archive;
+            string member_pattern = pattern;
+            if (!archive.empty() || ASTTarArchives::SplitPattern(context, pattern, archive, member_pattern)) {
+                archives->AddPattern(archive, member_pattern);
+                archive_patterns++;
+            }
+        }
+        if (archive_patterns > 0) {
+            if (archive_patterns < bind_data.file_patterns.size()) {
+                throw InvalidInputException("read_ast cannot mix patterns inside tar archives with other files");
+            }
+            result->archives = std::move(archives);
+            result->use_parallel_batching = true;
+            result->files_exhausted = false;
+            return std::move(result);
+        }
+        
+        auto &discovery_options = bind_data.discovery_options;
+        if (ASTFileDiscovery::NeedsWalk(context, bind_data.file_patterns) || !discovery_options.exclude.empty()) {
+            // Directories and globs are walked by the parse workers themselves (see ParseAllFilesParallel)
+            result->discovery = make_uniq<ASTFileDiscovery>(context, supported_extensions, bind_data.ignore_errors,
+                                                            discovery_options);
+            result->discovery->AddPatterns(bind_data.file_patterns);
+            result->use_parallel_batching = true;
+            result->files_exhausted = false;
+            return std::move(result);
+        }
+        
         auto expanded_files = ASTFileUtils::GetFiles(context, bind_data.file_patterns, 
                                                     bind_data.ignore_errors, supported_extensions);
         
@@ -192,6 +291,26 @@ static unique_ptr<GlobalTableFunctionState> ReadASTStreamingInit(ClientContext &
             return std::move(result);
         }
         
+        if (bind_data.global_keys) {
+            AssignFileIds(result->file_ids, expanded_files);
+        }
+        
+        // Keep this shard's files; an empty shard of a non-empty file list is not an error
+        auto &shard = bind_data.discovery_options.shard;
+        if (shard.IsActive()) {
+            vector<string> shard_files;
+            for (auto &file_path : expanded_files) {
+                if (shard.Contains(file_path)) {
+                    shard_files.push_back(std::move(file_path));
+                }
+            }
+            expanded_files = std::move(shard_files);
+            if (expanded_files.empty()) {
+                result->files_exhausted = true;
+                return std::move(result);
+            }
+        }
+        
         // ADAPTIVE PARALLEL PROCESSING based on file count
         const auto total_files = expanded_files.size();
         const auto num_threads = NumericCast<idx_t>(TaskScheduler::GetScheduler(context).NumberOfThreads());
@@ -202,37 +321,9 @@ static unique_ptr<GlobalTableFunctionState> ReadASTStreamingInit(ClientContext &
             result->use_parallel_batching = true;  // Reuse flag but no actual batching
             result->files_exhausted = false;
             
-            // Pre-resolve languages for all files to avoid repeated work
-            result->resolved_languages.reserve(result->all_file_paths.size());
-            std::unordered_set<string> unique_languages;
-            
-            for (const auto& file_path : result->all_file_paths) {
-                string file_language = bind_data.language;
-                if (bind_data.language == "auto" || bind_data.language.empty()) {
-                    file_language = ASTFileUtils::DetectLanguageFromPath(file_path);
-                    if (file_language == "auto") {
-                        if (!bind_data.ignore_errors) {
-                            throw BinderException("Could not detect language for file: " + file_path);
-                        }
-                        file_language = "unknown"; // Will be skipped during processing
-                    }
-                }
-                result->resolved_languages.push_back(file_language);
-                if (file_language != "unknown") {
-                    unique_languages.insert(file_language);
-                }
-            }
-            
-            // PRE-CREATE ALL NEEDED ADAPTERS (eliminates singleton contention)
-            auto& registry = LanguageAdapterRegistry::GetInstance();
-            for (const auto& language : unique_languages) {
-                auto adapter = registry.CreateAdapter(language);
-                if (adapter) {
-                    result->pre_created_adapters[language] = std::move(adapter);
-                } else if (!bind_data.ignore_errors) {
-                    throw InvalidInputException("Unsupported language: " + language);
-                }
-            }
+            // Pre-resolve languages and pre-create adapters (eliminates singleton contention)
+            ResolveFileLanguages(result->all_file_paths, bind_data.language, bind_data.ignore_errors,
+                                 result->resolved_languages, result->pre_created_adapters);
         } else {
             // Use traditional single-threaded streaming for small file sets
             result->use_parallel_batching = false;
@@ -327,7 +418,8 @@ static void ProcessBatchOfFiles(ClientContext &context, ReadASTStreamingGlobalSt
             // Use ParseSingleFileToASTResult for consistent error handling with sequential path
             auto result_ptr = UnifiedASTBackend::ParseSingleFileToASTResult(
                 context, file_path, file_language, global_state.ignore_errors,
-                global_state.peek_size, global_state.peek_mode
+                global_state.peek_size, global_state.peek_mode, global_state.line_ranges,
+                global_state.content_filter.get(), global_state.dedup.get(), global_state.screen.get()
             );
             
             if (result_ptr) {
@@ -386,8 +478,8 @@ static void ReadASTFlatStreamingFunctionSequential(ClientContext &context, ReadA
                 
                 auto& result = global_state.current_batch_results[global_state.current_batch_result_index];
                 
-                if (global_state.current_batch_row_index < result.nodes.size()) {
-                    auto& node = result.nodes[global_state.current_batch_row_index];
+                if (global_state.current_batch_row_index < result.Nodes().size()) {
+                    auto& node = result.Nodes()[global_state.current_batch_row_index];
                     
                     // Update node with source information from result
                     ASTNode updated_node = node;
@@ -423,7 +515,7 @@ static void ReadASTFlatStreamingFunctionSequential(ClientContext &context, ReadA
         // Check if we need to parse a new file
         if (!global_state.current_file_parsed || 
             !global_state.current_file_result ||
-            global_state.current_file_row_index >= global_state.current_file_result->nodes.size()) {
+            global_state.current_file_row_index >= global_state.current_file_result->Nodes().size()) {
             
             // Try to get next file that matches our language criteria
             OpenFileInfo file;
@@ -450,7 +542,8 @@ static void ReadASTFlatStreamingFunctionSequential(ClientContext &context, ReadA
             // Parse this single file
             global_state.current_file_result = UnifiedASTBackend::ParseSingleFileToASTResult(
                 context, file.path, global_state.language, global_state.ignore_errors, 
-                global_state.peek_size, global_state.peek_mode);
+                global_state.peek_size, global_state.peek_mode, global_state.line_ranges,
+                global_state.content_filter.get(), global_state.dedup.get(), global_state.screen.get());
             
             if (!global_state.current_file_result) {
                 // File was skipped due to errors, continue to next file
@@ -467,12 +560,12 @@ static void ReadASTFlatStreamingFunctionSequential(ClientContext &context, ReadA
             break;
         }
         
-        idx_t rows_available = global_state.current_file_result->nodes.size() - global_state.current_file_row_index;
+        idx_t rows_available = global_state.current_file_result->Nodes().size() - global_state.current_file_row_index;
         idx_t rows_to_emit = std::min(STANDARD_VECTOR_SIZE - output_count, rows_available);
         
         // Copy rows using hierarchical structure
         for (idx_t i = 0; i < rows_to_emit; i++) {
-            const auto& node = global_state.current_file_result->nodes[global_state.current_file_row_index + i];
+            const auto& node = global_state.current_file_result->Nodes()[global_state.current_file_row_index + i];
             idx_t output_idx = output_count + i;
             
             // Update node with source information from result
@@ -500,37 +593,50 @@ static void ReadASTFlatStreamingFunctionSequential(ClientContext &context, ReadA
     output.SetCardinality(output_count);
 }
 
+// Parse every file of a parallel scan. When the patterns need a directory walk,
+// walking and parsing run together so parsing starts with the first file found.
+static vector<ASTResult> ParseAllFilesParallel(ClientContext &context, ReadASTStreamingGlobalState &global_state) {
+    if (global_state.archives) {
+        auto results = ParseArchivesParallel(context, *global_state.archives, global_state.language,
+                                             global_state.ignore_errors, global_state.peek_size,
+                                             global_state.peek_mode, global_state.ordered, global_state.line_ranges,
+                                             global_state.content_filter.get(), global_state.dedup.get(),
+                                             global_state.screen.get());
+        if (global_state.archives->MemberCount() == 0 && !global_state.ignore_errors) {
+            throw IOException("read_ast needs at least one file to read");
+        }
+        if (global_state.global_keys) {
+            AssignFileIds(global_state.file_ids, global_state.archives->MemberPaths());
+        }
+        return results;
+    }
+    if (!global_state.discovery) {
+        return ParseFilesParallel(context, global_state.all_file_paths, global_state.resolved_languages,
+                                  global_state.ignore_errors, global_state.peek_size, global_state.peek_mode,
+                                  global_state.pre_created_adapters, false, global_state.line_ranges,
+                                  global_state.content_filter.get(), global_state.dedup.get(),
+                                  global_state.screen.get());
+    }
+    auto results = DiscoverAndParseFilesParallel(context, *global_state.discovery, global_state.language,
+                                                 global_state.ignore_errors, global_state.peek_size,
+                                                 global_state.peek_mode, global_state.ordered,
+                                                 global_state.line_ranges, global_state.content_filter.get(),
+                                                 global_state.dedup.get(), global_state.screen.get());
+    if (global_state.discovery->FileCount() == 0 && !global_state.ignore_errors) {
+        throw IOException("read_ast needs at least one file to read");
+    }
+    if (global_state.global_keys) {
+        AssignFileIds(global_state.file_ids, global_state.discovery->AllFiles());
+    }
+    return results;
+}
+
 // PARALLEL PROCESSING without batching - let DuckDB handle task distribution
 static void ReadASTFlatStreamingFunctionParallel(ClientContext &context, ReadASTStreamingGlobalState &global_state, DataChunk &output) {
     // Check if we need to do the one-time parallel processing
     if (!global_state.parallel_processing_complete) {
-        const auto num_threads = NumericCast<idx_t>(TaskScheduler::GetScheduler(context).NumberOfThreads());
-        const auto files_per_task = MaxValue<idx_t>((global_state.all_file_paths.size() + num_threads - 1) / num_threads, 1);
-        const auto num_tasks = (global_state.all_file_paths.size() + files_per_task - 1) / files_per_task;
-        
-        // Create parsing state for ALL files at once
-        ASTParsingState parsing_state(context, global_state.all_file_paths, global_state.resolved_languages, 
-                                    global_state.ignore_errors, global_state.peek_size, global_state.peek_mode,
-                                    global_state.pre_created_adapters, num_tasks);
-        
-        // Create tasks - let DuckDB's scheduler handle the distribution
-        TaskExecutor executor(context);
-        for (idx_t task_idx = 0; task_idx < num_tasks; task_idx++) {
-            const auto file_idx_start = task_idx * files_per_task;
-            const auto file_idx_end = MinValue<idx_t>(file_idx_start + files_per_task, global_state.all_file_paths.size());
-            
-            auto task = make_uniq<ASTParsingTask>(executor, parsing_state, file_idx_start, file_idx_end, task_idx);
-            executor.ScheduleTask(std::move(task));
-        }
-        
-        // Let DuckDB handle all the parallel work - no artificial batching!
-        executor.WorkOnTasks();
-        
-        // Collect all results
-        parsing_state.CollectResults();
-        
-        // Store all results for streaming
-        global_state.current_batch_results = std::move(parsing_state.results);
+        // Parse ALL files at once - let DuckDB's scheduler handle the distribution
+        global_state.current_batch_results = ParseAllFilesParallel(context, global_state);
         global_state.current_batch_result_index = 0;
         global_state.current_batch_row_index = 0;
         global_state.parallel_processing_complete = true;
@@ -549,19 +655,19 @@ static void ReadASTFlatStreamingFunctionParallel(ClientContext &context, ReadAST
         const auto& current_result = global_state.current_batch_results[global_state.current_batch_result_index];
         
         // Check if we've exhausted this result
-        if (global_state.current_batch_row_index >= current_result.nodes.size()) {
+        if (global_state.current_batch_row_index >= current_result.Nodes().size()) {
             global_state.current_batch_result_index++;
             global_state.current_batch_row_index = 0;
             continue;
         }
         
         // Calculate how many rows to emit from this result
-        const idx_t rows_available = current_result.nodes.size() - global_state.current_batch_row_index;
+        const idx_t rows_available = current_result.Nodes().size() - global_state.current_batch_row_index;
         const idx_t rows_to_emit = std::min(STANDARD_VECTOR_SIZE - output_count, rows_available);
         
         // Copy rows using hierarchical structure
         for (idx_t i = 0; i < rows_to_emit; i++) {
-            const auto& node = current_result.nodes[global_state.current_batch_row_index + i];
+            const auto& node = current_result.Nodes()[global_state.current_batch_row_index + i];
             const idx_t output_idx = output_count + i;
             
             // Update node with source information from result
@@ -749,17 +855,19 @@ static void ReadASTHierarchicalFunctionSequential(ClientContext &context, ReadAS
             if (global_state.current_batch_result_index < global_state.current_batch_results.size()) {
                 const auto& result = global_state.current_batch_results[global_state.current_batch_result_index];
                 
-                if (global_state.current_batch_row_index < result.nodes.size()) {
+                if (global_state.current_batch_row_index < result.Nodes().size()) {
                     // Use streaming projection for this batch result
                     idx_t old_output_index = output_index;
                     UnifiedASTBackend::ProjectToHierarchicalTableStreaming(
-                        result.nodes, output, global_state.current_batch_row_index, output_index, result.source);
+                        result.Nodes(), output, global_state.current_batch_row_index, output_index, result.source);
+                    ProjectGlobalKeys(global_state, result, global_state.current_batch_row_index, old_output_index,
+                                      output_index, output);
                     
                     // Update tracking based on how many rows were processed
                     idx_t rows_processed = output_index - old_output_index;
                     global_state.current_batch_row_index += rows_processed;
                     
-                    if (global_state.current_batch_row_index >= result.nodes.size()) {
+                    if (global_state.current_batch_row_index >= result.Nodes().size()) {
                         // Move to next result in batch
                         global_state.current_batch_result_index++;
                         global_state.current_batch_row_index = 0;
@@ -777,7 +885,7 @@ static void ReadASTHierarchicalFunctionSequential(ClientContext &context, ReadAS
             // Check if we need to parse a new file
             if (!global_state.current_file_parsed || 
                 !global_state.current_file_result ||
-                global_state.current_file_row_index >= global_state.current_file_result->nodes.size()) {
+                global_state.current_file_row_index >= global_state.current_file_result->Nodes().size()) {
                 
                 // Try to get next file
                 OpenFileInfo file;
@@ -799,7 +907,8 @@ static void ReadASTHierarchicalFunctionSequential(ClientContext &context, ReadAS
                 // Parse this single file
                 global_state.current_file_result = UnifiedASTBackend::ParseSingleFileToASTResult(
                     context, file.path, global_state.language, global_state.ignore_errors, 
-                    global_state.peek_size, global_state.peek_mode);
+                    global_state.peek_size, global_state.peek_mode, global_state.line_ranges,
+                    global_state.content_filter.get(), global_state.dedup.get(), global_state.screen.get());
                 
                 if (!global_state.current_file_result) {
                     // File was skipped due to errors, continue to next file
@@ -818,9 +927,11 @@ static void ReadASTHierarchicalFunctionSequential(ClientContext &context, ReadAS
             // Use streaming projection for current file
             idx_t old_output_index = output_index;
             UnifiedASTBackend::ProjectToHierarchicalTableStreaming(
-                global_state.current_file_result->nodes, output, 
+                global_state.current_file_result->Nodes(), output, 
                 global_state.current_file_row_index, output_index, 
                 global_state.current_file_result->source);
+            ProjectGlobalKeys(global_state, *global_state.current_file_result, global_state.current_file_row_index,
+                              old_output_index, output_index, output);
             
             // Update tracking based on how many rows were processed
             idx_t rows_processed = output_index - old_output_index;
@@ -834,33 +945,8 @@ static void ReadASTHierarchicalFunctionSequential(ClientContext &context, ReadAS
 static void ReadASTHierarchicalFunctionParallel(ClientContext &context, ReadASTStreamingGlobalState &global_state, DataChunk &output) {
     // Check if we need to do the one-time parallel processing
     if (!global_state.parallel_processing_complete) {
-        const auto num_threads = NumericCast<idx_t>(TaskScheduler::GetScheduler(context).NumberOfThreads());
-        const auto files_per_task = MaxValue<idx_t>((global_state.all_file_paths.size() + num_threads - 1) / num_threads, 1);
-        const auto num_tasks = (global_state.all_file_paths.size() + files_per_task - 1) / files_per_task;
-        
-        // Create parsing state for ALL files at once
-        ASTParsingState parsing_state(context, global_state.all_file_paths, global_state.resolved_languages, 
-                                    global_state.ignore_errors, global_state.peek_size, global_state.peek_mode,
-                                    global_state.pre_created_adapters, num_tasks);
-        
-        // Create tasks - let DuckDB's scheduler handle the distribution
-        TaskExecutor executor(context);
-        for (idx_t task_idx = 0; task_idx < num_tasks; task_idx++) {
-            const auto file_idx_start = task_idx * files_per_task;
-            const auto file_idx_end = MinValue<idx_t>(file_idx_start + files_per_task, global_state.all_file_paths.size());
-            
-            auto task = make_uniq<ASTParsingTask>(executor, parsing_state, file_idx_start, file_idx_end, task_idx);
-            executor.ScheduleTask(std::move(task));
-        }
-        
-        // Let DuckDB handle all the parallel work
-        executor.WorkOnTasks();
-        
-        // Collect all results
-        parsing_state.CollectResults();
-        
-        // Store all results for streaming
-        global_state.current_batch_results = std::move(parsing_state.results);
+        // Parse ALL files at once - let DuckDB's scheduler handle the distribution
+        global_state.current_batch_results = ParseAllFilesParallel(context, global_state);
         global_state.current_batch_result_index = 0;
         global_state.current_batch_row_index = 0;
         global_state.parallel_processing_complete = true;
@@ -875,7 +961,7 @@ static void ReadASTHierarchicalFunctionParallel(ClientContext &context, ReadASTS
         
         const auto& current_result = global_state.current_batch_results[global_state.current_batch_result_index];
         
-        if (global_state.current_batch_row_index >= current_result.nodes.size()) {
+        if (global_state.current_batch_row_index >= current_result.Nodes().size()) {
             global_state.current_batch_result_index++;
             global_state.current_batch_row_index = 0;
             continue;
@@ -884,13 +970,15 @@ static void ReadASTHierarchicalFunctionParallel(ClientContext &context, ReadASTS
         // Use streaming projection for this result
         idx_t old_output_index = output_index;
         UnifiedASTBackend::ProjectToHierarchicalTableStreaming(
-            current_result.nodes, output, global_state.current_batch_row_index, output_index, current_result.source);
+            current_result.Nodes(), output, global_state.current_batch_row_index, output_index, current_result.source);
+        ProjectGlobalKeys(global_state, current_result, global_state.current_batch_row_index, old_output_index,
+                          output_index, output);
         
         // Update tracking based on how many rows were processed
         idx_t rows_processed = output_index - old_output_index;
         global_state.current_batch_row_index += rows_processed;
         
-        if (global_state.current_batch_row_index >= current_result.nodes.size()) {
+        if (global_state.current_batch_row_index >= current_result.Nodes().size()) {
             global_state.current_batch_result_index++;
             global_state.current_batch_row_index = 0;
         }
@@ -973,6 +1061,86 @@ static TableFunction GetReadASTStreamingFunctionOneArg() {
     return read_ast_streaming;
 }
 
+// line_ranges := [[start_line, end_line], ...]: 1-based inclusive line ranges that
+// restrict extraction to the overlapping nodes and their ancestors (e.g. diff hunks)
+static vector<pair<uint32_t, uint32_t>> ParseLineRangesParameter(const Value &value) {
+    vector<pair<uint32_t, uint32_t>> line_ranges;
+    if (value.IsNull()) {
+        return line_ranges;
+    }
+    for (auto &range : ListValue::GetChildren(value)) {
+        if (range.IsNull() || ListValue::GetChildren(range).size() != 2) {
+            throw BinderException("line_ranges entries must be [start_line, end_line] pairs");
+        }
+        auto &bounds = ListValue::GetChildren(range);
+        if (bounds[0].IsNull() || bounds[1].IsNull()) {
+            throw BinderException("line_ranges bounds cannot be NULL");
+        }
+        auto start_line = bounds[0].GetValue<int64_t>();
+        auto end_line = bounds[1].GetValue<int64_t>();
+        if (start_line < 1 || end_line < start_line || end_line > NumericLimits<uint32_t>::Maximum()) {
+            throw BinderException("line_ranges entries need 1 <= start_line <= end_line, got [" +
+                                  std::to_string(start_line) + ", " + std::to_string(end_line) + "]");
+        }
+        line_ranges.emplace_back(NumericCast<uint32_t>(start_line), NumericCast<uint32_t>(end_line));
+    }
+    return line_ranges;
+}
+
+// global_keys := true appends integer keys that are unique across files
+static void AddGlobalKeyColumns(vector<LogicalType> &return_types, vector<string> &names) {
+    names.push_back("file_id");
+    names.push_back("node_key");
+    names.push_back("parent_key");
+    return_types.push_back(LogicalType::INTEGER);
+    return_types.push_back(LogicalType::BIGINT);
+    return_types.push_back(LogicalType::BIGINT);
+}
+
+// shard_count / shard_index; a shard index needs a count
+static ASTFileShard ParseShardParameters(const named_parameter_map_t &named_parameters) {
+    ASTFileShard shard;
+    auto count_entry = named_parameters.find("shard_count");
+    auto index_entry = named_parameters.find("shard_index");
+    if (count_entry == named_parameters.end() || count_entry->second.IsNull()) {
+        if (index_entry != named_parameters.end() && !index_entry->second.IsNull()) {
+            throw BinderException("shard_index requires shard_count");
+        }
+        return shard;
+    }
+    auto count = count_entry->second.GetValue<int64_t>();
+    if (count < 1) {
+        throw BinderException("shard_count must be positive");
+    }
+    int64_t index = 0;
+    if (index_entry != named_parameters.end() && !index_entry->second.IsNull()) {
+        index = index_entry->second.GetValue<int64_t>();
+    } else if (count > 1) {
+        throw BinderException("shard_count requires shard_index");
+    }
+    if (index < 0 || index >= count) {
+        throw BinderException("shard_index must be between 0 and shard_count - 1");
+    }
+    shard.count = NumericCast<idx_t>(count);
+    shard.index = NumericCast<idx_t>(index);
+    return shard;
+}
+
+// exclude := ['node_modules', 'dist', '*.min.js']: globs pruned during the walk
+static vector<string> ParseExcludeParameter(const Value &value) {
+    vector<string> exclude;
+    if (value.IsNull()) {
+        return exclude;
+    }
+    for (auto &pattern : ListValue::GetChildren(value)) {
+        if (pattern.IsNull()) {
+            throw BinderException("exclude patterns cannot be NULL");
+        }
+        exclude.push_back(StringValue::Get(pattern));
+    }
+    return exclude;
+}
+
 // Hierarchical streaming bind function for two-argument version (explicit language)
 static unique_ptr<FunctionData> ReadASTHierarchicalStreamingBindTwoArg(ClientContext &context, TableFunctionBindInput &input,
                                                                        vector<LogicalType> &return_types, vector<string> &names) {
@@ -1040,7 +1208,45 @@ static unique_ptr<FunctionData> ReadASTHierarchicalStreamingBindTwoArg(ClientCon
     names = UnifiedASTBackend::GetHierarchicalTableColumnNames();
     
     // Use the new vector<string> constructor for consistent handling
-    return make_uniq<ReadASTStreamingBindData>(file_patterns, language, ignore_errors, peek_size, peek_mode, batch_size);
+    auto bind_data = make_uniq<ReadASTStreamingBindData>(file_patterns, language, ignore_errors, peek_size, peek_mode,
+                                                         batch_size);
+    if (seen_parameters.find("line_ranges") != seen_parameters.end()) {
+        bind_data->line_ranges = ParseLineRangesParameter(input.named_parameters.at("line_ranges"));
+    }
+    if (seen_parameters.find("ordered") != seen_parameters.end()) {
+        bind_data->ordered = input.named_parameters.at("ordered").GetValue<bool>();
+    }
+    if (seen_parameters.find("exclude") != seen_parameters.end()) {
+        bind_data->discovery_options.exclude = ParseExcludeParameter(input.named_parameters.at("exclude"));
+    }
+    if (seen_parameters.find("respect_gitignore") != seen_parameters.end()) {
+        bind_data->discovery_options.respect_gitignore = input.named_parameters.at("respect_gitignore").GetValue<bool>();
+    }
+    bind_data->discovery_options.shard = ParseShardParameters(input.named_parameters);
+    if (seen_parameters.find("content_filter") != seen_parameters.end()) {
+        bind_data->content_filter = input.named_parameters.at("content_filter").GetValue<string>();
+    }
+    if (seen_parameters.find("content_filter_mode") != seen_parameters.end()) {
+        bind_data->content_filter_mode = input.named_parameters.at("content_filter_mode").GetValue<string>();
+    }
+    // Validate the mode and the regex at bind time
+    ASTContentFilter::Create(bind_data->content_filter, bind_data->content_filter_mode);
+    if (seen_parameters.find("dedup") != seen_parameters.end()) {
+        bind_data->dedup = input.named_parameters.at("dedup").GetValue<bool>();
+    }
+    for (auto &param : input.named_parameters) {
+        bind_data->screen.SetOption(param.first, param.second);
+    }
+    if (seen_parameters.find("archive") != seen_parameters.end()) {
+        bind_data->archive = input.named_parameters.at("archive").GetValue<string>();
+    }
+    if (seen_parameters.find("global_keys") != seen_parameters.end()) {
+        bind_data->global_keys = input.named_parameters.at("global_keys").GetValue<bool>();
+    }
+    if (bind_data->global_keys) {
+        AddGlobalKeyColumns(return_types, names);
+    }
+    return std::move(bind_data);
 }
 
 // Hierarchical streaming bind function for one-argument version (auto-detect language)
@@ -1112,7 +1318,45 @@ static unique_ptr<FunctionData> ReadASTHierarchicalStreamingBindOneArg(ClientCon
     names = UnifiedASTBackend::GetHierarchicalTableColumnNames();
     
     // Use the new vector<string> constructor for consistent handling
-    return make_uniq<ReadASTStreamingBindData>(file_patterns, language, ignore_errors, peek_size, peek_mode, batch_size);
+    auto bind_data = make_uniq<ReadASTStreamingBindData>(file_patterns, language, ignore_errors, peek_size, peek_mode,
+                                                         batch_size);
+    if (seen_parameters.find("line_ranges") != seen_parameters.end()) {
+        bind_data->line_ranges = ParseLineRangesParameter(input.named_parameters.at("line_ranges"));
+    }
+    if (seen_parameters.find("ordered") != seen_parameters.end()) {
+        bind_data->ordered = input.named_parameters.at("ordered").GetValue<bool>();
+    }
+    if (seen_parameters.find("exclude") != seen_parameters.end()) {
+        bind_data->discovery_options.exclude = ParseExcludeParameter(input.named_parameters.at("exclude"));
+    }
+    if (seen_parameters.find("respect_gitignore") != seen_parameters.end()) {
+        bind_data->discovery_options.respect_gitignore = input.named_parameters.at("respect_gitignore").GetValue<bool>();
+    }
+    bind_data->discovery_options.shard = ParseShardParameters(input.named_parameters);
+    if (seen_parameters.find("content_filter") != seen_parameters.end()) {
+        bind_data->content_filter = input.named_parameters.at("content_filter").GetValue<string>();
+    }
+    if (seen_parameters.find("content_filter_mode") != seen_parameters.end()) {
+        bind_data->content_filter_mode = input.named_parameters.at("content_filter_mode").GetValue<string>();
+    }
+    // Validate the mode and the regex at bind time
+    ASTContentFilter::Create(bind_data->content_filter, bind_data->content_filter_mode);
+    if (seen_parameters.find("dedup") != seen_parameters.end()) {
+        bind_data->dedup = input.named_parameters.at("dedup").GetValue<bool>();
+    }
+    for (auto &param : input.named_parameters) {
+        bind_data->screen.SetOption(param.first, param.second);
+    }
+    if (seen_parameters.find("archive") != seen_parameters.end()) {
+        bind_data->archive = input.named_parameters.at("archive").GetValue<string>();
+    }
+    if (seen_parameters.find("global_keys") != seen_parameters.end()) {
+        bind_data->global_keys = input.named_parameters.at("global_keys").GetValue<bool>();
+    }
+    if (bind_data->global_keys) {
+        AddGlobalKeyColumns(return_types, names);
+    }
+    return std::move(bind_data);
 }
 
 // Functions for read_ast (using hierarchical STRUCT schema)
@@ -1124,6 +1368,20 @@ static TableFunction GetReadASTFunctionTwoArg() {
     read_ast.named_parameters["peek_size"] = LogicalType::INTEGER;
     read_ast.named_parameters["peek_mode"] = LogicalType::VARCHAR;
     read_ast.named_parameters["batch_size"] = LogicalType::INTEGER;
+    read_ast.named_parameters["line_ranges"] = LogicalType::LIST(LogicalType::LIST(LogicalType::BIGINT));
+    read_ast.named_parameters["ordered"] = LogicalType::BOOLEAN;
+    read_ast.named_parameters["exclude"] = LogicalType::LIST(LogicalType::VARCHAR);
+    read_ast.named_parameters["respect_gitignore"] = LogicalType::BOOLEAN;
+    read_ast.named_parameters["content_filter"] = LogicalType::VARCHAR;
+    read_ast.named_parameters["content_filter_mode"] = LogicalType::VARCHAR;
+    read_ast.named_parameters["dedup"] = LogicalType::BOOLEAN;
+    read_ast.named_parameters["skip_generated"] = LogicalType::BOOLEAN;
+    read_ast.named_parameters["max_file_size"] = LogicalType::BIGINT;
+    read_ast.named_parameters["max_nodes"] = LogicalType::BIGINT;
+    read_ast.named_parameters["archive"] = LogicalType::VARCHAR;
+    read_ast.named_parameters["shard_count"] = LogicalType::BIGINT;
+    read_ast.named_parameters["shard_index"] = LogicalType::BIGINT;
+    read_ast.named_parameters["global_keys"] = LogicalType::BOOLEAN;
     return read_ast;
 }
 
@@ -1136,6 +1394,20 @@ static TableFunction GetReadASTHierarchicalFunctionTwoArg() {
     read_ast_hierarchical.named_parameters["peek_size"] = LogicalType::INTEGER;
     read_ast_hierarchical.named_parameters["peek_mode"] = LogicalType::VARCHAR;
     read_ast_hierarchical.named_parameters["batch_size"] = LogicalType::INTEGER;
+    read_ast_hierarchical.named_parameters["line_ranges"] = LogicalType::LIST(LogicalType::LIST(LogicalType::BIGINT));
+    read_ast_hierarchical.named_parameters["ordered"] = LogicalType::BOOLEAN;
+    read_ast_hierarchical.named_parameters["exclude"] = LogicalType::LIST(LogicalType::VARCHAR);
+    read_ast_hierarchical.named_parameters["respect_gitignore"] = LogicalType::BOOLEAN;
+    read_ast_hierarchical.named_parameters["content_filter"] = LogicalType::VARCHAR;
+    read_ast_hierarchical.named_parameters["content_filter_mode"] = LogicalType::VARCHAR;
+    read_ast_hierarchical.named_parameters["dedup"] = LogicalType::BOOLEAN;
+    read_ast_hierarchical.named_parameters["skip_generated"] = LogicalType::BOOLEAN;
+    read_ast_hierarchical.named_parameters["max_file_size"] = LogicalType::BIGINT;
+    read_ast_hierarchical.named_parameters["max_nodes"] = LogicalType::BIGINT;
+    read_ast_hierarchical.named_parameters["archive"] = LogicalType::VARCHAR;
+    read_ast_hierarchical.named_parameters["shard_count"] = LogicalType::BIGINT;
+    read_ast_hierarchical.named_parameters["shard_index"] = LogicalType::BIGINT;
+    read_ast_hierarchical.named_parameters["global_keys"] = LogicalType::BOOLEAN;
     return read_ast_hierarchical;
 }
 
@@ -1147,6 +1419,20 @@ static TableFunction GetReadASTFunctionOneArg() {
     read_ast.named_parameters["peek_size"] = LogicalType::INTEGER;
     read_ast.named_parameters["peek_mode"] = LogicalType::VARCHAR;
     read_ast.named_parameters["batch_size"] = LogicalType::INTEGER;
+    read_ast.named_parameters["line_ranges"] = LogicalType::LIST(LogicalType::LIST(LogicalType::BIGINT));
+    read_ast.named_parameters["ordered"] = LogicalType::BOOLEAN;
+    read_ast.named_parameters["exclude"] = LogicalType::LIST(LogicalType::VARCHAR);
+    read_ast.named_parameters["respect_gitignore"] = LogicalType::BOOLEAN;
+    read_ast.named_parameters["content_filter"] = LogicalType::VARCHAR;
+    read_ast.named_parameters["content_filter_mode"] = LogicalType::VARCHAR;
+    read_ast.named_parameters["dedup"] = LogicalType::BOOLEAN;
+    read_ast.named_parameters["skip_generated"] = LogicalType::BOOLEAN;
+    read_ast.named_parameters["max_file_size"] = LogicalType::BIGINT;
+    read_ast.named_parameters["max_nodes"] = LogicalType::BIGINT;
+    read_ast.named_parameters["archive"] = LogicalType::VARCHAR;
+    read_ast.named_parameters["shard_count"] = LogicalType::BIGINT;
+    read_ast.named_parameters["shard_index"] = LogicalType::BIGINT;
+    read_ast.named_parameters["global_keys"] = LogicalType::BOOLEAN;
     return read_ast;
 }
 
@@ -1158,9 +1444,278 @@ static TableFunction GetReadASTHierarchicalFunctionOneArg() {
     read_ast_hierarchical.named_parameters["peek_size"] = LogicalType::INTEGER;
     read_ast_hierarchical.named_parameters["peek_mode"] = LogicalType::VARCHAR;
     read_ast_hierarchical.named_parameters["batch_size"] = LogicalType::INTEGER;
+    read_ast_hierarchical.named_parameters["line_ranges"] = LogicalType::LIST(LogicalType::LIST(LogicalType::BIGINT));
+    read_ast_hierarchical.named_parameters["ordered"] = LogicalType::BOOLEAN;
+    read_ast_hierarchical.named_parameters["exclude"] = LogicalType::LIST(LogicalType::VARCHAR);
+    read_ast_hierarchical.named_parameters["respect_gitignore"] = LogicalType::BOOLEAN;
+    read_ast_hierarchical.named_parameters["content_filter"] = LogicalType::VARCHAR;
+    read_ast_hierarchical.named_parameters["content_filter_mode"] = LogicalType::VARCHAR;
+    read_ast_hierarchical.named_parameters["dedup"] = LogicalType::BOOLEAN;
+    read_ast_hierarchical.named_parameters["skip_generated"] = LogicalType::BOOLEAN;
+    read_ast_hierarchical.named_parameters["max_file_size"] = LogicalType::BIGINT;
+    read_ast_hierarchical.named_parameters["max_nodes"] = LogicalType::BIGINT;
+    read_ast_hierarchical.named_parameters["archive"] = LogicalType::VARCHAR;
+    read_ast_hierarchical.named_parameters["shard_count"] = LogicalType::BIGINT;
+    read_ast_hierarchical.named_parameters["shard_index"] = LogicalType::BIGINT;
+    read_ast_hierarchical.named_parameters["global_keys"] = LogicalType::BOOLEAN;
     return read_ast_hierarchical;
 }
 
+//==============================================================================
+// read_ast_files(file_patterns, [language]) -> one row per file
+//==============================================================================
+//
+// The files dimension of read_ast(..., global_keys := true): the same file
+// list, with the same file_id, plus each file's language, size and content
+// hash. Node rows can then carry integer keys only, and each path is stored
+// once per file instead of once per node.
+//
+// Files on disk are listed at bind time; their size comes from the file handle,
+// and a file is only read when content_hash is projected. Archive members can
+// only be found by reading the archive, so the scan lists them, measuring each
+// member while it has the content at hand.
+
+struct ReadASTFilesEntry {
+    int32_t file_id;
+    string file_path;
+    int64_t size = 0;         // Archive members only
+    uint64_t content_hash = 0;
+};
+
+struct ReadASTFilesBindData : public TableFunctionData {
+    vector<ReadASTFilesEntry> files; // This shard's files on disk, by file_id
+    string language;
+    bool ignore_errors = false;
+    // Patterns inside tar archives, as (archive, member pattern)
+    vector<pair<string, string>> archive_patterns;
+    vector<string> supported_extensions;
+    ASTFileShard shard;
+};
+
+struct ReadASTFilesGlobalState : public GlobalTableFunctionState {
+    ReadASTFilesGlobalState(idx_t file_count, vector<column_t> column_ids_p)
+        : next_file(0), max_threads(MaxValue<idx_t>(file_count, 1)), column_ids(std::move(column_ids_p)) {
+    }
+
+    idx_t MaxThreads() const override {
+        return max_threads;
+    }
+
+    atomic<idx_t> next_file;
+    const idx_t max_threads;
+    const vector<column_t> column_ids;
+    bool content_hash = false; // Whether content_hash is projected
+
+    // Archive patterns: this shard's members, listed by the (single) scan thread
+    unique_ptr<ASTTarArchives> archives;
+    bool archives_listed = false;
+    vector<ReadASTFilesEntry> members;
+};
+
+static vector<string> ParseFilePatterns(const Value &value) {
+    vector<string> file_patterns;
+    if (value.IsNull()) {
+        throw BinderException("read_ast_files: file patterns cannot be NULL");
+    }
+    if (value.type().id() == LogicalTypeId::LIST) {
+        for (auto &pattern : ListValue::GetChildren(value)) {
+            if (pattern.IsNull()) {
+                throw BinderException("File pattern list cannot contain NULL values");
+            }
+            file_patterns.push_back(pattern.ToString());
+        }
+        if (file_patterns.empty()) {
+            throw BinderException("File pattern list cannot be empty");
+        }
+    } else if (value.type().id() == LogicalTypeId::VARCHAR) {
+        file_patterns.push_back(value.ToString());
+    } else {
+        throw BinderException("File patterns must be VARCHAR or LIST(VARCHAR)");
+    }
+    return file_patterns;
+}
+
+static unique_ptr<FunctionData> ReadASTFilesBind(ClientContext &context, TableFunctionBindInput &input,
+                                                 vector<LogicalType> &return_types, vector<string> &names) {
+    auto result = make_uniq<ReadASTFilesBindData>();
+    auto file_patterns = ParseFilePatterns(input.inputs[0]);
+    result->language = "auto";
+    if (input.inputs.size() > 1) {
+        if (input.inputs[1].IsNull()) {
+            throw BinderException("read_ast_files: language cannot be NULL");
+        }
+        result->language = input.inputs[1].GetValue<string>();
+    }
+    ASTDiscoveryOptions discovery_options;
+    string archive;
+    for (auto &kv : input.named_parameters) {
+        if (kv.first == "ignore_errors") {
+            result->ignore_errors = BooleanValue::Get(kv.second);
+        } else if (kv.first == "exclude") {
+            discovery_options.exclude = ParseExcludeParameter(kv.second);
+        } else if (kv.first == "respect_gitignore") {
+            discovery_options.respect_gitignore = BooleanValue::Get(kv.second);
+        } else if (kv.first == "archive") {
+            archive = StringValue::Get(kv.second);
+        }
+    }
+    result->shard = ParseShardParameters(input.named_parameters);
+    if (result->language != "auto") {
+        result->supported_extensions = ASTFileUtils::GetSupportedExtensions(result->language);
+    }
+
+    names = {"file_id", "file_path", "language", "size", "content_hash"};
+    return_types = {LogicalType::INTEGER, LogicalType::VARCHAR, LogicalType::VARCHAR, LogicalType::BIGINT,
+                    LogicalType::UBIGINT};
+
+    for (auto &pattern : file_patterns) {
+        string archive_path = archive;
+        string member_pattern = pattern;
+        if (!archive_path.empty() || ASTTarArchives::SplitPattern(context, pattern, archive_path, member_pattern)) {
+            result->archive_patterns.emplace_back(archive_path, member_pattern);
+        }
+    }
+    if (!result->archive_patterns.empty()) {
+        if (result->archive_patterns.size() < file_patterns.size()) {
+            throw InvalidInputException("read_ast_files cannot mix patterns inside tar archives with other files");
+        }
+        return std::move(result);
+    }
+
+    // Every file the patterns match, in any shard, exactly as read_ast lists them
+    vector<string> file_paths;
+    if (ASTFileDiscovery::NeedsWalk(context, file_patterns) || !discovery_options.exclude.empty()) {
+        ASTFileDiscovery discovery(context, result->supported_extensions, result->ignore_errors, discovery_options);
+        discovery.AddPatterns(file_patterns);
+        file_paths = discovery.DiscoverAll();
+    } else {
+        file_paths = ASTFileUtils::GetFiles(context, file_patterns, result->ignore_errors,
+                                            result->supported_extensions);
+    }
+    if (file_paths.empty() && !result->ignore_errors) {
+        throw IOException("read_ast_files needs at least one file to read");
+    }
+
+    // file_id is the path hash, as in read_ast(..., global_keys := true)
+    unordered_map<string, int32_t> file_ids;
+    AssignFileIds(file_ids, file_paths);
+    for (auto &entry : file_ids) {
+        if (result->shard.Contains(entry.first)) {
+            ReadASTFilesEntry file;
+            file.file_id = entry.second;
+            file.file_path = entry.first;
+            result->files.push_back(std::move(file));
+        }
+    }
+    std::sort(result->files.begin(), result->files.end(),
+              [](const ReadASTFilesEntry &a, const ReadASTFilesEntry &b) { return a.file_path < b.file_path; });
+    return std::move(result);
+}
+
+static unique_ptr<GlobalTableFunctionState> ReadASTFilesInitGlobal(ClientContext &context,
+                                                                   TableFunctionInitInput &input) {
+    auto &bind_data = input.bind_data->Cast<ReadASTFilesBindData>();
+    auto archives = !bind_data.archive_patterns.empty();
+    auto result = make_uniq<ReadASTFilesGlobalState>(archives ? 1 : bind_data.files.size(), input.column_ids);
+    for (auto column_id : input.column_ids) {
+        result->content_hash |= column_id == 4;
+    }
+    if (archives) {
+        result->archives = make_uniq<ASTTarArchives>(context, bind_data.supported_extensions, bind_data.shard);
+        for (auto &pattern : bind_data.archive_patterns) {
+            result->archives->AddPattern(pattern.first, pattern.second);
+        }
+    }
+    return std::move(result);
+}
+
+// Read this shard's archive members, then number them by the paths of every
+// member the patterns match, in any shard
+static void ListArchiveMembers(const ReadASTFilesBindData &bind_data, ReadASTFilesGlobalState &global_state) {
+    ReadASTFilesEntry entry;
+    string content;
+    while (global_state.archives->Next(entry.file_path, content)) {
+        entry.size = NumericCast<int64_t>(content.size());
+        entry.content_hash = Hash(content.c_str(), content.size());
+        global_state.members.push_back(entry);
+    }
+    if (global_state.archives->MemberCount() == 0 && !bind_data.ignore_errors) {
+        throw IOException("read_ast_files needs at least one file to read");
+    }
+    unordered_map<string, int32_t> file_ids;
+    AssignFileIds(file_ids, global_state.archives->MemberPaths());
+    for (auto &member : global_state.members) {
+        member.file_id = file_ids[member.file_path];
+    }
+    global_state.archives_listed = true;
+}
+
+static void ReadASTFilesFunction(ClientContext &context, TableFunctionInput &data_p, DataChunk &output) {
+    auto &bind_data = data_p.bind_data->Cast<ReadASTFilesBindData>();
+    auto &global_state = data_p.global_state->Cast<ReadASTFilesGlobalState>();
+    auto &fs = FileSystem::GetFileSystem(context);
+
+    if (global_state.archives && !global_state.archives_listed) {
+        ListArchiveMembers(bind_data, global_state);
+    }
+    auto &files = global_state.archives ? global_state.members : bind_data.files;
+
+    idx_t count = 0;
+    while (count < STANDARD_VECTOR_SIZE) {
+        auto file_idx = global_state.next_file.fetch_add(1);
+        if (file_idx >= files.size()) {
+            break;
+        }
+        auto &entry = files[file_idx];
+        auto language = bind_data.language != "auto" ? bind_data.language
+                                                     : ASTFileUtils::DetectLanguageFromPath(entry.file_path);
+        Value size;
+        Value content_hash;
+        if (global_state.archives) {
+            size = Value::BIGINT(entry.size);
+            content_hash = Value::UBIGINT(entry.content_hash);
+        } else {
+            try {
+                auto handle = fs.OpenFile(entry.file_path, FileFlags::FILE_FLAGS_READ);
+                auto file_size = fs.GetFileSize(*handle);
+                size = Value::BIGINT(NumericCast<int64_t>(file_size));
+                if (global_state.content_hash) {
+                    auto content = ASTFileUtils::ReadFileContent(fs, *handle, file_size);
+                    content_hash = Value::UBIGINT(Hash(content.c_str(), content.size()));
+                }
+            } catch (const Exception &e) {
+                if (!bind_data.ignore_errors) {
+                    throw;
+                }
+                size = Value();
+            }
+        }
+
+        // Projected columns only (projection pushdown)
+        const Value row[] = {Value::INTEGER(entry.file_id), Value(entry.file_path),
+                             language == "auto" ? Value() : Value(language), size, content_hash};
+        for (idx_t col = 0; col < global_state.column_ids.size(); col++) {
+            auto column_id = global_state.column_ids[col];
+            output.SetValue(col, count, column_id < 5 ? row[column_id] : Value());
+        }
+        count++;
+    }
+    output.SetCardinality(count);
+}
+
+static TableFunction GetReadASTFilesFunction(const vector<LogicalType> &arguments) {
+    TableFunction read_ast_files("read_ast_files", arguments, ReadASTFilesFunction, ReadASTFilesBind,
+                                 ReadASTFilesInitGlobal);
+    read_ast_files.projection_pushdown = true;
+    read_ast_files.named_parameters["ignore_errors"] = LogicalType::BOOLEAN;
+    read_ast_files.named_parameters["exclude"] = LogicalType::LIST(LogicalType::VARCHAR);
+    read_ast_files.named_parameters["respect_gitignore"] = LogicalType::BOOLEAN;
+    read_ast_files.named_parameters["archive"] = LogicalType::VARCHAR;
+    read_ast_files.named_parameters["shard_count"] = LogicalType::BIGINT;
+    read_ast_files.named_parameters["shard_index"] = LogicalType::BIGINT;
+    return read_ast_files;
+}
+
 void RegisterReadASTFunction(DatabaseInstance &instance) {
     // Register flat schema functions (explicit legacy access)
     ExtensionUtil::RegisterFunction(instance, GetReadASTFlatFunctionOneArg());    // ANY (auto-detect)
@@ -1173,6 +1728,12 @@ void RegisterReadASTFunction(DatabaseInstance &instance) {
     // Register hierarchical functions for explicit access with STRUCT schema
     ExtensionUtil::RegisterFunction(instance, GetReadASTHierarchicalFunctionOneArg());    // ANY (auto-detect)
     ExtensionUtil::RegisterFunction(instance, GetReadASTHierarchicalFunctionTwoArg());    // ANY, VARCHAR (explicit language)
+    
+    // Register the files dimension of read_ast(..., global_keys := true)
+    TableFunctionSet read_ast_files("read_ast_files");
+    read_ast_files.AddFunction(GetReadASTFilesFunction({LogicalType::ANY}));                       // Auto-detect
+    read_ast_files.AddFunction(GetReadASTFilesFunction({LogicalType::ANY, LogicalType::VARCHAR})); // Explicit language
+    ExtensionUtil::RegisterFunction(instance, read_ast_files);
 }
 
 void RegisterReadASTStreamingFunction(DatabaseInstance &instance) {
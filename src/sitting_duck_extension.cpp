@@ -10,6 +10,15 @@
 // #include "short_names_function.hpp" // Removed
 #include "parse_ast_function.hpp"
 #include "semantic_type_functions.hpp"
+#include "ast_parse_cache.hpp"
+#include "ast_blob_functions.hpp"
+#include "ast_tree_navigation_functions.hpp"
+#include "ast_clone_functions.hpp"
+#include "ast_similarity_functions.hpp"
+#include "ast_symbol_functions.hpp"
+#include "ast_source_functions.hpp"
+#include "ast_node_at_functions.hpp"
+#include "ast_type.hpp"
 
 namespace duckdb {
 
@@ -20,6 +29,12 @@ void RegisterReadASTFunction(DatabaseInstance &instance);           // Streaming
 void RegisterASTSQLMacros(DatabaseInstance &instance);
 // void RegisterDuckDBASTShortNamesFunction(DatabaseInstance &instance); // Removed
 void RegisterASTSupportedLanguagesFunction(DatabaseInstance &instance);
+void RegisterASTIndexSyncFunction(DatabaseInstance &instance);
+void RegisterReadASTObjectsFunction(DatabaseInstance &instance);
+void RegisterASTQueryFunction(DatabaseInstance &instance);
+void RegisterReadASTCallsFunction(DatabaseInstance &instance);
+void RegisterReadASTMetricsFunction(DatabaseInstance &instance);
+void RegisterReadASTGitFunction(DatabaseInstance &instance);
 // Temporarily disabled:
 // void RegisterASTObjectsFunction(DatabaseInstance &instance);
 // void RegisterASTHelperFunctions(DatabaseInstance &instance);
@@ -32,6 +47,18 @@ static void LoadInternal(DatabaseInstance &instance) {
 	
 	// RegisterReadASTObjectsHybridFunction(instance); // Removed - unused by CLI/queries
 	
+	// Register the per-file read_ast_objects table function (one row, one node list per file)
+	RegisterReadASTObjectsFunction(instance);
+	
+	// Register native call edge extraction (read_ast_calls)
+	RegisterReadASTCallsFunction(instance);
+	
+	// Register single-pass complexity metrics (read_ast_metrics)
+	RegisterReadASTMetricsFunction(instance);
+
+	// Register parsing straight from a git object store (read_ast_git)
+	RegisterReadASTGitFunction(instance);
+	
 	// Register the parse_ast scalar function
 	ParseASTFunction::Register(instance);
 	
@@ -46,6 +73,37 @@ static void LoadInternal(DatabaseInstance &instance) {
 	// Register supported languages function
 	RegisterASTSupportedLanguagesFunction(instance);
 	
+	// Register the shared parse cache settings and sitting_duck_cache_stats()
+	ASTParseCache::Register(instance);
+	
+	// Register incremental index maintenance (ast_index_sync)
+	RegisterASTIndexSyncFunction(instance);
+	
+	// Register the AST type and its native accessor functions
+	RegisterASTType(instance);
+	RegisterASTBlobFunctions(instance);
+	
+	// Register native tree navigation over read_ast_objects node lists
+	RegisterASTTreeNavigationFunctions(instance);
+	
+	// Register tree-sitter pattern queries (ast_query)
+	RegisterASTQueryFunction(instance);
+	
+	// Register Merkle subtree hashes and clone detection
+	RegisterASTCloneFunctions(instance);
+	
+	// Register MinHash/LSH near-duplicate function detection
+	RegisterASTSimilarityFunctions(instance);
+	
+	// Register the cross-file symbol and reference index
+	RegisterASTSymbolFunctions(instance);
+	
+	// Register byte-range source extraction (ast_get_source)
+	RegisterASTSourceFunctions(instance);
+	
+	// Register position lookups (ast_node_at)
+	RegisterASTNodeAtFunctions(instance);
+	
 	// Short names system removed for simplicity
 	
 	// TODO: Re-enable once we fix the issues
@@ -88,6 +88,7 @@ CREATE OR REPLACE TEMPORARY MACRO ast_to_depth_stats(ast) AS (
 );
 
 -- Complexity metrics
+-- read_ast_metrics(file_patterns) computes cyclomatic, nesting and Halstead metrics natively in one pass per file
 CREATE OR REPLACE TEMPORARY MACRO ast_to_complexity_metrics(ast) AS (
     [
         struct_pack(
@@ -137,6 +138,7 @@ CREATE OR REPLACE TEMPORARY MACRO ast_to_dependencies(ast) AS (
 );
 
 -- Call graph edges (caller -> callee relationships)
+-- read_ast_calls(file_patterns) extracts the same edges natively in one pass per file
 CREATE OR REPLACE TEMPORARY MACRO ast_to_call_edges(ast) AS (
     WITH function_scopes AS (
         SELECT 
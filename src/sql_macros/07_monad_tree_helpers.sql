@@ -1,5 +1,5 @@
 -- Tree navigation helper functions for AST monad objects
--- These work with the AST struct returned by read_ast_objects (when it existed)
+-- These work with the per-file rows returned by read_ast_objects (any value with a `nodes` list)
 
 -- Get immediate children of a node from AST monad
 -- Returns AST nodes that are children of the specified node_id
@@ -230,6 +230,7 @@ CREATE OR REPLACE TEMPORARY MACRO monad_extract_function_names(ast) AS (
 );
 
 -- Example: Get function complexity using monad style
+-- (read_ast_metrics provides semantic-type based metrics for all languages)
 CREATE OR REPLACE TEMPORARY MACRO monad_function_complexity(ast, func_node_id) AS (
     WITH descendants AS (
         SELECT unnest(monad_get_descendants(ast, func_node_id)) as node
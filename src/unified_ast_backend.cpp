@@ -4,6 +4,7 @@
 #include "semantic_types.hpp"
 #include "ast_file_utils.hpp"
 #include "ast_parsing_task.hpp"
+#include "ast_parse_cache.hpp"
 #include "duckdb/common/exception.hpp"
 #include "duckdb/common/string_util.hpp"
 #include "duckdb/common/file_system.hpp"
@@ -35,6 +36,10 @@ ASTResult UnifiedASTBackend::ParseToASTResult(const string& content,
                                             int32_t peek_size,
                                             const string& peek_mode) {
     
+    return ParseToASTResult(content, language, file_path, LegacyExtractionConfig(peek_size, peek_mode));
+}
+
+ExtractionConfig UnifiedASTBackend::LegacyExtractionConfig(int32_t peek_size, const string& peek_mode) {
     // Convert legacy parameters to ExtractionConfig
     ExtractionConfig config;
     config.peek_size = peek_size;
@@ -52,7 +57,7 @@ ASTResult UnifiedASTBackend::ParseToASTResult(const string& content,
         config.peek = PeekLevel::SMART; // Default
     }
     
-    return ParseToASTResult(content, language, file_path, config);
+    return config;
 }
 
 void UnifiedASTBackend::PopulateSemanticFields(ASTNode& node, const LanguageAdapter* adapter, TSNode ts_node, const string& content) {
@@ -211,12 +216,7 @@ vector<string> UnifiedASTBackend::GetFlatTableColumnNames() {
     };
 }
 
-LogicalType UnifiedASTBackend::GetASTStructSchema() {
-    // Create the complete AST struct schema with taxonomy fields
-    child_list_t<LogicalType> source_children;
-    source_children.push_back(make_pair("file_path", LogicalType::VARCHAR));
-    source_children.push_back(make_pair("language", LogicalType::VARCHAR));
-    
+LogicalType UnifiedASTBackend::GetASTNodeStructSchema() {
     child_list_t<LogicalType> node_children;
     node_children.push_back(make_pair("node_id", LogicalType::BIGINT));
     node_children.push_back(make_pair("type", LogicalType::VARCHAR));
@@ -234,9 +234,17 @@ LogicalType UnifiedASTBackend::GetASTStructSchema() {
     // Semantic type fields
     node_children.push_back(make_pair("semantic_type", LogicalType::UTINYINT));
     node_children.push_back(make_pair("flags", LogicalType::UTINYINT));
+    return LogicalType::STRUCT(node_children);
+}
+
+LogicalType UnifiedASTBackend::GetASTStructSchema() {
+    // Create the complete AST struct schema with taxonomy fields
+    child_list_t<LogicalType> source_children;
+    source_children.push_back(make_pair("file_path", LogicalType::VARCHAR));
+    source_children.push_back(make_pair("language", LogicalType::VARCHAR));
     
     child_list_t<LogicalType> ast_children;
-    ast_children.push_back(make_pair("nodes", LogicalType::LIST(LogicalType::STRUCT(node_children))));
+    ast_children.push_back(make_pair("nodes", LogicalType::LIST(GetASTNodeStructSchema())));
     ast_children.push_back(make_pair("source", LogicalType::STRUCT(source_children)));
     
     return LogicalType::STRUCT(ast_children);
@@ -255,6 +263,8 @@ vector<LogicalType> UnifiedASTBackend::GetHierarchicalTableSchema() {
     source_children.push_back(make_pair("start_column", LogicalType::UINTEGER));
     source_children.push_back(make_pair("end_line", LogicalType::UINTEGER));
     source_children.push_back(make_pair("end_column", LogicalType::UINTEGER));
+    source_children.push_back(make_pair("start_byte", LogicalType::UINTEGER));
+    source_children.push_back(make_pair("end_byte", LogicalType::UINTEGER));
     
     // Tree Structure STRUCT
     child_list_t<LogicalType> structure_children;
@@ -301,7 +311,7 @@ vector<string> UnifiedASTBackend::GetHierarchicalTableColumnNames() {
     return {
         "node_id",     // BIGINT
         "type",        // VARCHAR (moved to base level)
-        "source",      // STRUCT(file_path, language, start_line, start_column, end_line, end_column)
+        "source",      // STRUCT(file_path, language, start_line, start_column, end_line, end_column, start_byte, end_byte)
         "structure",   // STRUCT(parent_id, depth, sibling_index, children_count, descendant_count)
         "context",     // STRUCT(name, semantic_type, flags, native)
         "peek"         // VARCHAR
@@ -319,6 +329,8 @@ LogicalType UnifiedASTBackend::GetHierarchicalStructSchema() {
     source_location_children.push_back(make_pair("start_column", LogicalType::UINTEGER));
     source_location_children.push_back(make_pair("end_line", LogicalType::UINTEGER));
     source_location_children.push_back(make_pair("end_column", LogicalType::UINTEGER));
+    source_location_children.push_back(make_pair("start_byte", LogicalType::UINTEGER));
+    source_location_children.push_back(make_pair("end_byte", LogicalType::UINTEGER));
     
     // Tree Structure group
     child_list_t<LogicalType> tree_structure_children;
@@ -390,8 +402,9 @@ void UnifiedASTBackend::ProjectToTable(const ASTResult& result, DataChunk& outpu
     idx_t max_count = STANDARD_VECTOR_SIZE;
     
     // Start from current_row and process up to STANDARD_VECTOR_SIZE rows
-    for (idx_t i = current_row; i < result.nodes.size() && count < max_count; i++) {
-        const auto& node = result.nodes[i];
+    const auto& nodes = result.Nodes();
+    for (idx_t i = current_row; i < nodes.size() && count < max_count; i++) {
+        const auto& node = nodes[i];
         
         // Basic fields
         node_id_vec[output_index + count] = node.node_id;
@@ -438,6 +451,83 @@ void UnifiedASTBackend::ProjectToTable(const ASTResult& result, DataChunk& outpu
     output_index += count;
 }
 
+// Append `count` nodes, the i-th being result.Nodes()[get_index(i)], as list entry `row`
+template <class GET_INDEX>
+static void AppendNodeList(const ASTResult& result, idx_t count, GET_INDEX get_index, Vector& list_vector, idx_t row) {
+    // Append the nodes to the list's child vector in one reservation, no per-node Values
+    const auto offset = ListVector::GetListSize(list_vector);
+    ListVector::Reserve(list_vector, offset + count);
+    
+    // Child pointers must be taken after Reserve, which may reallocate
+    auto &entries = StructVector::GetEntries(ListVector::GetEntry(list_vector));
+    auto node_id_vec = FlatVector::GetData<int64_t>(*entries[0]);
+    auto type_vec = FlatVector::GetData<string_t>(*entries[1]);
+    auto name_vec = FlatVector::GetData<string_t>(*entries[2]);
+    auto &name_validity = FlatVector::Validity(*entries[2]);
+    auto start_line_vec = FlatVector::GetData<uint32_t>(*entries[3]);
+    auto end_line_vec = FlatVector::GetData<uint32_t>(*entries[4]);
+    auto start_column_vec = FlatVector::GetData<uint32_t>(*entries[5]);
+    auto end_column_vec = FlatVector::GetData<uint32_t>(*entries[6]);
+    auto parent_id_vec = FlatVector::GetData<int64_t>(*entries[7]);
+    auto &parent_validity = FlatVector::Validity(*entries[7]);
+    auto depth_vec = FlatVector::GetData<uint32_t>(*entries[8]);
+    auto sibling_index_vec = FlatVector::GetData<uint32_t>(*entries[9]);
+    auto children_count_vec = FlatVector::GetData<uint32_t>(*entries[10]);
+    auto descendant_count_vec = FlatVector::GetData<uint32_t>(*entries[11]);
+    auto peek_vec = FlatVector::GetData<string_t>(*entries[12]);
+    auto &peek_validity = FlatVector::Validity(*entries[12]);
+    auto semantic_type_vec = FlatVector::GetData<uint8_t>(*entries[13]);
+    auto flags_vec = FlatVector::GetData<uint8_t>(*entries[14]);
+    
+    const auto& nodes = result.Nodes();
+    for (idx_t i = 0; i < count; i++) {
+        const auto& node = nodes[get_index(i)];
+        const idx_t target = offset + i;
+        
+        node_id_vec[target] = node.node_id;
+        type_vec[target] = StringVector::AddString(*entries[1], node.type.raw);
+        if (node.name.raw.empty()) {
+            name_validity.SetInvalid(target);
+        } else {
+            name_vec[target] = StringVector::AddString(*entries[2], node.name.raw);
+        }
+        start_line_vec[target] = node.file_position.start_line;
+        end_line_vec[target] = node.file_position.end_line;
+        start_column_vec[target] = node.file_position.start_column;
+        end_column_vec[target] = node.file_position.end_column;
+        if (node.tree_position.parent_index < 0) {
+            parent_validity.SetInvalid(target);
+        } else {
+            parent_id_vec[target] = node.tree_position.parent_index;
+        }
+        depth_vec[target] = node.tree_position.node_depth;
+        sibling_index_vec[target] = node.tree_position.sibling_index;
+        children_count_vec[target] = node.subtree.children_count;
+        descendant_count_vec[target] = node.subtree.descendant_count;
+        if (node.peek.empty()) {
+            peek_validity.SetInvalid(target);
+        } else {
+            peek_vec[target] = StringVector::AddString(*entries[12], node.peek);
+        }
+        semantic_type_vec[target] = node.semantic_type;
+        flags_vec[target] = node.universal_flags;
+    }
+    
+    auto list_entries = FlatVector::GetData<list_entry_t>(list_vector);
+    list_entries[row].offset = offset;
+    list_entries[row].length = count;
+    ListVector::SetListSize(list_vector, offset + count);
+}
+
+void UnifiedASTBackend::ProjectToNodeList(const ASTResult& result, Vector& list_vector, idx_t row) {
+    AppendNodeList(result, result.Nodes().size(), [](idx_t i) { return i; }, list_vector, row);
+}
+
+void UnifiedASTBackend::ProjectToNodeList(const ASTResult& result, const vector<idx_t>& node_indices,
+                                          Vector& list_vector, idx_t row) {
+    AppendNodeList(result, node_indices.size(), [&](idx_t i) { return node_indices[i]; }, list_vector, row);
+}
+
 Value UnifiedASTBackend::CreateASTStruct(const ASTResult& result) {
     // Create source struct
     child_list_t<Value> source_children;
@@ -447,9 +537,9 @@ Value UnifiedASTBackend::CreateASTStruct(const ASTResult& result) {
     
     // Create nodes array
     vector<Value> node_values;
-    node_values.reserve(result.nodes.size());
+    node_values.reserve(result.Nodes().size());
     
-    for (const auto& node : result.nodes) {
+    for (const auto& node : result.Nodes()) {
         child_list_t<Value> node_children;
         node_children.push_back(make_pair("node_id", Value::BIGINT(node.node_id)));
         node_children.push_back(make_pair("type", Value(node.type.raw)));
@@ -507,9 +597,9 @@ Value UnifiedASTBackend::CreateASTStructValue(const ASTResult& result) {
 //==============================================================================
 
 void UnifiedASTBackend::ProjectToHierarchicalTable(const ASTResult& result, DataChunk& output, idx_t& current_row, idx_t& output_index) {
-    // Verify output chunk has correct number of columns (6 for hierarchical STRUCT schema)
-    if (output.ColumnCount() != 6) {
-        throw InternalException("Output chunk has " + to_string(output.ColumnCount()) + " columns, expected 6 for hierarchical STRUCT schema");
+    // Verify output chunk has the 6 hierarchical STRUCT schema columns first (callers may append more)
+    if (output.ColumnCount() < 6) {
+        throw InternalException("Output chunk has " + to_string(output.ColumnCount()) + " columns, expected at least 6 for hierarchical STRUCT schema");
     }
     
     // Get output vectors for hierarchical schema: node_id, type, source, structure, context, peek
@@ -527,8 +617,9 @@ void UnifiedASTBackend::ProjectToHierarchicalTable(const ASTResult& result, Data
     idx_t max_count = STANDARD_VECTOR_SIZE;
     
     // Process rows using NEW STRUCTURED FIELDS and create STRUCT values
-    for (idx_t i = current_row; i < result.nodes.size() && count < max_count; i++) {
-        const auto& node = result.nodes[i];
+    const auto& nodes = result.Nodes();
+    for (idx_t i = current_row; i < nodes.size() && count < max_count; i++) {
+        const auto& node = nodes[i];
         idx_t row_idx = output_index + count;
         
         // Core identity
@@ -543,6 +634,8 @@ void UnifiedASTBackend::ProjectToHierarchicalTable(const ASTResult& result, Data
         source_values.push_back(make_pair("start_column", Value::UINTEGER(node.file_position.start_column)));
         source_values.push_back(make_pair("end_line", Value::UINTEGER(node.file_position.end_line)));
         source_values.push_back(make_pair("end_column", Value::UINTEGER(node.file_position.end_column)));
+        source_values.push_back(make_pair("start_byte", Value::UINTEGER(node.source.start_byte)));
+        source_values.push_back(make_pair("end_byte", Value::UINTEGER(node.source.end_byte)));
         Value source_struct = Value::STRUCT(source_values);
         FlatVector::GetData<Value>(source_vector)[row_idx] = source_struct;
         
@@ -606,13 +699,16 @@ void UnifiedASTBackend::ProjectToHierarchicalTableStreaming(const vector<ASTNode
     auto &structure_entries = StructVector::GetEntries(output.data[3]);
     auto &context_entries = StructVector::GetEntries(output.data[4]);
     
-    // Source STRUCT child vectors (file_path, language, start_line, start_column, end_line, end_column)
+    // Source STRUCT child vectors (file_path, language, start_line, start_column, end_line, end_column,
+    // start_byte, end_byte)
     auto source_file_path_vec = FlatVector::GetData<string_t>(*source_entries[0]);
     auto source_language_vec = FlatVector::GetData<string_t>(*source_entries[1]);
     auto source_start_line_vec = FlatVector::GetData<uint32_t>(*source_entries[2]);
     auto source_start_column_vec = FlatVector::GetData<uint32_t>(*source_entries[3]);
     auto source_end_line_vec = FlatVector::GetData<uint32_t>(*source_entries[4]);
     auto source_end_column_vec = FlatVector::GetData<uint32_t>(*source_entries[5]);
+    auto source_start_byte_vec = FlatVector::GetData<uint32_t>(*source_entries[6]);
+    auto source_end_byte_vec = FlatVector::GetData<uint32_t>(*source_entries[7]);
     
     // Structure STRUCT child vectors (parent_id, depth, sibling_index, children_count, descendant_count)
     auto structure_parent_id_vec = FlatVector::GetData<int64_t>(*structure_entries[0]);
@@ -647,6 +743,8 @@ void UnifiedASTBackend::ProjectToHierarchicalTableStreaming(const vector<ASTNode
         source_start_column_vec[row_idx] = node.file_position.start_column;
         source_end_line_vec[row_idx] = node.file_position.end_line;
         source_end_column_vec[row_idx] = node.file_position.end_column;
+        source_start_byte_vec[row_idx] = node.source.start_byte;
+        source_end_byte_vec[row_idx] = node.source.end_byte;
         
         // Populate structure STRUCT fields
         if (node.tree_position.parent_index < 0) {
@@ -690,9 +788,9 @@ Value UnifiedASTBackend::CreateHierarchicalASTStruct(const ASTResult& result) {
     
     // Create nodes array with hierarchical structure
     vector<Value> node_values;
-    node_values.reserve(result.nodes.size());
+    node_values.reserve(result.Nodes().size());
     
-    for (const auto& node : result.nodes) {
+    for (const auto& node : result.Nodes()) {
         // Source Location struct - use legacy fields for now
         child_list_t<Value> source_children;
         source_children.push_back(make_pair("file_path", Value(result.source.file_path)));
@@ -701,6 +799,8 @@ Value UnifiedASTBackend::CreateHierarchicalASTStruct(const ASTResult& result) {
         source_children.push_back(make_pair("start_column", Value::UINTEGER(node.file_position.start_column)));
         source_children.push_back(make_pair("end_line", Value::UINTEGER(node.file_position.end_line)));
         source_children.push_back(make_pair("end_column", Value::UINTEGER(node.file_position.end_column)));
+        source_children.push_back(make_pair("start_byte", Value::UINTEGER(node.source.start_byte)));
+        source_children.push_back(make_pair("end_byte", Value::UINTEGER(node.source.end_byte)));
         Value source_value = Value::STRUCT(source_children);
         
         // Tree Structure struct - use legacy fields for now
@@ -741,6 +841,8 @@ Value UnifiedASTBackend::CreateHierarchicalASTStruct(const ASTResult& result) {
     source_location_children.push_back(make_pair("start_column", LogicalType::UINTEGER));
     source_location_children.push_back(make_pair("end_line", LogicalType::UINTEGER));
     source_location_children.push_back(make_pair("end_column", LogicalType::UINTEGER));
+    source_location_children.push_back(make_pair("start_byte", LogicalType::UINTEGER));
+    source_location_children.push_back(make_pair("end_byte", LogicalType::UINTEGER));
     
     child_list_t<LogicalType> tree_structure_children;
     tree_structure_children.push_back(make_pair("parent_id", LogicalType::BIGINT));
@@ -843,7 +945,11 @@ unique_ptr<ASTResult> UnifiedASTBackend::ParseSingleFileToASTResult(ClientContex
                                                                    const string& language,
                                                                    bool ignore_errors,
                                                                    int32_t peek_size,
-                                                                   const string& peek_mode) {
+                                                                   const string& peek_mode,
+                                                                   const vector<pair<uint32_t, uint32_t>>& line_ranges,
+                                                                   const ASTContentFilter* content_filter,
+                                                                   ASTContentDedup* dedup,
+                                                                   const ASTFileScreen* screen) {
     try {
         // Auto-detect language if needed
         string file_language = language;
@@ -866,15 +972,40 @@ unique_ptr<ASTResult> UnifiedASTBackend::ParseSingleFileToASTResult(ClientContex
             return nullptr; // Skip missing files
         }
         
-        auto handle = fs.OpenFile(file_path, FileFlags::FILE_FLAGS_READ);
-        auto file_size = fs.GetFileSize(*handle);
+        // Binary, minified, generated and oversized files are skipped on their first few KB
+        if (screen) {
+            auto skip_reason = screen->Check(context, file_path);
+            if (!skip_reason.empty()) {
+                auto skipped = make_uniq<ASTResult>();
+                skipped->source.file_path = file_path;
+                skipped->source.language = file_language;
+                skipped->status = std::move(skip_reason);
+                return skipped;
+            }
+        }
         
-        string content;
-        content.resize(file_size);
-        fs.Read(*handle, (void*)content.data(), file_size);
+        // Files without a content_filter match are skipped before parsing; the raw
+        // bytes are also what dedup hashes
+        string raw_content;
+        if (content_filter || dedup) {
+            raw_content = ASTFileUtils::ReadFile(context, file_path);
+        }
+        if (content_filter && !content_filter->Matches(raw_content)) {
+            return nullptr;
+        }
         
-        // Parse this file
-        auto result = make_uniq<ASTResult>(ParseToASTResult(content, file_language, file_path, peek_size, peek_mode));
+        // Parse this file, reusing the shared parse cache when the file is unchanged
+        auto config = LegacyExtractionConfig(peek_size, peek_mode);
+        config.line_ranges = line_ranges;
+        config.max_nodes = screen ? screen->max_nodes : 0;
+        auto parse_file = [&]() {
+            return ASTParseCache::ParseFile(context, file_path, file_language, config,
+                [&](const string &content) {
+                    return ParseToASTResult(content, file_language, file_path, config);
+                });
+        };
+        auto result = make_uniq<ASTResult>(dedup ? dedup->ParseFile(file_path, file_language, raw_content, parse_file)
+                                                 : ASTResult::Share(parse_file()));
         return result;
         
     } catch (const Exception &e) {
@@ -908,60 +1039,16 @@ ASTResultCollection UnifiedASTBackend::ParseFilesToASTCollectionParallel(ClientC
         return ParseFilesToASTCollection(context, file_path_value, language, ignore_errors, peek_size, peek_mode);
     }
     
-    // Determine thread count and task distribution
-    const auto num_threads = NumericCast<idx_t>(TaskScheduler::GetScheduler(context).NumberOfThreads());
-    const auto files_per_task = MaxValue<idx_t>((file_paths.size() + num_threads - 1) / num_threads, 1);
-    const auto num_tasks = (file_paths.size() + files_per_task - 1) / files_per_task;
-    
-    // Auto-detect language for each file if needed
+    // Resolve languages and pre-create adapters, then parse on all threads
     vector<string> resolved_languages;
-    resolved_languages.reserve(file_paths.size());
-    
-    for (const auto& file_path : file_paths) {
-        string file_language = language;
-        if (language == "auto" || language.empty()) {
-            file_language = ASTFileUtils::DetectLanguageFromPath(file_path);
-            if (file_language == "auto") {
-                if (!ignore_errors) {
-                    throw BinderException("Could not detect language for file: " + file_path);
-                }
-                file_language = "unknown"; // Will be skipped during processing
-            }
-        }
-        resolved_languages.push_back(file_language);
-    }
-    
-    // Create shared parsing state with pre-created adapters
-    // For the unified backend, we'll use the traditional singleton approach for now
-    // since this code path is less performance-critical than the streaming function
-    unordered_map<string, unique_ptr<LanguageAdapter>> empty_adapters_map;
-    ASTParsingState parsing_state(context, file_paths, resolved_languages, ignore_errors, peek_size, peek_mode, empty_adapters_map);
-    
-    // Create and schedule tasks
-    TaskExecutor executor(context);
-    vector<unique_ptr<ASTParsingTask>> tasks;
-    tasks.reserve(num_tasks);
-    
-    for (idx_t task_idx = 0; task_idx < num_tasks; task_idx++) {
-        const auto file_idx_start = task_idx * files_per_task;
-        const auto file_idx_end = MinValue<idx_t>(file_idx_start + files_per_task, file_paths.size());
-        
-        auto task = make_uniq<ASTParsingTask>(executor, parsing_state, file_idx_start, file_idx_end, task_idx);
-        executor.ScheduleTask(std::move(task));
-    }
-    
-    // Execute all tasks and wait for completion
-    executor.WorkOnTasks();
-    
-    // Report errors if any occurred (when ignore_errors=true)
-    if (parsing_state.errors_encountered.load() > 0 && ignore_errors) {
-        // Could log warnings about skipped files here
-        // For now, silently continue as per ignore_errors=true behavior
-    }
+    unordered_map<string, unique_ptr<LanguageAdapter>> adapters;
+    ResolveFileLanguages(file_paths, language, ignore_errors, resolved_languages, adapters);
+    auto results = ParseFilesParallel(context, file_paths, resolved_languages, ignore_errors, peek_size, peek_mode,
+                                      adapters);
     
     // Collect results
     ASTResultCollection collection;
-    collection.results = std::move(parsing_state.results);
+    collection.results = std::move(results);
     return collection;
 }
 
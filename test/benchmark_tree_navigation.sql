@@ -0,0 +1,133 @@
+-- Tree navigation benchmark: 06_tree_helpers.sql macro queries vs native ast_get_* functions
+-- Run from the repository root: duckdb -unsigned < test/benchmark_tree_navigation.sql
+--
+-- The SQL variant of each test is the body of the matching macro in
+-- src/sql_macros/06_tree_helpers.sql (self-joins over the node table, recursive
+-- CTEs for ancestors), with the node id inlined. The macros themselves cannot be
+-- called here: their node_id parameter has the name of a column, so inside the
+-- macro body `WHERE node_id = node_id` compares the column with itself.
+-- The native variant answers the same question from the per-file node list of
+-- read_ast_objects. Both variants of a test print the same result.
+
+LOAD sitting_duck;
+
+CREATE TABLE flat_ast AS
+SELECT * FROM read_ast_flat(['src/**/*.cpp', 'src/include/**/*.hpp'], ignore_errors := true);
+
+CREATE TABLE file_ast AS
+SELECT * FROM read_ast_objects(['src/**/*.cpp', 'src/include/**/*.hpp'], ignore_errors := true);
+
+-- The deepest identifier of the largest file, and the node table of that file
+-- (the macros take the table of one file)
+SET VARIABLE target_file = (SELECT file_path FROM file_ast ORDER BY len(nodes) DESC LIMIT 1);
+CREATE TABLE target_ast AS SELECT * FROM flat_ast WHERE file_path = getvariable('target_file');
+SET VARIABLE target_node = (SELECT node_id FROM target_ast WHERE type = 'identifier' ORDER BY depth DESC LIMIT 1);
+SET VARIABLE target_parent = (SELECT parent_id FROM target_ast WHERE node_id = getvariable('target_node'));
+
+SELECT getvariable('target_file') AS file, (SELECT count(*) FROM target_ast) AS nodes,
+       getvariable('target_node') AS target_node;
+
+.timer on
+
+-- Test 1: get_children / ast_get_children (of the target's parent)
+SELECT 'Children (SQL)' AS test, count(*) AS result
+FROM target_ast WHERE parent_id = getvariable('target_parent');
+
+SELECT 'Children (native)' AS test, len(ast_get_children(nodes, getvariable('target_parent'))) AS result
+FROM file_ast WHERE file_path = getvariable('target_file');
+
+-- Test 2: get_descendants / ast_get_descendants (of the root)
+WITH target_node AS (SELECT node_id AS target_id, descendant_count FROM target_ast WHERE node_id = 0 LIMIT 1)
+SELECT 'Descendants (SQL)' AS test, count(*) AS result
+FROM target_ast ast, target_node
+WHERE ast.node_id >= target_node.target_id AND ast.node_id <= target_node.target_id + target_node.descendant_count;
+
+SELECT 'Descendants (native)' AS test, len(ast_get_descendants(nodes, 0)) AS result
+FROM file_ast WHERE file_path = getvariable('target_file');
+
+-- Test 3: get_subtree / ast_get_subtree (of the root)
+WITH target_node AS (SELECT node_id AS target_id, descendant_count FROM target_ast WHERE node_id = 0 LIMIT 1)
+SELECT 'Subtree (SQL)' AS test, count(*) AS result
+FROM target_ast ast, target_node
+WHERE ast.node_id > target_node.target_id AND ast.node_id <= target_node.target_id + target_node.descendant_count;
+
+SELECT 'Subtree (native)' AS test, len(ast_get_subtree(nodes, 0)) AS result
+FROM file_ast WHERE file_path = getvariable('target_file');
+
+-- Test 4: get_siblings / ast_get_siblings
+WITH target_node AS (SELECT parent_id AS target_parent FROM target_ast WHERE node_id = getvariable('target_node') LIMIT 1)
+SELECT 'Siblings (SQL)' AS test, count(*) AS result
+FROM target_ast ast, target_node WHERE ast.parent_id = target_node.target_parent;
+
+SELECT 'Siblings (native)' AS test, len(ast_get_siblings(nodes, getvariable('target_node'))) AS result
+FROM file_ast WHERE file_path = getvariable('target_file');
+
+-- Test 5: get_parent / ast_get_parent
+WITH target_node AS (SELECT parent_id AS target_parent FROM target_ast WHERE node_id = getvariable('target_node') LIMIT 1)
+SELECT 'Parent (SQL)' AS test, count(*) AS result
+FROM target_ast ast, target_node WHERE ast.node_id = target_node.target_parent;
+
+SELECT 'Parent (native)' AS test, len(ast_get_parent(nodes, getvariable('target_node'))) AS result
+FROM file_ast WHERE file_path = getvariable('target_file');
+
+-- Test 6: get_ancestors / ast_get_ancestors (recursive CTE)
+WITH RECURSIVE ancestors AS (
+    SELECT parent_id AS ancestor_id FROM target_ast
+    WHERE node_id = getvariable('target_node') AND parent_id IS NOT NULL
+    UNION
+    SELECT ast.parent_id FROM target_ast ast JOIN ancestors a ON ast.node_id = a.ancestor_id
+    WHERE ast.parent_id IS NOT NULL
+)
+SELECT 'Ancestors (SQL)' AS test, count(*) AS result
+FROM target_ast ast JOIN ancestors a ON ast.node_id = a.ancestor_id;
+
+SELECT 'Ancestors (native)' AS test, len(ast_get_ancestors(nodes, getvariable('target_node'))) AS result
+FROM file_ast WHERE file_path = getvariable('target_file');
+
+-- Test 7: get_path_to_node / ast_get_path_to_node
+WITH RECURSIVE path AS (
+    SELECT node_id AS path_node_id, parent_id FROM target_ast WHERE node_id = getvariable('target_node')
+    UNION
+    SELECT ast.node_id, ast.parent_id FROM target_ast ast JOIN path p ON ast.node_id = p.parent_id
+)
+SELECT 'Path to node (SQL)' AS test, count(*) AS result
+FROM target_ast ast JOIN path p ON ast.node_id = p.path_node_id;
+
+SELECT 'Path to node (native)' AS test, len(ast_get_path_to_node(nodes, getvariable('target_node'))) AS result
+FROM file_ast WHERE file_path = getvariable('target_file');
+
+-- Test 8: find_nearest_ancestor_of_type / ast_find_nearest_ancestor
+WITH RECURSIVE ancestors AS (
+    SELECT parent_id AS ancestor_id FROM target_ast
+    WHERE node_id = getvariable('target_node') AND parent_id IS NOT NULL
+    UNION
+    SELECT ast.parent_id FROM target_ast ast JOIN ancestors a ON ast.node_id = a.ancestor_id
+    WHERE ast.parent_id IS NOT NULL
+)
+SELECT 'Nearest function (SQL)' AS test, count(*) AS result FROM (
+    SELECT ast.node_id FROM target_ast ast JOIN ancestors a ON ast.node_id = a.ancestor_id
+    WHERE ast.type = 'function_definition' ORDER BY ast.depth DESC LIMIT 1);
+
+SELECT 'Nearest function (native)' AS test,
+       len(ast_find_nearest_ancestor(nodes, getvariable('target_node'), 'function_definition')) AS result
+FROM file_ast WHERE file_path = getvariable('target_file');
+
+-- Test 9: Batched over every file - enclosing function of every call
+WITH RECURSIVE chain AS (
+    SELECT file_path, node_id AS start_id, parent_id AS ancestor_id FROM flat_ast
+    WHERE type = 'call_expression'
+    UNION ALL
+    SELECT c.file_path, c.start_id, a.parent_id FROM chain c
+    JOIN flat_ast a ON a.file_path = c.file_path AND a.node_id = c.ancestor_id
+    WHERE a.type <> 'function_definition' AND a.parent_id IS NOT NULL
+)
+SELECT 'Enclosing functions (SQL)' AS test, count(DISTINCT (c.file_path, a.node_id)) AS result
+FROM chain c JOIN flat_ast a ON a.file_path = c.file_path AND a.node_id = c.ancestor_id
+WHERE a.type = 'function_definition';
+
+SELECT 'Enclosing functions (native)' AS test,
+       sum(len(ast_find_nearest_ancestor(nodes, [n.node_id FOR n IN nodes IF n.type = 'call_expression'],
+                                         'function_definition'))) AS result
+FROM file_ast;
+
+.timer off
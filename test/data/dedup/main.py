@@ -0,0 +1,3 @@
+from util import clamp
+
+print(clamp(5, 0, 3))
@@ -0,0 +1,8 @@
+def clamp(value, low, high):
+    return max(low, min(value, high))
+
+
+class Range:
+    def __init__(self, low, high):
+        self.low = low
+        self.high = high
@@ -0,0 +1 @@
+KEPT = True
@@ -0,0 +1,2 @@
+def local():
+    return 5
@@ -0,0 +1,6 @@
+class Greeter:
+    def greet(self, name):
+        return self.format(name)
+
+    def format(self, name):
+        return "Hello " + name.strip()
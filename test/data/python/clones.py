@@ -0,0 +1,26 @@
+def total_price(items):
+    total = 0
+    for item in items:
+        if item.price > 0:
+            total += item.price * item.quantity
+    return total
+
+
+def total_price_copy(items):
+    total = 0
+    for item in items:
+        if item.price > 0:
+            total += item.price * item.quantity
+    return total
+
+
+def sum_weights(parcels):
+    weight = 0
+    for parcel in parcels:
+        if parcel.weight > 1:
+            weight += parcel.weight * parcel.count
+    return weight
+
+
+def unrelated(value):
+    return [value] * 3
@@ -0,0 +1,25 @@
+def classify(n):
+    if n < 0 and n != -1:
+        return "negative"
+    elif n == 0:
+        return "zero"
+    else:
+        return "positive"
+
+
+def scan(rows):
+    found = []
+    for row in rows:
+        while row:
+            if row.ok:
+                found.append(row)
+            row = row.next
+
+    def helper(x):
+        return x or None
+
+    return found
+
+
+def constant():
+    return 42
@@ -0,0 +1,6 @@
+from simple import hello
+
+
+def greet_twice():
+    hello()
+    hello()
@@ -0,0 +1 @@
+var v0=0;var v1=1;var v2=2;var v3=3;var v4=4;var v5=5;var v6=6;var v7=7;var v8=8;var v9=9;var v10=10;var v11=11;var v12=12;var v13=13;var v14=14;var v15=15;var v16=16;var v17=17;var v18=18;var v19=19;var v20=20;var v21=21;var v22=22;var v23=23;var v24=24;var v25=25;var v26=26;var v27=27;var v28=28;var v29=29;var v30=30;var v31=31;var v32=32;var v33=33;var v34=34;var v35=35;var v36=36;var v37=37;var v38=38;var v39=39;var v40=40;var v41=41;var v42=42;var v43=43;var v44=44;var v45=45;var v46=46;var v47=47;var v48=48;var v49=49;var v50=50;var v51=51;var v52=52;var v53=53;var v54=54;var v55=55;var v56=56;var v57=57;var v58=58;var v59=59;var v60=60;var v61=61;var v62=62;var v63=63;var v64=64;var v65=65;var v66=66;var v67=67;var v68=68;var v69=69;var v70=70;var v71=71;var v72=72;var v73=73;var v74=74;var v75=75;var v76=76;var v77=77;var v78=78;var v79=79;
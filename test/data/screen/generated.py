@@ -0,0 +1,3 @@
+# @generated by protoc-gen-python. DO NOT EDIT.
+SCHEMA_VERSION = 3
+FIELDS = ["id", "name"]